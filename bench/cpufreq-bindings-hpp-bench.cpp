@@ -0,0 +1,243 @@
+/**
+ * Compare the C++ interface (cpufreq-bindings.hpp) against the C API it wraps, using the same file descriptors and
+ * context on a synthetic sysfs tree.
+ * Each operation is timed alternately through both APIs, and the fastest of several repetitions is reported, so the
+ * difference is the C++ layer's overhead (expected to be within noise).
+ *
+ * @author Connor Imes
+ * @date 2026-10-15
+ */
+#include <getopt.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include "cpufreq-bindings.h"
+#include "cpufreq-bindings.hpp"
+
+#define MAX_FREQS 8
+#define MAX_GOV_LEN 32
+
+static const char* const FILES[][2] = {
+  {"scaling_available_frequencies", "2400000 2000000 1600000 1200000 \n"},
+  {"scaling_cur_freq", "1200000\n"},
+  {"scaling_governor", "userspace\n"},
+  {"scaling_max_freq", "2400000\n"}
+};
+#define NFILES (sizeof(FILES) / sizeof(FILES[0]))
+
+// prevent the compiler from optimizing away results
+static volatile uint64_t sink;
+
+static uint64_t now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t) ts.tv_sec * 1000000000ULL + (uint64_t) ts.tv_nsec;
+}
+
+static int make_dir(char* path) {
+  char* p;
+  for (p = strchr(path + 1, '/'); p != NULL; p = strchr(p + 1, '/')) {
+    *p = '\0';
+    if (mkdir(path, 0755) && errno != EEXIST) {
+      perror(path);
+      return -1;
+    }
+    *p = '/';
+  }
+  if (mkdir(path, 0755) && errno != EEXIST) {
+    perror(path);
+    return -1;
+  }
+  return 0;
+}
+
+static int generate_tree(const char* root) {
+  char path[4096];
+  FILE* f;
+  size_t i;
+  snprintf(path, sizeof(path), "%s/devices/system/cpu/cpu0/cpufreq", root);
+  if (make_dir(path)) {
+    return -1;
+  }
+  for (i = 0; i < NFILES; i++) {
+    snprintf(path, sizeof(path), "%s/devices/system/cpu/cpu0/cpufreq/%s", root, FILES[i][0]);
+    if ((f = fopen(path, "w")) == NULL) {
+      perror(path);
+      return -1;
+    }
+    fputs(FILES[i][1], f);
+    fclose(f);
+  }
+  return 0;
+}
+
+static void remove_tree(const char* root) {
+  char path[4096];
+  size_t i;
+  for (i = 0; i < NFILES; i++) {
+    snprintf(path, sizeof(path), "%s/devices/system/cpu/cpu0/cpufreq/%s", root, FILES[i][0]);
+    unlink(path);
+  }
+  for (const char* dir : {"/devices/system/cpu/cpu0/cpufreq", "/devices/system/cpu/cpu0", "/devices/system/cpu",
+                          "/devices/system", "/devices", ""}) {
+    snprintf(path, sizeof(path), "%s%s", root, dir);
+    rmdir(path);
+  }
+}
+
+// returns the mean time per call
+template <class Fn>
+static double time_op(Fn fn, uint32_t iters) {
+  uint64_t start = now_ns();
+  uint32_t i;
+  for (i = 0; i < iters; i++) {
+    sink += fn(i);
+  }
+  return (double) (now_ns() - start) / iters;
+}
+
+template <class CFn, class CppFn>
+static void bench(const char* op, CFn c_fn, CppFn cpp_fn, uint32_t iters, uint32_t reps) {
+  double c_ns = 0;
+  double cpp_ns = 0;
+  double t;
+  uint32_t r;
+  for (r = 0; r < reps; r++) {
+    t = time_op(c_fn, iters);
+    if (r == 0 || t < c_ns) {
+      c_ns = t;
+    }
+    t = time_op(cpp_fn, iters);
+    if (r == 0 || t < cpp_ns) {
+      cpp_ns = t;
+    }
+  }
+  printf("%s,%.1f,%.1f,%+.2f\n", op, c_ns, cpp_ns, c_ns > 0 ? (cpp_ns - c_ns) * 100 / c_ns : 0);
+  fflush(stdout);
+}
+
+static void run(uint32_t iters, uint32_t reps) {
+  using namespace cpufreq;
+  constexpr uint32_t core = 0;
+  static const char gov[] = "userspace";
+  cpufreq::result<context> ctx_res = context::create(1);
+  cpufreq::result<file<CPUFREQ_BINDINGS_FILE_SCALING_CUR_FREQ>> cur_res =
+    file<CPUFREQ_BINDINGS_FILE_SCALING_CUR_FREQ>::open(core);
+  if (!ctx_res || !cur_res) {
+    fprintf(stderr, "Failed to open files: %s\n", strerror(ctx_res ? cur_res.error() : ctx_res.error()));
+    return;
+  }
+  context& ctx = *ctx_res;
+  cpufreq_bindings_ctx* c_ctx = ctx.get();
+  const auto& cur = *cur_res;
+  const int cur_fd = cur.handle();
+
+  printf("op,c_ns,cpp_ns,overhead_pct\n");
+  bench("get_scaling_cur_freq (fd)",
+        [=](uint32_t) { return (uint64_t) cpufreq_bindings_get_scaling_cur_freq(cur_fd, core); },
+        [&](uint32_t) { return (uint64_t) cur.get().value_or(0); }, iters, reps);
+  bench("get_scaling_cur_freq (ctx)",
+        [=](uint32_t) { return (uint64_t) cpufreq_bindings_ctx_get_scaling_cur_freq(c_ctx, core); },
+        [&](uint32_t) { return (uint64_t) ctx.at<CPUFREQ_BINDINGS_FILE_SCALING_CUR_FREQ>(core).get().value_or(0); },
+        iters, reps);
+  bench("get_scaling_available_frequencies (ctx)",
+        [=](uint32_t) {
+          uint32_t freqs[MAX_FREQS];
+          return (uint64_t) cpufreq_bindings_ctx_get_scaling_available_frequencies(c_ctx, core, freqs, MAX_FREQS);
+        },
+        [&](uint32_t) {
+          uint32_t freqs[MAX_FREQS];
+          auto res = ctx.at<CPUFREQ_BINDINGS_FILE_SCALING_AVAILABLE_FREQUENCIES>(core).get(freqs);
+          return (uint64_t) (res ? res->size() : 0);
+        }, iters, reps);
+  bench("get_scaling_governor (ctx)",
+        [=](uint32_t) {
+          char buf[MAX_GOV_LEN];
+          return (uint64_t) cpufreq_bindings_ctx_get_scaling_governor(c_ctx, core, buf, sizeof(buf));
+        },
+        [&](uint32_t) {
+          char buf[MAX_GOV_LEN];
+          auto res = ctx.at<CPUFREQ_BINDINGS_FILE_SCALING_GOVERNOR>(core).get(buf);
+          return (uint64_t) (res ? res->size() : 0);
+        }, iters, reps);
+  bench("set_scaling_governor (ctx)",
+        [=](uint32_t) {
+          return (uint64_t) cpufreq_bindings_ctx_set_scaling_governor(c_ctx, core, gov, sizeof(gov) - 1);
+        },
+        [&](uint32_t) {
+          std::string_view val(gov, sizeof(gov) - 1);
+          return (uint64_t) ctx.at<CPUFREQ_BINDINGS_FILE_SCALING_GOVERNOR>(core).set(val).has_value();
+        }, iters, reps);
+  // alternate between two values with the same number of digits, since tmpfs doesn't truncate on write
+  bench("set_scaling_max_freq (ctx)",
+        [=](uint32_t i) {
+          return (uint64_t) cpufreq_bindings_ctx_set_scaling_max_freq(c_ctx, core, (i & 1) ? 2400000 : 2000000);
+        },
+        [&](uint32_t i) {
+          return (uint64_t) ctx.at<CPUFREQ_BINDINGS_FILE_SCALING_MAX_FREQ>(core).set((i & 1) ? 2400000 : 2000000)
+            .has_value();
+        }, iters, reps);
+}
+
+static const char short_options[] = "hd:i:r:";
+static const struct option long_options[] = {
+  {"help",                no_argument,        NULL, 'h'},
+  {"dir",                 required_argument,  NULL, 'd'},
+  {"iterations",          required_argument,  NULL, 'i'},
+  {"repetitions",         required_argument,  NULL, 'r'},
+  {0, 0, 0, 0}
+};
+
+static void print_usage(void) {
+  printf("Usage: cpufreq-bindings-hpp-bench [OPTION]...\n");
+  printf("Options:\n");
+  printf("  -h, --help                   Print this message and exit\n");
+  printf("  -d, --dir=DIR                Parent directory for the synthetic tree (default is /dev/shm)\n");
+  printf("  -i, --iterations=N           Calls per repetition (default is 100000)\n");
+  printf("  -r, --repetitions=N          Repetitions, of which the fastest is reported (default is 5)\n");
+}
+
+int main(int argc, char** argv) {
+  const char* dir = "/dev/shm";
+  char root[1024];
+  uint32_t iters = 100000;
+  uint32_t reps = 5;
+  int c;
+  while ((c = getopt_long(argc, argv, short_options, long_options, NULL)) != -1) {
+    switch (c) {
+      case 'h':
+        print_usage();
+        return 0;
+      case 'd':
+        dir = optarg;
+        break;
+      case 'i':
+        iters = (uint32_t) atoi(optarg);
+        break;
+      case 'r':
+        reps = (uint32_t) atoi(optarg);
+        break;
+      case '?':
+      default:
+        print_usage();
+        return -EINVAL;
+    }
+  }
+  if (iters == 0 || reps == 0) {
+    print_usage();
+    return -EINVAL;
+  }
+  snprintf(root, sizeof(root), "%s/cpufreq-bindings-hpp-bench.%d", dir, (int) getpid());
+  if (generate_tree(root) || cpufreq_bindings_set_sysfs_root(root)) {
+    remove_tree(root);
+    return 1;
+  }
+  run(iters, reps);
+  remove_tree(root);
+  return 0;
+}
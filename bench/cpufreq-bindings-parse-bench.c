@@ -0,0 +1,274 @@
+/**
+ * Microbenchmark for parsing array files like "related_cpus" and "scaling_available_governors".
+ * Compares the allocation-free parsers against the previous calloc + strtok_r + strtoul implementation.
+ * Both read each file's contents with pread from a real file (a temporary file, or "--dir"), like the library does.
+ *
+ * @author Connor Imes
+ * @date 2026-10-15
+ */
+// for clock_gettime, mkstemp, pread, strtok_r
+#define _POSIX_C_SOURCE 200809L
+#include <errno.h>
+#include <getopt.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "cpufreq-bindings-parse.h"
+
+#define U32_MAX_LEN 12
+#define GOVERNOR_NAME_MAX_LEN 128
+#define MAX_GOVS 16
+#define MAX_GOV_LEN 32
+
+static const char GOVERNORS[] = "conservative ondemand userspace powersave performance schedutil\n";
+
+// prevent the compiler from optimizing away results
+static volatile uint32_t sink;
+
+// the directory for temporary files
+static const char* tmp_dir = "/tmp";
+
+// reads made by the new implementation
+static uint64_t new_reads;
+
+static uint64_t now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t) ts.tv_sec * 1000000000ULL + (uint64_t) ts.tv_nsec;
+}
+
+// previous implementation: one pread into a buffer sized for the worst case
+static uint32_t baseline_u32arr(int fd, uint32_t* arr, uint32_t len) {
+  char* tok;
+  char* ptr = NULL;
+  uint32_t i = 0;
+  size_t buflen = len * (U32_MAX_LEN + 1) + 1;
+  char* buf = calloc(1, buflen);
+  if (buf != NULL && pread(fd, buf, buflen - 1, 0) > 0) {
+    tok = strtok_r(buf, " ", &ptr);
+    for (; tok != NULL && i < len; tok = strtok_r(NULL, " ", &ptr), i++) {
+      errno = 0;
+      arr[i] = strtoul(tok, NULL, 0);
+      if (errno) {
+        i = 0;
+        tok = NULL;
+        break;
+      }
+    }
+    if (tok != NULL) {
+      i = 0;
+      errno = ERANGE;
+    }
+  }
+  free(buf);
+  return i;
+}
+
+static uint32_t baseline_strarr(int fd, char* governors, size_t len, size_t width) {
+  char* ptr;
+  char* tok;
+  uint32_t i = 0;
+  size_t buflen = len * (GOVERNOR_NAME_MAX_LEN + 1) + 1;
+  char* buf = calloc(1, buflen);
+  if (buf != NULL && pread(fd, buf, buflen - 1, 0) > 0) {
+    buf[strcspn(buf, "\n")] = '\0';
+    tok = strtok_r(buf, " ", &ptr);
+    for (; tok != NULL && i < len; tok = strtok_r(NULL, " ", &ptr), i++) {
+      strncpy(&governors[i * width], tok, width);
+    }
+    if (tok != NULL) {
+      i = 0;
+      errno = ERANGE;
+    }
+  }
+  free(buf);
+  return i;
+}
+
+// new implementation: pread in chunks, stopping at a short read, as in the library's read_file_parse
+static uint32_t new_u32arr(int fd, uint32_t* arr, uint32_t len) {
+  char buf[PARSE_CHUNK_LEN];
+  cpufreq_bindings_u32arr_parser p;
+  off_t off = 0;
+  ssize_t ret;
+  cpufreq_bindings_u32arr_parser_init(&p, arr, len);
+  while ((ret = pread(fd, buf, sizeof(buf), off)) > 0) {
+    new_reads++;
+    off += ret;
+    if (cpufreq_bindings_u32arr_parse(&p, buf, (size_t) ret) || (size_t) ret < sizeof(buf)) {
+      break;
+    }
+  }
+  return cpufreq_bindings_u32arr_parser_finish(&p);
+}
+
+static uint32_t new_strarr(int fd, char* governors, size_t len, size_t width) {
+  char buf[PARSE_CHUNK_LEN];
+  cpufreq_bindings_strarr_parser p;
+  ssize_t ret;
+  cpufreq_bindings_strarr_parser_init(&p, governors, len, width);
+  if ((ret = pread(fd, buf, sizeof(buf), 0)) > 0) {
+    new_reads++;
+    cpufreq_bindings_strarr_parse(&p, buf, (size_t) ret);
+  }
+  return cpufreq_bindings_strarr_parser_finish(&p);
+}
+
+// write the contents to a temporary file, which is unlinked right away; returns the file descriptor, or -1
+static int open_content(const char* content) {
+  char path[4096];
+  size_t len = strlen(content);
+  int fd;
+  snprintf(path, sizeof(path), "%s/cpufreq-bindings-parse-bench.XXXXXX", tmp_dir);
+  if ((fd = mkstemp(path)) < 0) {
+    perror(path);
+    return -1;
+  }
+  unlink(path);
+  if (pwrite(fd, content, len, 0) != (ssize_t) len) {
+    perror("pwrite");
+    close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+static void report(const char* name, uint64_t base_ns, uint64_t new_ns, uint32_t iters) {
+  printf("%-32s baseline: %10.1f ns/op  new: %10.1f ns/op (%.2f reads/op)  speedup: %6.2fx\n", name,
+         (double) base_ns / iters, (double) new_ns / iters, (double) new_reads / iters,
+         (double) base_ns / (double) (new_ns ? new_ns : 1));
+}
+
+static void bench_u32arr(const char* name, const char* content, uint32_t len, uint32_t iters, int check) {
+  uint32_t* arr = malloc(len * sizeof(uint32_t));
+  uint64_t start;
+  uint64_t base_ns;
+  uint32_t i;
+  int fd;
+  if (arr == NULL) {
+    perror("malloc");
+    return;
+  }
+  if ((fd = open_content(content)) < 0) {
+    free(arr);
+    return;
+  }
+  if (check && baseline_u32arr(fd, arr, len) != new_u32arr(fd, arr, len)) {
+    fprintf(stderr, "%s: parsers disagree\n", name);
+  }
+  start = now_ns();
+  for (i = 0; i < iters; i++) {
+    sink = baseline_u32arr(fd, arr, len);
+  }
+  base_ns = now_ns() - start;
+  new_reads = 0;
+  start = now_ns();
+  for (i = 0; i < iters; i++) {
+    sink = new_u32arr(fd, arr, len);
+  }
+  report(name, base_ns, now_ns() - start, iters);
+  close(fd);
+  free(arr);
+}
+
+static void bench_strarr(uint32_t iters) {
+  char governors[MAX_GOVS][MAX_GOV_LEN];
+  uint64_t start;
+  uint64_t base_ns;
+  uint32_t i;
+  int fd;
+  if ((fd = open_content(GOVERNORS)) < 0) {
+    return;
+  }
+  start = now_ns();
+  for (i = 0; i < iters; i++) {
+    sink = baseline_strarr(fd, governors[0], MAX_GOVS, MAX_GOV_LEN);
+  }
+  base_ns = now_ns() - start;
+  new_reads = 0;
+  start = now_ns();
+  for (i = 0; i < iters; i++) {
+    sink = new_strarr(fd, governors[0], MAX_GOVS, MAX_GOV_LEN);
+  }
+  report("scaling_available_governors", base_ns, now_ns() - start, iters);
+  close(fd);
+}
+
+static char* make_cpu_list(uint32_t ncpus) {
+  char* content = malloc((size_t) ncpus * (U32_MAX_LEN + 1) + 2);
+  size_t off = 0;
+  uint32_t i;
+  if (content != NULL) {
+    for (i = 0; i < ncpus; i++) {
+      off += (size_t) sprintf(&content[off], "%"PRIu32"%s", i, i + 1 < ncpus ? " " : "\n");
+    }
+  }
+  return content;
+}
+
+static const char short_options[] = "hc:i:d:";
+static const struct option long_options[] = {
+  {"help",                no_argument,        NULL, 'h'},
+  {"cpus",                required_argument,  NULL, 'c'},
+  {"iterations",          required_argument,  NULL, 'i'},
+  {"dir",                 required_argument,  NULL, 'd'},
+  {0, 0, 0, 0}
+};
+
+static void print_usage(void) {
+  printf("Usage: cpufreq-bindings-parse-bench [OPTION]...\n");
+  printf("Options:\n");
+  printf("  -h, --help                   Print this message and exit\n");
+  printf("  -c, --cpus=N                 The number of CPUs in parsed lists (default is 1024)\n");
+  printf("  -i, --iterations=N           The number of iterations (default is 100000)\n");
+  printf("  -d, --dir=DIR                The directory for temporary files (default is /tmp)\n");
+}
+
+int main(int argc, char** argv) {
+  uint32_t ncpus = 1024;
+  uint32_t iters = 100000;
+  char* list;
+  char range[32];
+  int c;
+  while ((c = getopt_long(argc, argv, short_options, long_options, NULL)) != -1) {
+    switch (c) {
+      case 'h':
+        print_usage();
+        return 0;
+      case 'c':
+        ncpus = (uint32_t) atoi(optarg);
+        break;
+      case 'i':
+        iters = (uint32_t) atoi(optarg);
+        break;
+      case 'd':
+        tmp_dir = optarg;
+        break;
+      case '?':
+      default:
+        print_usage();
+        return -EINVAL;
+    }
+  }
+  if (ncpus == 0 || iters == 0) {
+    print_usage();
+    return -EINVAL;
+  }
+  if ((list = make_cpu_list(ncpus)) == NULL) {
+    perror("malloc");
+    return -ENOMEM;
+  }
+  bench_u32arr("related_cpus (list)", list, ncpus, iters, 1);
+  bench_u32arr("related_cpus (4 cpus)", "0 1 2 3\n", ncpus, iters, 1);
+  bench_u32arr("scaling_available_frequencies", "3600000 3200000 2800000 2400000 2000000 1600000 1200000 800000\n",
+               ncpus, iters, 1);
+  // the previous parser can't handle ranges (it stops at the first value), so only the new parser's time is meaningful
+  snprintf(range, sizeof(range), "0-%"PRIu32"\n", ncpus - 1);
+  bench_u32arr("related_cpus (range)", range, ncpus, iters, 0);
+  bench_strarr(iters);
+  free(list);
+  return 0;
+}
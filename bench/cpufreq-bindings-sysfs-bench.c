@@ -0,0 +1,588 @@
+/**
+ * Benchmark every getter and setter against a synthetic cpufreq sysfs tree on tmpfs.
+ * For each CPU count, a tree is generated with "cpu<N>/cpufreq" symlinks to "cpufreq/policy<P>" directories (like the
+ * kernel creates), then each function is timed using the open-per-call path (fd = 0) and the context (cached fd) path,
+ * with one or more threads.
+ * Results are written to stdout as CSV or JSON; progress goes to stderr.
+ *
+ * tmpfs doesn't truncate on write, so setters only write values of the same length as the generated contents.
+ *
+ * @author Connor Imes
+ * @date 2026-10-15
+ */
+// for clock_gettime, nftw, pthread_barrier_t, symlink
+#define _XOPEN_SOURCE 700
+#include <errno.h>
+#include <ftw.h>
+#include <getopt.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#include "cpufreq-bindings.h"
+
+#define MAX_CPUS 4096
+#define MAX_LIST 32
+#define MAX_FREQS 8
+#define MAX_GOVS 8
+#define MAX_GOV_LEN 32
+
+typedef enum bench_format {
+  FORMAT_CSV,
+  FORMAT_JSON
+} bench_format;
+
+// returns 0 on success; ctx is NULL for the open-per-call path
+typedef int (*bench_fn)(cpufreq_bindings_ctx* ctx, uint32_t core, uint64_t iter);
+
+typedef struct bench_op {
+  const char* name;
+  bench_fn fn;
+} bench_op;
+
+typedef struct bench_thread {
+  pthread_t thread;
+  pthread_barrier_t* barrier;
+  cpufreq_bindings_ctx* ctx;
+  bench_fn fn;
+  uint32_t id;
+  uint32_t nthreads;
+  uint32_t ncpus;
+  uint64_t iterations;
+  uint64_t* lat_ns;
+  uint64_t errors;
+  // when this thread started and finished its calls
+  uint64_t start_ns;
+  uint64_t end_ns;
+} bench_thread;
+
+typedef struct bench_result {
+  uint64_t calls;
+  uint64_t errors;
+  uint64_t elapsed_ns;
+  double mean_ns;
+  uint64_t p50_ns;
+  uint64_t p99_ns;
+  uint64_t max_ns;
+} bench_result;
+
+static uint64_t now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t) ts.tv_sec * 1000000000ULL + (uint64_t) ts.tv_nsec;
+}
+
+/*
+ * Benchmarked functions
+ */
+
+#define BENCH_GET_U32(file) \
+  static int bench_get_##file(cpufreq_bindings_ctx* ctx, uint32_t core, uint64_t iter) { \
+    (void) iter; \
+    return (ctx == NULL ? cpufreq_bindings_get_##file(0, core) : cpufreq_bindings_ctx_get_##file(ctx, core)) == 0; \
+  }
+
+#define BENCH_GET_U32ARR(file, max) \
+  static int bench_get_##file(cpufreq_bindings_ctx* ctx, uint32_t core, uint64_t iter) { \
+    uint32_t arr[max]; \
+    (void) iter; \
+    return (ctx == NULL ? cpufreq_bindings_get_##file(0, core, arr, max) : \
+                          cpufreq_bindings_ctx_get_##file(ctx, core, arr, max)) == 0; \
+  }
+
+#define BENCH_GET_STR(file) \
+  static int bench_get_##file(cpufreq_bindings_ctx* ctx, uint32_t core, uint64_t iter) { \
+    char buf[MAX_GOV_LEN]; \
+    (void) iter; \
+    return (ctx == NULL ? cpufreq_bindings_get_##file(0, core, buf, sizeof(buf)) : \
+                          cpufreq_bindings_ctx_get_##file(ctx, core, buf, sizeof(buf))) <= 0; \
+  }
+
+// alternate between two values with the same number of digits
+#define BENCH_SET_U32(file, a, b) \
+  static int bench_set_##file(cpufreq_bindings_ctx* ctx, uint32_t core, uint64_t iter) { \
+    uint32_t freq = (iter & 1) ? (a) : (b); \
+    return (ctx == NULL ? cpufreq_bindings_set_##file(0, core, freq) : \
+                          cpufreq_bindings_ctx_set_##file(ctx, core, freq)) <= 0; \
+  }
+
+BENCH_GET_U32ARR(affected_cpus, MAX_CPUS)
+BENCH_GET_U32(bios_limit)
+BENCH_GET_U32(cpuinfo_cur_freq)
+BENCH_GET_U32(cpuinfo_max_freq)
+BENCH_GET_U32(cpuinfo_min_freq)
+BENCH_GET_U32(cpuinfo_transition_latency)
+BENCH_GET_U32ARR(related_cpus, MAX_CPUS)
+BENCH_GET_U32ARR(scaling_available_frequencies, MAX_FREQS)
+BENCH_GET_U32(scaling_cur_freq)
+BENCH_GET_STR(scaling_driver)
+BENCH_GET_STR(scaling_governor)
+BENCH_GET_U32(scaling_max_freq)
+BENCH_GET_U32(scaling_min_freq)
+BENCH_SET_U32(scaling_max_freq, 2400000, 2000000)
+BENCH_SET_U32(scaling_min_freq, 1200000, 1600000)
+BENCH_SET_U32(scaling_setspeed, 1200000, 1600000)
+
+static int bench_get_scaling_available_governors(cpufreq_bindings_ctx* ctx, uint32_t core, uint64_t iter) {
+  char governors[MAX_GOVS][MAX_GOV_LEN];
+  (void) iter;
+  return (ctx == NULL ?
+          cpufreq_bindings_get_scaling_available_governors(0, core, governors[0], MAX_GOVS, MAX_GOV_LEN) :
+          cpufreq_bindings_ctx_get_scaling_available_governors(ctx, core, governors[0], MAX_GOVS, MAX_GOV_LEN)) == 0;
+}
+
+static int bench_set_scaling_governor(cpufreq_bindings_ctx* ctx, uint32_t core, uint64_t iter) {
+  static const char gov[] = "userspace";
+  (void) iter;
+  return (ctx == NULL ? cpufreq_bindings_set_scaling_governor(0, core, gov, sizeof(gov) - 1) :
+                        cpufreq_bindings_ctx_set_scaling_governor(ctx, core, gov, sizeof(gov) - 1)) <= 0;
+}
+
+static const bench_op OPS[] = {
+  {"get_affected_cpus", bench_get_affected_cpus},
+  {"get_bios_limit", bench_get_bios_limit},
+  {"get_cpuinfo_cur_freq", bench_get_cpuinfo_cur_freq},
+  {"get_cpuinfo_max_freq", bench_get_cpuinfo_max_freq},
+  {"get_cpuinfo_min_freq", bench_get_cpuinfo_min_freq},
+  {"get_cpuinfo_transition_latency", bench_get_cpuinfo_transition_latency},
+  {"get_related_cpus", bench_get_related_cpus},
+  {"get_scaling_available_frequencies", bench_get_scaling_available_frequencies},
+  {"get_scaling_available_governors", bench_get_scaling_available_governors},
+  {"get_scaling_cur_freq", bench_get_scaling_cur_freq},
+  {"get_scaling_driver", bench_get_scaling_driver},
+  {"get_scaling_governor", bench_get_scaling_governor},
+  {"set_scaling_governor", bench_set_scaling_governor},
+  {"get_scaling_max_freq", bench_get_scaling_max_freq},
+  {"set_scaling_max_freq", bench_set_scaling_max_freq},
+  {"get_scaling_min_freq", bench_get_scaling_min_freq},
+  {"set_scaling_min_freq", bench_set_scaling_min_freq},
+  {"set_scaling_setspeed", bench_set_scaling_setspeed}
+};
+#define NOPS (sizeof(OPS) / sizeof(OPS[0]))
+
+/*
+ * Synthetic sysfs tree
+ */
+
+static int write_str(const char* dir, const char* name, const char* val) {
+  char path[4096];
+  FILE* f;
+  int len = snprintf(path, sizeof(path), "%s/%s", dir, name);
+  if (len < 0 || (size_t) len >= sizeof(path)) {
+    errno = ENAMETOOLONG;
+    perror(dir);
+    return -1;
+  }
+  if ((f = fopen(path, "w")) == NULL) {
+    perror(path);
+    return -1;
+  }
+  fputs(val, f);
+  return fclose(f);
+}
+
+static int write_cpu_list(const char* dir, const char* name, uint32_t first, uint32_t n) {
+  char* buf = malloc((size_t) n * 6 + 2);
+  size_t len = 0;
+  uint32_t i;
+  int ret;
+  if (buf == NULL) {
+    return -1;
+  }
+  for (i = 0; i < n; i++) {
+    len += (size_t) sprintf(&buf[len], "%"PRIu32" ", first + i);
+  }
+  buf[len++] = '\n';
+  buf[len] = '\0';
+  ret = write_str(dir, name, buf);
+  free(buf);
+  return ret;
+}
+
+static int write_policy(const char* dir, uint32_t first, uint32_t n) {
+  static const char* const files[][2] = {
+    {"bios_limit", "2400000\n"},
+    {"cpuinfo_cur_freq", "1200000\n"},
+    {"cpuinfo_max_freq", "2400000\n"},
+    {"cpuinfo_min_freq", "1200000\n"},
+    {"cpuinfo_transition_latency", "10000\n"},
+    {"scaling_available_frequencies", "2400000 2000000 1600000 1200000 \n"},
+    {"scaling_available_governors", "performance powersave userspace ondemand\n"},
+    {"scaling_cur_freq", "1200000\n"},
+    {"scaling_driver", "acpi-cpufreq\n"},
+    {"scaling_governor", "userspace\n"},
+    {"scaling_max_freq", "2400000\n"},
+    {"scaling_min_freq", "1200000\n"},
+    {"scaling_setspeed", "1200000\n"}
+  };
+  size_t i;
+  if (mkdir(dir, 0755) && errno != EEXIST) {
+    perror(dir);
+    return -1;
+  }
+  for (i = 0; i < sizeof(files) / sizeof(files[0]); i++) {
+    if (write_str(dir, files[i][0], files[i][1])) {
+      return -1;
+    }
+  }
+  return write_cpu_list(dir, "affected_cpus", first, n) || write_cpu_list(dir, "related_cpus", first, n);
+}
+
+static int mkdirs(char* path) {
+  char* p;
+  for (p = strchr(path + 1, '/'); p != NULL; p = strchr(p + 1, '/')) {
+    *p = '\0';
+    if (mkdir(path, 0755) && errno != EEXIST) {
+      perror(path);
+      return -1;
+    }
+    *p = '/';
+  }
+  if (mkdir(path, 0755) && errno != EEXIST) {
+    perror(path);
+    return -1;
+  }
+  return 0;
+}
+
+static int generate_tree(const char* root, uint32_t ncpus, uint32_t policy_size) {
+  char path[4096];
+  char target[64];
+  uint32_t cpu;
+  uint32_t n;
+  snprintf(path, sizeof(path), "%s/devices/system/cpu/cpufreq", root);
+  if (mkdirs(path)) {
+    return -1;
+  }
+  for (cpu = 0; cpu < ncpus; cpu += policy_size) {
+    n = ncpus - cpu < policy_size ? ncpus - cpu : policy_size;
+    snprintf(path, sizeof(path), "%s/devices/system/cpu/cpufreq/policy%"PRIu32, root, cpu);
+    if (write_policy(path, cpu, n)) {
+      return -1;
+    }
+  }
+  for (cpu = 0; cpu < ncpus; cpu++) {
+    snprintf(path, sizeof(path), "%s/devices/system/cpu/cpu%"PRIu32, root, cpu);
+    if (mkdir(path, 0755) && errno != EEXIST) {
+      perror(path);
+      return -1;
+    }
+    snprintf(path, sizeof(path), "%s/devices/system/cpu/cpu%"PRIu32"/cpufreq", root, cpu);
+    snprintf(target, sizeof(target), "../cpufreq/policy%"PRIu32, cpu - cpu % policy_size);
+    if (symlink(target, path)) {
+      perror(path);
+      return -1;
+    }
+  }
+  return 0;
+}
+
+static int remove_entry(const char* path, const struct stat* st, int flag, struct FTW* ftw) {
+  (void) st;
+  (void) flag;
+  (void) ftw;
+  if (remove(path)) {
+    perror(path);
+  }
+  return 0;
+}
+
+static void remove_tree(const char* root) {
+  nftw(root, remove_entry, 64, FTW_DEPTH | FTW_PHYS);
+}
+
+/*
+ * Measurement
+ */
+
+static void* bench_thread_run(void* arg) {
+  bench_thread* t = arg;
+  uint64_t start;
+  uint64_t i;
+  uint32_t core = t->id % t->ncpus;
+  pthread_barrier_wait(t->barrier);
+  t->start_ns = now_ns();
+  for (i = 0; i < t->iterations; i++) {
+    start = now_ns();
+    if (t->fn(t->ctx, core, i)) {
+      t->errors++;
+    }
+    t->lat_ns[i] = now_ns() - start;
+    // threads stride across cores so they don't all hammer the same files
+    core += t->nthreads;
+    if (core >= t->ncpus) {
+      core %= t->ncpus;
+    }
+  }
+  t->end_ns = now_ns();
+  return NULL;
+}
+
+static int cmp_u64(const void* a, const void* b) {
+  uint64_t x = *(const uint64_t*) a;
+  uint64_t y = *(const uint64_t*) b;
+  return x < y ? -1 : x > y ? 1 : 0;
+}
+
+static void run_case(cpufreq_bindings_ctx* ctx, bench_fn fn, uint32_t ncpus, uint32_t nthreads, uint64_t iterations,
+                     uint64_t* lat_ns, bench_thread* threads, bench_result* res) {
+  pthread_barrier_t barrier;
+  uint64_t start = UINT64_MAX;
+  uint64_t end = 0;
+  uint64_t total = 0;
+  uint64_t j;
+  uint32_t i;
+  if (ctx != NULL) {
+    // open every file up front so the cached path is measured in its steady state
+    for (i = 0; i < ncpus; i++) {
+      fn(ctx, i, 0);
+    }
+  }
+  pthread_barrier_init(&barrier, NULL, nthreads + 1);
+  for (i = 0; i < nthreads; i++) {
+    threads[i].barrier = &barrier;
+    threads[i].ctx = ctx;
+    threads[i].fn = fn;
+    threads[i].id = i;
+    threads[i].nthreads = nthreads;
+    threads[i].ncpus = ncpus;
+    threads[i].iterations = iterations;
+    threads[i].lat_ns = &lat_ns[i * iterations];
+    threads[i].errors = 0;
+    if ((errno = pthread_create(&threads[i].thread, NULL, bench_thread_run, &threads[i]))) {
+      perror("pthread_create");
+      // nobody can proceed past the barrier now
+      exit(1);
+    }
+  }
+  pthread_barrier_wait(&barrier);
+  for (i = 0; i < nthreads; i++) {
+    pthread_join(threads[i].thread, NULL);
+  }
+  pthread_barrier_destroy(&barrier);
+  // workers may start before this thread leaves the barrier, so time the span of their own timestamps
+  for (i = 0; i < nthreads; i++) {
+    start = threads[i].start_ns < start ? threads[i].start_ns : start;
+    end = threads[i].end_ns > end ? threads[i].end_ns : end;
+  }
+  res->elapsed_ns = end - start;
+  res->calls = nthreads * iterations;
+  res->errors = 0;
+  for (i = 0; i < nthreads; i++) {
+    res->errors += threads[i].errors;
+  }
+  for (j = 0; j < res->calls; j++) {
+    total += lat_ns[j];
+  }
+  qsort(lat_ns, res->calls, sizeof(uint64_t), cmp_u64);
+  res->mean_ns = (double) total / res->calls;
+  res->p50_ns = lat_ns[res->calls / 2];
+  res->p99_ns = lat_ns[res->calls * 99 / 100];
+  res->max_ns = lat_ns[res->calls - 1];
+}
+
+static void print_result(bench_format format, int first, uint32_t ncpus, uint32_t policy_size, const char* path,
+                         uint32_t nthreads, const char* op, const bench_result* res) {
+  double ops_per_sec = res->elapsed_ns > 0 ? res->calls * 1e9 / res->elapsed_ns : 0;
+  if (format == FORMAT_CSV) {
+    printf("%"PRIu32",%"PRIu32",%s,%"PRIu32",%s,%"PRIu64",%"PRIu64",%.1f,%"PRIu64",%"PRIu64",%"PRIu64",%.0f\n",
+           ncpus, policy_size, path, nthreads, op, res->calls, res->errors, res->mean_ns, res->p50_ns, res->p99_ns,
+           res->max_ns, ops_per_sec);
+  } else {
+    printf("%s\n  {\"cpus\": %"PRIu32", \"policy_size\": %"PRIu32", \"path\": \"%s\", \"threads\": %"PRIu32
+           ", \"op\": \"%s\", \"calls\": %"PRIu64", \"errors\": %"PRIu64", \"mean_ns\": %.1f, \"p50_ns\": %"PRIu64
+           ", \"p99_ns\": %"PRIu64", \"max_ns\": %"PRIu64", \"ops_per_sec\": %.0f}",
+           first ? "" : ",", ncpus, policy_size, path, nthreads, op, res->calls, res->errors, res->mean_ns,
+           res->p50_ns, res->p99_ns, res->max_ns, ops_per_sec);
+  }
+  fflush(stdout);
+}
+
+static uint32_t parse_list(const char* str, uint32_t* list, uint32_t max) {
+  char* end;
+  unsigned long val;
+  uint32_t n = 0;
+  while (*str != '\0' && n < max) {
+    val = strtoul(str, &end, 0);
+    if (end == str || val == 0 || val > MAX_CPUS) {
+      return 0;
+    }
+    list[n++] = (uint32_t) val;
+    str = *end == ',' ? end + 1 : end;
+  }
+  return *str == '\0' ? n : 0;
+}
+
+// a context caches an fd for every file, so it needs many more than the usual soft limit
+static void raise_nofile_limit(void) {
+  struct rlimit rl;
+  if (!getrlimit(RLIMIT_NOFILE, &rl) && rl.rlim_cur < rl.rlim_max) {
+    rl.rlim_cur = rl.rlim_max;
+    if (setrlimit(RLIMIT_NOFILE, &rl)) {
+      perror("setrlimit");
+    }
+  }
+}
+
+static const char short_options[] = "hd:c:t:p:i:f:k";
+static const struct option long_options[] = {
+  {"help",                no_argument,        NULL, 'h'},
+  {"dir",                 required_argument,  NULL, 'd'},
+  {"cpus",                required_argument,  NULL, 'c'},
+  {"threads",             required_argument,  NULL, 't'},
+  {"policy-size",         required_argument,  NULL, 'p'},
+  {"iterations",          required_argument,  NULL, 'i'},
+  {"format",              required_argument,  NULL, 'f'},
+  {"keep",                no_argument,        NULL, 'k'},
+  {0, 0, 0, 0}
+};
+
+static void print_usage(void) {
+  printf("Usage: cpufreq-bindings-sysfs-bench [OPTION]...\n");
+  printf("Options:\n");
+  printf("  -h, --help                   Print this message and exit\n");
+  printf("  -d, --dir=DIR                Where to generate trees (default is /dev/shm/cpufreq-bindings-bench-<pid>)\n");
+  printf("  -c, --cpus=LIST              Comma-separated CPU counts, up to %d (default is 1,16,256,4096)\n", MAX_CPUS);
+  printf("  -t, --threads=LIST           Comma-separated thread counts (default is 1,4)\n");
+  printf("  -p, --policy-size=N          CPUs per policy (default is 1)\n");
+  printf("  -i, --iterations=N           Calls per thread for each measurement (default is 10000)\n");
+  printf("  -f, --format=FORMAT          Output format: csv or json (default is csv)\n");
+  printf("  -k, --keep                   Don't remove the last generated tree\n");
+}
+
+int main(int argc, char** argv) {
+  char dir[256];
+  char root[512];
+  uint32_t cpus[MAX_LIST] = { 1, 16, 256, 4096 };
+  uint32_t threads[MAX_LIST] = { 1, 4 };
+  uint32_t ncpus_list = 4;
+  uint32_t nthreads_list = 2;
+  uint32_t max_threads = 0;
+  uint32_t policy_size = 1;
+  uint64_t iterations = 10000;
+  bench_format format = FORMAT_CSV;
+  cpufreq_bindings_ctx* ctx;
+  bench_thread* bench_threads;
+  uint64_t* lat_ns;
+  bench_result res;
+  uint32_t c;
+  uint32_t t;
+  uint32_t o;
+  int path;
+  int keep = 0;
+  int first = 1;
+  int ret = 0;
+  int opt;
+  snprintf(dir, sizeof(dir), "/dev/shm/cpufreq-bindings-bench-%ld", (long) getpid());
+  while ((opt = getopt_long(argc, argv, short_options, long_options, NULL)) != -1) {
+    switch (opt) {
+      case 'h':
+        print_usage();
+        return 0;
+      case 'd':
+        snprintf(dir, sizeof(dir), "%s", optarg);
+        break;
+      case 'c':
+        if ((ncpus_list = parse_list(optarg, cpus, MAX_LIST)) == 0) {
+          print_usage();
+          return -EINVAL;
+        }
+        break;
+      case 't':
+        if ((nthreads_list = parse_list(optarg, threads, MAX_LIST)) == 0) {
+          print_usage();
+          return -EINVAL;
+        }
+        break;
+      case 'p':
+        policy_size = strtoul(optarg, NULL, 0);
+        break;
+      case 'i':
+        iterations = strtoull(optarg, NULL, 0);
+        break;
+      case 'f':
+        if (!strcmp(optarg, "csv")) {
+          format = FORMAT_CSV;
+        } else if (!strcmp(optarg, "json")) {
+          format = FORMAT_JSON;
+        } else {
+          print_usage();
+          return -EINVAL;
+        }
+        break;
+      case 'k':
+        keep = 1;
+        break;
+      case '?':
+      default:
+        print_usage();
+        return -EINVAL;
+    }
+  }
+  if (policy_size == 0 || iterations == 0) {
+    print_usage();
+    return -EINVAL;
+  }
+  for (t = 0; t < nthreads_list; t++) {
+    if (threads[t] > max_threads) {
+      max_threads = threads[t];
+    }
+  }
+  lat_ns = malloc(max_threads * iterations * sizeof(uint64_t));
+  bench_threads = malloc(max_threads * sizeof(bench_thread));
+  if (lat_ns == NULL || bench_threads == NULL) {
+    perror("malloc");
+    free(lat_ns);
+    free(bench_threads);
+    return -ENOMEM;
+  }
+  raise_nofile_limit();
+  if (format == FORMAT_CSV) {
+    printf("cpus,policy_size,path,threads,op,calls,errors,mean_ns,p50_ns,p99_ns,max_ns,ops_per_sec\n");
+  } else {
+    printf("[");
+  }
+  for (c = 0; c < ncpus_list && !ret; c++) {
+    snprintf(root, sizeof(root), "%s/%"PRIu32, dir, cpus[c]);
+    fprintf(stderr, "Generating %"PRIu32" CPUs in %s\n", cpus[c], root);
+    if (mkdirs(root) || generate_tree(root, cpus[c], policy_size) || cpufreq_bindings_set_sysfs_root(root)) {
+      ret = -1;
+    }
+    for (path = 0; path < 2 && !ret; path++) {
+      for (t = 0; t < nthreads_list && !ret; t++) {
+        for (o = 0; o < NOPS && !ret; o++) {
+          // a fresh context per function, so large CPU counts don't run out of fds
+          ctx = NULL;
+          if (path && (ctx = cpufreq_bindings_ctx_init(cpus[c])) == NULL) {
+            perror("cpufreq_bindings_ctx_init");
+            ret = -1;
+            break;
+          }
+          run_case(ctx, OPS[o].fn, cpus[c], threads[t], iterations, lat_ns, bench_threads, &res);
+          print_result(format, first, cpus[c], policy_size, path ? "ctx" : "open", threads[t], OPS[o].name, &res);
+          first = 0;
+          if (ctx != NULL) {
+            cpufreq_bindings_ctx_destroy(ctx);
+          }
+        }
+      }
+    }
+    if (!keep || c + 1 < ncpus_list) {
+      remove_tree(root);
+    }
+  }
+  if (!keep) {
+    rmdir(dir);
+  }
+  if (format == FORMAT_JSON) {
+    printf("\n]\n");
+  }
+  free(lat_ns);
+  free(bench_threads);
+  return ret;
+}
@@ -0,0 +1,148 @@
+/**
+ * Frequency tables: a policy's valid frequencies, sorted and deduplicated once so that mapping a desired frequency to
+ * a valid one is cheap enough for a control loop.
+ * Lookups never make system calls - they are O(1) for evenly-spaced tables (including synthesized ones) and
+ * O(log n) otherwise.
+ *
+ * When "scaling_available_frequencies" doesn't exist (e.g., with intel_pstate or amd-pstate), a table is synthesized
+ * from "cpuinfo_min_freq" to "cpuinfo_max_freq" at a fixed step.
+ * A table is immutable once created, so it may be shared between threads.
+ *
+ * @author Connor Imes
+ * @date 2026-10-15
+ */
+#ifndef _CPUFREQ_BINDINGS_FREQ_TABLE_H_
+#define _CPUFREQ_BINDINGS_FREQ_TABLE_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <inttypes.h>
+#include "cpufreq-bindings.h"
+
+// the step used for synthesized tables when none is given: 100 MHz
+#define CPUFREQ_BINDINGS_FREQ_TABLE_STEP_DEFAULT 100000
+
+typedef struct cpufreq_bindings_freq_table cpufreq_bindings_freq_table;
+
+/**
+ * Create a table for a core's policy from "scaling_available_frequencies", or synthesize one from "cpuinfo_min_freq"
+ * and "cpuinfo_max_freq" if that file can't be read.
+ * Reads go through the context, so they are served from its static attribute cache if enabled.
+ *
+ * @param ctx
+ * @param core
+ * @param step_khz
+ *  The step between synthesized frequencies in kHz (0 for CPUFREQ_BINDINGS_FREQ_TABLE_STEP_DEFAULT) - the maximum
+ *  frequency is always included, even if it isn't a multiple of the step above the minimum
+ * @return the table, or NULL on failure (errno will be set)
+ */
+cpufreq_bindings_freq_table* cpufreq_bindings_freq_table_init(cpufreq_bindings_ctx* ctx, uint32_t core,
+                                                              uint32_t step_khz);
+
+/**
+ * Create a table from an array of frequencies, in any order and possibly with duplicates.
+ *
+ * @param freqs
+ *  The frequencies in kHz (the array is copied)
+ * @param len
+ *  The length of the "freqs" array, which must be > 0
+ * @return the table, or NULL on failure (errno will be set)
+ */
+cpufreq_bindings_freq_table* cpufreq_bindings_freq_table_init_array(const uint32_t* freqs, uint32_t len);
+
+/**
+ * Free a table.
+ *
+ * @param table
+ */
+void cpufreq_bindings_freq_table_destroy(cpufreq_bindings_freq_table* table);
+
+/**
+ * Get the number of frequencies (levels) in a table, which is always > 0.
+ *
+ * @param table
+ * @return the number of frequencies
+ */
+uint32_t cpufreq_bindings_freq_table_get_len(const cpufreq_bindings_freq_table* table);
+
+/**
+ * Get a table's frequencies, in ascending order without duplicates.
+ *
+ * @param table
+ * @return the frequencies, of length cpufreq_bindings_freq_table_get_len(table) - owned by the table
+ */
+const uint32_t* cpufreq_bindings_freq_table_get_freqs(const cpufreq_bindings_freq_table* table);
+
+/**
+ * Check if a table was synthesized from "cpuinfo_min_freq" and "cpuinfo_max_freq".
+ *
+ * @param table
+ * @return 1 if synthesized, 0 otherwise
+ */
+int cpufreq_bindings_freq_table_is_synthesized(const cpufreq_bindings_freq_table* table);
+
+/**
+ * Get the frequency at a level.
+ *
+ * @param table
+ * @param idx
+ *  The level, where 0 is the lowest frequency
+ * @return the frequency, or 0 on failure (errno will be set - ERANGE if "idx" is out of range)
+ */
+uint32_t cpufreq_bindings_freq_table_get(const cpufreq_bindings_freq_table* table, uint32_t idx);
+
+/**
+ * Get the table frequency closest to a frequency, preferring the lower one on a tie.
+ *
+ * @param table
+ * @param freq
+ * @return the closest frequency
+ */
+uint32_t cpufreq_bindings_freq_table_nearest(const cpufreq_bindings_freq_table* table, uint32_t freq);
+
+/**
+ * Get the highest table frequency <= a frequency.
+ *
+ * @param table
+ * @param freq
+ * @return the frequency, or 0 on failure (errno will be set - ERANGE if "freq" is below the lowest frequency)
+ */
+uint32_t cpufreq_bindings_freq_table_floor(const cpufreq_bindings_freq_table* table, uint32_t freq);
+
+/**
+ * Get the lowest table frequency >= a frequency.
+ *
+ * @param table
+ * @param freq
+ * @return the frequency, or 0 on failure (errno will be set - ERANGE if "freq" is above the highest frequency)
+ */
+uint32_t cpufreq_bindings_freq_table_ceil(const cpufreq_bindings_freq_table* table, uint32_t freq);
+
+/**
+ * Get the level of a frequency.
+ *
+ * @param table
+ * @param freq
+ * @return the level, or -1 on failure (errno will be set - ENOENT if "freq" isn't in the table)
+ */
+int64_t cpufreq_bindings_freq_table_index_of(const cpufreq_bindings_freq_table* table, uint32_t freq);
+
+/**
+ * Step up or down from the level closest to a frequency (see cpufreq_bindings_freq_table_nearest), stopping at the
+ * lowest or highest frequency.
+ *
+ * @param table
+ * @param freq
+ * @param levels
+ *  The number of levels to step - positive to step up, negative to step down
+ * @return the frequency
+ */
+uint32_t cpufreq_bindings_freq_table_step(const cpufreq_bindings_freq_table* table, uint32_t freq, int32_t levels);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
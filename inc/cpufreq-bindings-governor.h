@@ -0,0 +1,217 @@
+/**
+ * A userspace governor engine for use with the "userspace" cpufreq governor.
+ * Each period, the engine reads per-core utilization from "/proc/stat", asks a policy function for each cpufreq
+ * policy's desired frequency, and writes "scaling_setspeed" for policies whose frequency changed.
+ *
+ * Reads and writes use file descriptors that are opened once, writes are batched across policies, and periods are
+ * scheduled against absolute deadlines, so the engine's overhead and decision latency stay small and predictable.
+ * An overhead budget bounds how long a period may spend making decisions: once it's exceeded, the remaining policies
+ * keep their current frequencies until the next period.
+ *
+ * The sysfs root (see cpufreq_bindings_set_sysfs_root) and procfs root are configurable, so the engine can be tested
+ * against a synthetic tree.
+ *
+ * @author Connor Imes
+ * @date 2026-10-15
+ */
+#ifndef _CPUFREQ_BINDINGS_GOVERNOR_H_
+#define _CPUFREQ_BINDINGS_GOVERNOR_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <inttypes.h>
+#include "cpufreq-bindings.h"
+#include "cpufreq-bindings-freq-table.h"
+
+// the number of values in each policy's private state
+#define CPUFREQ_BINDINGS_GOVERNOR_STATE_LEN 4
+
+typedef struct cpufreq_bindings_governor cpufreq_bindings_governor;
+
+typedef struct cpufreq_bindings_governor_input {
+  // the kernel policy number, and its index among the governor's policies
+  uint32_t policy;
+  uint32_t idx;
+  // the highest utilization of the policy's cores over the last period, from 0 to 1
+  double util;
+  // the frequency last written for the policy, or 0 before the first write
+  uint32_t cur_freq;
+  // the policy's frequencies (see cpufreq-bindings-freq-table.h)
+  const cpufreq_bindings_freq_table* table;
+  // time since the governor started, and the length of the last period
+  uint64_t elapsed_ns;
+  uint64_t period_ns;
+  // private to the policy function - zeroed when the governor is created
+  double* state;
+} cpufreq_bindings_governor_input;
+
+/**
+ * A policy function.
+ * It is called once per cpufreq policy per period, and must not block.
+ *
+ * @param in
+ * @param arg
+ *  The argument given in the governor options
+ * @return the desired frequency in kHz, which is rounded up to the next frequency in the table (or down to the
+ *  highest), or 0 to keep the current frequency
+ */
+typedef uint32_t (*cpufreq_bindings_governor_policy)(const cpufreq_bindings_governor_input* in, void* arg);
+
+typedef struct cpufreq_bindings_governor_opts {
+  cpufreq_bindings_governor_policy policy;
+  void* arg;
+  uint64_t period_ns;
+  // the maximum time per period spent reading utilization and making decisions (0 for no limit)
+  uint64_t budget_ns;
+  // the procfs root, or NULL for "/proc"
+  const char* procfs_root;
+  // the step for synthesized frequency tables (see cpufreq_bindings_freq_table_init)
+  uint32_t step_khz;
+} cpufreq_bindings_governor_opts;
+
+typedef struct cpufreq_bindings_governor_stats {
+  // periods run, and periods skipped entirely because the governor fell behind by more than a period
+  uint64_t periods;
+  uint64_t dropped;
+  // policy function calls, and decisions skipped because the budget was exceeded
+  uint64_t decisions;
+  uint64_t skipped;
+  // periods whose reads and decisions exceeded the budget
+  uint64_t over_budget;
+  // "scaling_setspeed" writes, and writes or "/proc/stat" reads that failed
+  uint64_t writes;
+  uint64_t errors;
+  // time per period spent reading, deciding, and writing
+  uint64_t overhead_ns_total;
+  uint64_t overhead_ns_max;
+  // time from a decision to the completion of its write, summed and maximum over writes
+  uint64_t write_latency_ns_total;
+  uint64_t write_latency_ns_max;
+} cpufreq_bindings_governor_stats;
+
+/**
+ * Parameters for cpufreq_bindings_governor_ondemand.
+ */
+typedef struct cpufreq_bindings_governor_ondemand_params {
+  // utilization above which the maximum frequency is used (0 for the default of 0.8)
+  double up_threshold;
+} cpufreq_bindings_governor_ondemand_params;
+
+/**
+ * Parameters for cpufreq_bindings_governor_pid.
+ * The controller output is a change in frequency as a fraction of the policy's frequency range.
+ */
+typedef struct cpufreq_bindings_governor_pid_params {
+  // the target utilization, from 0 to 1
+  double setpoint;
+  double kp;
+  double ki;
+  double kd;
+} cpufreq_bindings_governor_pid_params;
+
+typedef struct cpufreq_bindings_governor_schedule_entry {
+  uint64_t duration_ns;
+  uint32_t freq;
+} cpufreq_bindings_governor_schedule_entry;
+
+/**
+ * Parameters for cpufreq_bindings_governor_schedule.
+ */
+typedef struct cpufreq_bindings_governor_schedule_params {
+  // entries are used in order, repeating from the start after the last
+  const cpufreq_bindings_governor_schedule_entry* entries;
+  uint32_t nentries;
+} cpufreq_bindings_governor_schedule_params;
+
+/**
+ * Like the kernel's "ondemand" governor: use the maximum frequency when utilization exceeds a threshold, otherwise a
+ * frequency proportional to utilization.
+ * The argument is a cpufreq_bindings_governor_ondemand_params, or NULL for defaults.
+ */
+uint32_t cpufreq_bindings_governor_ondemand(const cpufreq_bindings_governor_input* in, void* arg);
+
+/**
+ * A PID controller that holds utilization at a setpoint.
+ * The argument is a cpufreq_bindings_governor_pid_params.
+ */
+uint32_t cpufreq_bindings_governor_pid(const cpufreq_bindings_governor_input* in, void* arg);
+
+/**
+ * Follow a fixed schedule of frequencies, regardless of utilization.
+ * The argument is a cpufreq_bindings_governor_schedule_params.
+ */
+uint32_t cpufreq_bindings_governor_schedule(const cpufreq_bindings_governor_input* in, void* arg);
+
+/**
+ * Create a governor - it is not started.
+ * The cores' policies should already use the "userspace" governor.
+ *
+ * @param ctx
+ *  The context must outlive the governor
+ * @param cores
+ *  The cores to govern - all cores in their policies are governed (the array is copied)
+ * @param ncores
+ *  The length of the "cores" array
+ * @param opts
+ *  The options (the struct and procfs root are copied; the policy argument must outlive the governor)
+ * @return the governor, or NULL on failure (errno will be set)
+ */
+cpufreq_bindings_governor* cpufreq_bindings_governor_init(cpufreq_bindings_ctx* ctx, const uint32_t* cores,
+                                                          uint32_t ncores, const cpufreq_bindings_governor_opts* opts);
+
+/**
+ * Stop the governor if it is running and free it.
+ *
+ * @param governor
+ */
+void cpufreq_bindings_governor_destroy(cpufreq_bindings_governor* governor);
+
+/**
+ * Start the governor thread.
+ *
+ * @param governor
+ * @return 0 on success, or -1 on failure (errno will be set)
+ */
+int cpufreq_bindings_governor_start(cpufreq_bindings_governor* governor);
+
+/**
+ * Stop the governor thread and wait for it to exit.
+ *
+ * @param governor
+ * @return 0 on success, or -1 on failure (errno will be set)
+ */
+int cpufreq_bindings_governor_stop(cpufreq_bindings_governor* governor);
+
+/**
+ * Run one period in the calling thread, e.g., to drive the governor from an existing loop or for testing.
+ * The first call only records initial utilization.
+ *
+ * @param governor
+ * @return 0 on success, or -1 on failure (errno will be set - EBUSY if the governor thread is running)
+ */
+int cpufreq_bindings_governor_step(cpufreq_bindings_governor* governor);
+
+/**
+ * Get the number of policies the governor controls.
+ *
+ * @param governor
+ * @return the number of policies
+ */
+uint32_t cpufreq_bindings_governor_get_npolicies(const cpufreq_bindings_governor* governor);
+
+/**
+ * Get the governor's statistics (may be called while the governor is running).
+ *
+ * @param governor
+ * @param stats
+ */
+void cpufreq_bindings_governor_get_stats(const cpufreq_bindings_governor* governor,
+                                         cpufreq_bindings_governor_stats* stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
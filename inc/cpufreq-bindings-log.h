@@ -0,0 +1,122 @@
+/**
+ * Library logging: a runtime log level, a user-registered sink, rate limiting, and a ring buffer of recent errors.
+ *
+ * Errors that carry an errno value (e.g., a failed read) are rate-limited per (core, file, errno): by default, at most
+ * one per second is passed to the sink, which is told how many identical errors were suppressed in between.
+ * All such errors, including suppressed ones, are also recorded in a fixed-size lock-free ring of recent errors that
+ * can be read at any time, so a failure storm costs little more than a clock read and a copy per error.
+ *
+ * By default, messages at or above the level are written to stdout (DEBUG, INFO) or stderr (WARN, ERROR).
+ * The default level is WARN, unless the library was built with a different CPUFREQ_BINDINGS_LOG_LEVEL.
+ *
+ * @author Connor Imes
+ * @date 2026-10-15
+ */
+#ifndef _CPUFREQ_BINDINGS_LOG_H_
+#define _CPUFREQ_BINDINGS_LOG_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <inttypes.h>
+
+// messages are truncated to this length, including the NULL terminator
+#define CPUFREQ_BINDINGS_LOG_MSG_LEN 128
+
+// the number of recent errors kept
+#define CPUFREQ_BINDINGS_LOG_RING_LEN 64
+
+typedef enum cpufreq_bindings_log_level {
+  CPUFREQ_BINDINGS_LOG_LEVEL_DEBUG = 0,
+  CPUFREQ_BINDINGS_LOG_LEVEL_INFO,
+  CPUFREQ_BINDINGS_LOG_LEVEL_WARN,
+  CPUFREQ_BINDINGS_LOG_LEVEL_ERROR,
+  CPUFREQ_BINDINGS_LOG_LEVEL_OFF
+} cpufreq_bindings_log_level;
+
+typedef struct cpufreq_bindings_log_event {
+  // CLOCK_MONOTONIC
+  uint64_t timestamp_ns;
+  cpufreq_bindings_log_level level;
+  // the errno value, or 0 if none
+  int err;
+  // the core and cpufreq_bindings_file, or UINT32_MAX and -1 if not specific to one
+  uint32_t core;
+  int file;
+  // for errors with an errno value, the number of identical errors suppressed since the last one passed to the sink
+  uint32_t suppressed;
+  // the message, without the errno description or a trailing newline
+  char msg[CPUFREQ_BINDINGS_LOG_MSG_LEN];
+} cpufreq_bindings_log_event;
+
+/**
+ * A log sink.
+ * May be called concurrently from any thread that uses the library, and must not call back into the library.
+ *
+ * @param event
+ * @param arg
+ *  The argument given to cpufreq_bindings_log_set_callback
+ */
+typedef void (*cpufreq_bindings_log_fn)(const cpufreq_bindings_log_event* event, void* arg);
+
+/**
+ * Set the minimum level of messages passed to the sink (CPUFREQ_BINDINGS_LOG_LEVEL_OFF disables them).
+ * Errors are recorded in the ring of recent errors regardless of the level.
+ *
+ * @param level
+ */
+void cpufreq_bindings_log_set_level(cpufreq_bindings_log_level level);
+
+/**
+ * Get the minimum level of messages passed to the sink.
+ *
+ * @return the level
+ */
+cpufreq_bindings_log_level cpufreq_bindings_log_get_level(void);
+
+/**
+ * Set the log sink.
+ * Should be called before using other functions, and not concurrently with them.
+ *
+ * @param fn
+ *  The sink, or NULL to restore the default (stdout/stderr)
+ * @param arg
+ *  Passed to the sink
+ */
+void cpufreq_bindings_log_set_callback(cpufreq_bindings_log_fn fn, void* arg);
+
+/**
+ * Configure rate limiting of errors with an errno value.
+ *
+ * @param interval_ns
+ *  The length of the rate-limiting window (default 1 second)
+ * @param burst
+ *  The number of identical errors passed to the sink per window (default 1), or 0 to disable rate limiting
+ */
+void cpufreq_bindings_log_set_rate_limit(uint64_t interval_ns, uint32_t burst);
+
+/**
+ * Get recent warnings and errors: those with an errno value (including suppressed ones), and others that passed the
+ * log level.
+ *
+ * @param events
+ *  The array to be written to, oldest first
+ * @param len
+ *  The length of the "events" array - at most CPUFREQ_BINDINGS_LOG_RING_LEN events are kept
+ * @return the number of events written
+ */
+uint32_t cpufreq_bindings_log_get_recent(cpufreq_bindings_log_event* events, uint32_t len);
+
+/**
+ * Get the total number of errors suppressed by rate limiting.
+ *
+ * @return the number of errors suppressed
+ */
+uint64_t cpufreq_bindings_log_get_suppressed(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
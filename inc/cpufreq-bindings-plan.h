@@ -0,0 +1,111 @@
+/**
+ * Frequency plans: apply governor and frequency limit changes to a set of policies as a single transaction.
+ *
+ * A plan collects the desired "scaling_governor", "scaling_min_freq", and "scaling_max_freq" for each policy.
+ * Applying it reads the current settings, skips values that are already current, and writes the rest in an order the
+ * kernel always accepts: governors first, then limits that widen a policy's range (raising the maximum, lowering the
+ * minimum), then limits that narrow it.
+ * Writes in each step are batched across policies.
+ * If a write fails, the writes that succeeded are undone in reverse order.
+ *
+ * A plan is not thread-safe.
+ *
+ * @author Connor Imes
+ * @date 2026-10-15
+ */
+#ifndef _CPUFREQ_BINDINGS_PLAN_H_
+#define _CPUFREQ_BINDINGS_PLAN_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <inttypes.h>
+#include "cpufreq-bindings.h"
+
+// longer than any governor name
+#define CPUFREQ_BINDINGS_PLAN_GOVERNOR_LEN 32
+
+typedef struct cpufreq_bindings_plan cpufreq_bindings_plan;
+
+typedef struct cpufreq_bindings_plan_result {
+  // writes performed, not counting rollback
+  uint32_t writes;
+  // writes skipped because the value was already current
+  uint32_t elided;
+  // on failure, the policy whose write or read failed
+  uint32_t failed_policy;
+  // on failure, 1 if any writes that succeeded were undone (or there were none), 0 if undoing them also failed
+  int rolled_back;
+} cpufreq_bindings_plan_result;
+
+/**
+ * Create an empty plan.
+ *
+ * @param ctx
+ *  The context must outlive the plan
+ * @return the plan, or NULL on failure (errno will be set)
+ */
+cpufreq_bindings_plan* cpufreq_bindings_plan_init(cpufreq_bindings_ctx* ctx);
+
+/**
+ * Free a plan.
+ *
+ * @param plan
+ */
+void cpufreq_bindings_plan_destroy(cpufreq_bindings_plan* plan);
+
+/**
+ * Remove all settings from a plan.
+ *
+ * @param plan
+ */
+void cpufreq_bindings_plan_clear(cpufreq_bindings_plan* plan);
+
+/**
+ * Set the desired settings for a core's policy, replacing earlier settings for the same policy except those left
+ * unchanged here.
+ *
+ * @param plan
+ * @param core
+ * @param min_freq
+ *  The "scaling_min_freq", or 0 to leave unchanged
+ * @param max_freq
+ *  The "scaling_max_freq", or 0 to leave unchanged
+ * @param governor
+ *  The "scaling_governor", or NULL to leave unchanged
+ * @return 0 on success, or -1 on failure (errno will be set)
+ */
+int cpufreq_bindings_plan_set(cpufreq_bindings_plan* plan, uint32_t core, uint32_t min_freq, uint32_t max_freq,
+                              const char* governor);
+
+/**
+ * Like cpufreq_bindings_plan_set, but for a policy given by its kernel policy number.
+ *
+ * @param plan
+ * @param policy
+ * @param min_freq
+ * @param max_freq
+ * @param governor
+ * @return 0 on success, or -1 on failure (errno will be set - ENOENT if no context core belongs to the policy)
+ */
+int cpufreq_bindings_plan_set_policy(cpufreq_bindings_plan* plan, uint32_t policy, uint32_t min_freq,
+                                     uint32_t max_freq, const char* governor);
+
+/**
+ * Apply a plan.
+ * The plan's settings are kept, so applying it again only writes values that have since changed.
+ *
+ * @param plan
+ * @param result
+ *  Written to with details about the writes (may be NULL)
+ * @return 0 on success, or -1 on failure (errno will be set - EINVAL if a policy's minimum would exceed its maximum,
+ *  in which case nothing is written)
+ */
+int cpufreq_bindings_plan_apply(cpufreq_bindings_plan* plan, cpufreq_bindings_plan_result* result);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
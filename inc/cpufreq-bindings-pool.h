@@ -0,0 +1,76 @@
+/**
+ * Apply frequency settings to many cores in parallel.
+ * Writes can block in the driver for up to the transition latency, so a system-wide change made serially takes time
+ * proportional to the number of cores.
+ * A pool instead groups writes by cpufreq policy (writing each policy's files once) and spreads the policies across a
+ * set of reusable worker threads.
+ *
+ * @author Connor Imes
+ * @date 2026-10-15
+ */
+#ifndef _CPUFREQ_BINDINGS_POOL_H_
+#define _CPUFREQ_BINDINGS_POOL_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <inttypes.h>
+#include "cpufreq-bindings.h"
+
+typedef struct cpufreq_bindings_pool cpufreq_bindings_pool;
+
+typedef struct cpufreq_bindings_write {
+  uint32_t core;
+  // "scaling_max_freq", "scaling_min_freq", or "scaling_setspeed"
+  cpufreq_bindings_file file;
+  uint32_t val;
+} cpufreq_bindings_write;
+
+/**
+ * Create a pool and start its worker threads.
+ *
+ * @param ctx
+ *  The context must outlive the pool
+ * @param nthreads
+ *  The number of worker threads - the calling thread also does work during an apply, so 0 is valid
+ * @return the pool, or NULL on failure (errno will be set)
+ */
+cpufreq_bindings_pool* cpufreq_bindings_pool_init(cpufreq_bindings_ctx* ctx, uint32_t nthreads);
+
+/**
+ * Stop the worker threads and free the pool.
+ *
+ * @param pool
+ * @return 0 on success, or -1 on failure (errno will be set)
+ */
+int cpufreq_bindings_pool_destroy(cpufreq_bindings_pool* pool);
+
+/**
+ * Apply a list of writes in parallel and wait for them to complete.
+ * Writes to cores in the same policy are applied by one thread, in the order given, through the policy's
+ * representative core.
+ * Consecutive writes within a policy to the same file are collapsed so that the file is written once with the last
+ * value, e.g., setting "scaling_max_freq" for every core writes it once per policy.
+ * Writes to cores whose policy is unknown are grouped by core instead.
+ * Write coalescing (cpufreq_bindings_ctx_set_write_coalescing) does not apply.
+ * Concurrent calls on the same pool are serialized.
+ *
+ * @param pool
+ * @param writes
+ * @param nwrites
+ *  The length of the "writes" and "status" arrays
+ * @param status
+ *  The array to be written to - status[i] is 0 if writes[i] was applied (possibly collapsed into a later write with
+ *  the same value), ECANCELED if it was collapsed into a later write with a different value, or an errno value on
+ *  failure
+ * @return the number of writes applied successfully
+ */
+uint32_t cpufreq_bindings_pool_apply(cpufreq_bindings_pool* pool, const cpufreq_bindings_write* writes,
+                                     uint32_t nwrites, int* status);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
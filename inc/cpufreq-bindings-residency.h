@@ -0,0 +1,86 @@
+/**
+ * Frequency residency snapshots from "stats/time_in_state" and "stats/total_trans" for a context's cores, and deltas
+ * between them, e.g., to see how long each core spent at each frequency over an interval.
+ *
+ * Snapshots are preallocated, so taking one doesn't allocate.
+ * The files are per-policy, so a snapshot reads them once per policy using the context's cached file descriptors and
+ * copies the values to the policy's other cores.
+ *
+ * @author Connor Imes
+ * @date 2026-10-15
+ */
+#ifndef _CPUFREQ_BINDINGS_RESIDENCY_H_
+#define _CPUFREQ_BINDINGS_RESIDENCY_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <inttypes.h>
+#include "cpufreq-bindings.h"
+
+typedef struct cpufreq_bindings_residency {
+  uint32_t ncores;
+  // the maximum number of frequencies per core
+  uint32_t nstates_max;
+  // per core, the number of frequencies (0 if the core's statistics couldn't be read)
+  uint32_t* nstates;
+  // per core, starting at index (core * nstates_max): the frequencies and the time at each, in units of 10 ms
+  uint32_t* freqs;
+  uint64_t* times;
+  // per core, the number of frequency transitions
+  uint32_t* total_trans;
+  // per core, 0 or an errno value
+  int* status;
+  // when the snapshot was taken (CLOCK_MONOTONIC), or for a delta, the time between snapshots
+  uint64_t timestamp_ns;
+} cpufreq_bindings_residency;
+
+/**
+ * Allocate a snapshot.
+ *
+ * @param ncores
+ *  The number of cores, must be > 0
+ * @param nstates_max
+ *  The maximum number of frequencies per core, must be > 0
+ * @return the snapshot, or NULL on failure (errno will be set)
+ */
+cpufreq_bindings_residency* cpufreq_bindings_residency_alloc(uint32_t ncores, uint32_t nstates_max);
+
+/**
+ * Free a snapshot.
+ *
+ * @param r
+ */
+void cpufreq_bindings_residency_free(cpufreq_bindings_residency* r);
+
+/**
+ * Take a snapshot for cores 0 through min(ncores) - 1 of the context and snapshot.
+ * Failures for individual cores are reported in the "status" array, not through errno.
+ *
+ * @param ctx
+ * @param r
+ * @return the number of cores read successfully
+ */
+uint32_t cpufreq_bindings_ctx_get_residency(cpufreq_bindings_ctx* ctx, cpufreq_bindings_residency* r);
+
+/**
+ * Compute the time spent at each frequency and the number of transitions between two snapshots.
+ * Frequencies are matched by value, so a core's frequencies may change between snapshots, and counters that went
+ * backward (e.g., after a write to "stats/reset") are treated as having restarted from 0.
+ * A core's delta fails with the "before" or "after" status if either failed.
+ *
+ * @param before
+ * @param after
+ * @param delta
+ *  Written to - may be the same as "after"
+ * @return 0 on success, or -1 on failure (errno will be set - EINVAL if the snapshots' sizes differ)
+ */
+int cpufreq_bindings_residency_delta(const cpufreq_bindings_residency* before, const cpufreq_bindings_residency* after,
+                                     cpufreq_bindings_residency* delta);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
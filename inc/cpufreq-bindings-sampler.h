@@ -0,0 +1,140 @@
+/**
+ * Background sampling of core frequencies.
+ * A sampler thread periodically reads "scaling_cur_freq" (and optionally "cpuinfo_cur_freq") for a set of cores and
+ * publishes timestamped samples to a ring buffer.
+ * The ring has a single producer (the sampler thread) and any number of consumers, each with its own cursor.
+ * Consumers never block the producer and read samples without locks or system calls.
+ * If a consumer falls more than the ring capacity behind, the oldest samples are lost to it.
+ *
+ * @author Connor Imes
+ * @date 2026-10-15
+ */
+#ifndef _CPUFREQ_BINDINGS_SAMPLER_H_
+#define _CPUFREQ_BINDINGS_SAMPLER_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <inttypes.h>
+#include "cpufreq-bindings.h"
+
+// also sample "cpuinfo_cur_freq" (usually requires privileges)
+#define CPUFREQ_BINDINGS_SAMPLER_CPUINFO_CUR_FREQ 0x1
+
+typedef struct cpufreq_bindings_sampler cpufreq_bindings_sampler;
+
+typedef struct cpufreq_bindings_sampler_stats {
+  // samples published
+  uint64_t samples;
+  // samples taken more than 10% of a period after their deadline
+  uint64_t late;
+  // periods skipped entirely because the sampler fell behind by more than a period
+  uint64_t dropped;
+  // individual file reads that failed (values are published as 0)
+  uint64_t errors;
+  // sum and maximum of how long after their deadlines samples were taken
+  uint64_t lateness_ns_total;
+  uint64_t lateness_ns_max;
+} cpufreq_bindings_sampler_stats;
+
+typedef struct cpufreq_bindings_sampler_cursor {
+  // the sequence number of the next sample to read (samples are numbered from 1)
+  uint64_t next;
+  // samples that were overwritten before this cursor read them
+  uint64_t lost;
+} cpufreq_bindings_sampler_cursor;
+
+/**
+ * Create a sampler - it is not started.
+ *
+ * @param ctx
+ *  The context must outlive the sampler
+ * @param cores
+ *  The cores to sample (the array is copied)
+ * @param ncores
+ *  The length of the "cores" array
+ * @param period_ns
+ *  The sampling period, e.g., 1000000 for 1 kHz
+ * @param capacity
+ *  The number of samples the ring holds (rounded up to a power of 2)
+ * @param flags
+ *  0, or CPUFREQ_BINDINGS_SAMPLER_CPUINFO_CUR_FREQ
+ * @return the sampler, or NULL on failure (errno will be set)
+ */
+cpufreq_bindings_sampler* cpufreq_bindings_sampler_init(cpufreq_bindings_ctx* ctx, const uint32_t* cores,
+                                                        uint32_t ncores, uint64_t period_ns, uint32_t capacity,
+                                                        int flags);
+
+/**
+ * Stop the sampler if it is running and free it.
+ *
+ * @param sampler
+ */
+void cpufreq_bindings_sampler_destroy(cpufreq_bindings_sampler* sampler);
+
+/**
+ * Start the sampler thread.
+ *
+ * @param sampler
+ * @return 0 on success, or -1 on failure (errno will be set)
+ */
+int cpufreq_bindings_sampler_start(cpufreq_bindings_sampler* sampler);
+
+/**
+ * Stop the sampler thread and wait for it to exit.
+ *
+ * @param sampler
+ * @return 0 on success, or -1 on failure (errno will be set)
+ */
+int cpufreq_bindings_sampler_stop(cpufreq_bindings_sampler* sampler);
+
+/**
+ * Get the sampler's statistics (may be called while the sampler is running).
+ *
+ * @param sampler
+ * @param stats
+ */
+void cpufreq_bindings_sampler_get_stats(const cpufreq_bindings_sampler* sampler,
+                                        cpufreq_bindings_sampler_stats* stats);
+
+/**
+ * Get the number of values in each sample: the number of cores, times 2 if "cpuinfo_cur_freq" is also sampled.
+ *
+ * @param sampler
+ * @return the number of values
+ */
+uint32_t cpufreq_bindings_sampler_get_nvals(const cpufreq_bindings_sampler* sampler);
+
+/**
+ * Initialize a consumer cursor.
+ *
+ * @param sampler
+ * @param cursor
+ * @param latest
+ *  If non-zero, start from the most recent sample, otherwise from the oldest sample still in the ring
+ */
+void cpufreq_bindings_sampler_cursor_init(const cpufreq_bindings_sampler* sampler,
+                                          cpufreq_bindings_sampler_cursor* cursor, int latest);
+
+/**
+ * Read the next sample for a cursor.
+ * Lock-free and wait-free with respect to the producer; never makes system calls.
+ *
+ * @param sampler
+ * @param cursor
+ * @param timestamp_ns
+ *  Written to with the CLOCK_MONOTONIC time the sample was taken
+ * @param vals
+ *  The array to be written to, of length cpufreq_bindings_sampler_get_nvals(sampler) - for core index i in the
+ *  "cores" array given at init, vals[i] is "scaling_cur_freq" and, if sampled, vals[ncores + i] is "cpuinfo_cur_freq"
+ * @return 1 if a sample was read, or 0 if no new sample is available
+ */
+int cpufreq_bindings_sampler_read(const cpufreq_bindings_sampler* sampler, cpufreq_bindings_sampler_cursor* cursor,
+                                  uint64_t* timestamp_ns, uint32_t* vals);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,121 @@
+/**
+ * Share per-core cpufreq state between processes through POSIX shared memory.
+ * A publisher periodically reads "scaling_cur_freq", "scaling_min_freq", "scaling_max_freq", and "scaling_governor"
+ * for each core and writes them to a shared memory table under a sequence lock.
+ * Any number of reader processes map the table read-only and take consistent snapshots without system calls.
+ *
+ * @author Connor Imes
+ * @date 2026-10-15
+ */
+#ifndef _CPUFREQ_BINDINGS_SHM_H_
+#define _CPUFREQ_BINDINGS_SHM_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <inttypes.h>
+#include "cpufreq-bindings.h"
+
+#define CPUFREQ_BINDINGS_SHM_DEFAULT_NAME "/cpufreq-bindings"
+
+#define CPUFREQ_BINDINGS_SHM_GOVERNOR_LEN 32
+
+/**
+ * Per-core state - exactly one cache line.
+ * Values are 0 (or an empty governor) if they could not be read.
+ */
+typedef struct cpufreq_bindings_shm_entry {
+  uint32_t scaling_cur_freq;
+  uint32_t scaling_min_freq;
+  uint32_t scaling_max_freq;
+  uint32_t reserved0;
+  char scaling_governor[CPUFREQ_BINDINGS_SHM_GOVERNOR_LEN];
+  uint64_t reserved1[2];
+} cpufreq_bindings_shm_entry;
+
+typedef struct cpufreq_bindings_shm_publisher cpufreq_bindings_shm_publisher;
+
+typedef struct cpufreq_bindings_shm_reader cpufreq_bindings_shm_reader;
+
+/**
+ * Create (or replace) a shared memory table for cores 0 through ncores - 1 of a context.
+ * An existing table with the same name is marked stale and unlinked, not modified, so readers that have it mapped
+ * get ESTALE from cpufreq_bindings_shm_reader_snapshot and must re-open.
+ *
+ * @param name
+ *  The shared memory object name, e.g., CPUFREQ_BINDINGS_SHM_DEFAULT_NAME
+ * @param ctx
+ *  The context must outlive the publisher
+ * @param ncores
+ *  Must be <= cpufreq_bindings_ctx_get_ncores(ctx)
+ * @return the publisher, or NULL on failure (errno will be set)
+ */
+cpufreq_bindings_shm_publisher* cpufreq_bindings_shm_publisher_init(const char* name, cpufreq_bindings_ctx* ctx,
+                                                                    uint32_t ncores);
+
+/**
+ * Read current values and publish them.
+ * Files are read once per cpufreq policy when policies can be discovered, otherwise once per core.
+ *
+ * @param pub
+ * @return the number of cores with all values read successfully, or 0 on failure (errno will be set)
+ */
+uint32_t cpufreq_bindings_shm_publisher_update(cpufreq_bindings_shm_publisher* pub);
+
+/**
+ * Unmap the table and free the publisher.
+ *
+ * @param pub
+ * @param unlink
+ *  If non-zero, also remove the shared memory object
+ * @return 0 on success, or -1 on failure (errno will be set)
+ */
+int cpufreq_bindings_shm_publisher_destroy(cpufreq_bindings_shm_publisher* pub, int unlink);
+
+/**
+ * Map a published table read-only.
+ *
+ * @param name
+ * @return the reader, or NULL on failure (errno will be set)
+ */
+cpufreq_bindings_shm_reader* cpufreq_bindings_shm_reader_open(const char* name);
+
+/**
+ * Unmap the table and free the reader.
+ *
+ * @param reader
+ * @return 0 on success, or -1 on failure (errno will be set)
+ */
+int cpufreq_bindings_shm_reader_close(cpufreq_bindings_shm_reader* reader);
+
+/**
+ * Get the number of cores in the table.
+ *
+ * @param reader
+ * @return the number of cores
+ */
+uint32_t cpufreq_bindings_shm_reader_get_ncores(const cpufreq_bindings_shm_reader* reader);
+
+/**
+ * Copy a consistent snapshot of the table, without system calls.
+ *
+ * @param reader
+ * @param entries
+ *  The array to be written to - entries[i] is core i
+ * @param len
+ *  The length of the "entries" array - must be >= cpufreq_bindings_shm_reader_get_ncores(reader)
+ * @param update_ns
+ *  Written to with the CLOCK_MONOTONIC time of the update, or 0 if nothing has been published yet
+ * @return the number of entries copied, or 0 on failure (errno will be set - EAGAIN if a consistent snapshot could not
+ *  be taken, e.g., if the publisher died while updating, or ESTALE if the table was replaced and must be re-opened)
+ */
+uint32_t cpufreq_bindings_shm_reader_snapshot(const cpufreq_bindings_shm_reader* reader,
+                                              cpufreq_bindings_shm_entry* entries, uint32_t len,
+                                              uint64_t* update_ns);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
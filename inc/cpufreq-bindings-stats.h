@@ -0,0 +1,81 @@
+/**
+ * Hot-path instrumentation: system call counts and per-file latency histograms.
+ * Counters are process-wide and shared by all contexts and threads.
+ *
+ * Instrumentation is compiled in only when the library is built with the CPUFREQ_BINDINGS_STATS CMake option.
+ * Otherwise, the functions here fail with ENOTSUP and the library's I/O paths carry no overhead.
+ *
+ * @author Connor Imes
+ * @date 2026-10-15
+ */
+#ifndef _CPUFREQ_BINDINGS_STATS_H_
+#define _CPUFREQ_BINDINGS_STATS_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <inttypes.h>
+#include "cpufreq-bindings.h"
+
+// the size of the per-file array, which is indexed by cpufreq_bindings_file
+#define CPUFREQ_BINDINGS_STATS_MAX_FILES 32
+#define CPUFREQ_BINDINGS_STATS_HIST_BUCKETS 32
+
+typedef struct cpufreq_bindings_file_stats {
+  // completed reads and writes, including failures
+  uint64_t reads;
+  uint64_t writes;
+  // reads and writes that failed
+  uint64_t errors;
+  // the total time of timed reads and writes (those batched through io_uring are counted but not timed)
+  uint64_t latency_ns;
+  // hist[0] counts latencies < 2 ns, hist[i] counts latencies in [2^i, 2^(i+1)) ns, the last bucket also counts longer
+  uint64_t hist[CPUFREQ_BINDINGS_STATS_HIST_BUCKETS];
+} cpufreq_bindings_file_stats;
+
+typedef struct cpufreq_bindings_stats {
+  // system calls
+  uint64_t opens;
+  uint64_t preads;
+  uint64_t pwrites;
+  uint64_t closes;
+  // of "opens", those made for a single read or write because no file descriptor was provided
+  uint64_t opens_per_call;
+  // io_uring submissions, each of which may carry many reads or writes
+  uint64_t uring_submits;
+  // reads and writes submitted through io_uring, which aren't counted in "preads" and "pwrites"
+  uint64_t uring_reads;
+  uint64_t uring_writes;
+  // file contents that could not be parsed
+  uint64_t parse_errors;
+  // coalesced writes that were dropped because the value was already set
+  uint64_t writes_elided;
+  // coalesced writes that were deferred by rate limiting
+  uint64_t writes_deferred;
+  cpufreq_bindings_file_stats files[CPUFREQ_BINDINGS_STATS_MAX_FILES];
+} cpufreq_bindings_stats;
+
+/**
+ * Get a snapshot of the counters.
+ * Each counter is read atomically, but the snapshot as a whole is not, so counters may be skewed by operations that
+ * complete during the call.
+ *
+ * @param stats
+ *  The struct to be written to
+ * @return 0 on success, or -1 on failure (errno will be set - ENOTSUP if instrumentation is not compiled in)
+ */
+int cpufreq_bindings_stats_get(cpufreq_bindings_stats* stats);
+
+/**
+ * Reset all counters to zero.
+ *
+ * @return 0 on success, or -1 on failure (errno will be set - ENOTSUP if instrumentation is not compiled in)
+ */
+int cpufreq_bindings_stats_reset(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,189 @@
+/**
+ * Group a context's cores by CPU topology - package, cluster, NUMA node, or core type - and read or write cpufreq
+ * files for a whole group with the minimum number of policy writes.
+ *
+ * The index combines cpufreq policies ("related_cpus") with "/sys/devices/system/cpu/cpu<N>/topology" and
+ * "/sys/devices/system/node".
+ * It's built from shared lists ("package_cpus_list", "cluster_cpus_list", and each node's "cpulist"), so building it
+ * reads a few files per group rather than per core.
+ * After CPU hotplug, cpufreq_bindings_topology_refresh re-reads only the cores that came online.
+ *
+ * Group IDs are the kernel's for packages ("physical_package_id"), clusters ("cluster_id"), and NUMA nodes.
+ * Core types are numbered from 0, the highest capacity, using "/sys/devices/cpu_core" and "/sys/devices/cpu_atom" on
+ * hybrid Intel systems, or each core's "cpu_capacity" (e.g., on ARM big.LITTLE) - otherwise all cores are type 0.
+ * Offline cores don't belong to any group.
+ *
+ * A topology may be queried and written concurrently, but not while it's being refreshed.
+ *
+ * @author Connor Imes
+ * @date 2026-10-15
+ */
+#ifndef _CPUFREQ_BINDINGS_TOPOLOGY_H_
+#define _CPUFREQ_BINDINGS_TOPOLOGY_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <inttypes.h>
+#include "cpufreq-bindings.h"
+
+typedef enum cpufreq_bindings_topology_level {
+  CPUFREQ_BINDINGS_TOPOLOGY_PACKAGE = 0,
+  // falls back to the package when the kernel doesn't report clusters
+  CPUFREQ_BINDINGS_TOPOLOGY_CLUSTER,
+  // all cores are in node 0 when the kernel isn't built with NUMA support
+  CPUFREQ_BINDINGS_TOPOLOGY_NODE,
+  CPUFREQ_BINDINGS_TOPOLOGY_CORE_TYPE
+} cpufreq_bindings_topology_level;
+
+#define CPUFREQ_BINDINGS_TOPOLOGY_LEVEL_COUNT (CPUFREQ_BINDINGS_TOPOLOGY_CORE_TYPE + 1)
+
+typedef struct cpufreq_bindings_topology cpufreq_bindings_topology;
+
+/**
+ * Build a topology index for a context's cores, discovering the context's policies if necessary.
+ * The context must outlive the topology.
+ *
+ * @param ctx
+ * @return the topology, or NULL on failure (errno will be set)
+ */
+cpufreq_bindings_topology* cpufreq_bindings_topology_init(cpufreq_bindings_ctx* ctx);
+
+/**
+ * Destroy a topology index.
+ *
+ * @param topo
+ */
+void cpufreq_bindings_topology_destroy(cpufreq_bindings_topology* topo);
+
+/**
+ * Update the index after CPU hotplug: re-read "/sys/devices/system/cpu/online", read the topology of cores that came
+ * online, rediscover the context's policies (see cpufreq_bindings_ctx_refresh_policies), and regroup.
+ * Other users of the context may keep running (see cpufreq_bindings_ctx_refresh_policies).
+ * This topology must not be used concurrently with its own refresh.
+ * On failure, the previous index remains usable.
+ *
+ * @param topo
+ * @return 0 on success, or -1 on failure (errno will be set)
+ */
+int cpufreq_bindings_topology_refresh(cpufreq_bindings_topology* topo);
+
+/**
+ * Get the IDs of the groups at a topology level.
+ *
+ * @param topo
+ * @param level
+ * @param groups
+ *  The array to be written to, in ascending order
+ * @param len
+ *  The length of the "groups" array
+ * @return the number of groups, or 0 on failure (errno will be set)
+ */
+uint32_t cpufreq_bindings_topology_get_groups(const cpufreq_bindings_topology* topo,
+                                              cpufreq_bindings_topology_level level, uint32_t* groups, uint32_t len);
+
+/**
+ * Get the group that a core belongs to at a topology level.
+ *
+ * @param topo
+ * @param core
+ * @param level
+ * @param group
+ *  Written to on success
+ * @return 0 on success, or -1 on failure (errno will be set - EINVAL if the core is offline or not in the context)
+ */
+int cpufreq_bindings_topology_get_core_group(const cpufreq_bindings_topology* topo, uint32_t core,
+                                             cpufreq_bindings_topology_level level, uint32_t* group);
+
+/**
+ * Get the online cores in a group.
+ *
+ * @param topo
+ * @param level
+ * @param group
+ * @param cpus
+ *  The array to be written to, in ascending order
+ * @param len
+ *  The length of the "cpus" array
+ * @return the number of cores, or 0 on failure (errno will be set)
+ */
+uint32_t cpufreq_bindings_topology_get_group_cpus(const cpufreq_bindings_topology* topo,
+                                                  cpufreq_bindings_topology_level level, uint32_t group,
+                                                  uint32_t* cpus, uint32_t len);
+
+/**
+ * Get the policies that a group's cores belong to - the writes needed to change the whole group.
+ * A policy that spans groups (e.g., a package-wide policy split into clusters) is included in each of them.
+ *
+ * @param topo
+ * @param level
+ * @param group
+ * @param policies
+ *  The array to be written to, in ascending order
+ * @param len
+ *  The length of the "policies" array
+ * @return the number of policies, or 0 on failure (errno will be set)
+ */
+uint32_t cpufreq_bindings_topology_get_group_policies(const cpufreq_bindings_topology* topo,
+                                                      cpufreq_bindings_topology_level level, uint32_t group,
+                                                      uint32_t* policies, uint32_t len);
+
+/**
+ * Read a single-valued file (e.g., "scaling_cur_freq") once for each of a group's policies.
+ * Reads are submitted with io_uring when available, like cpufreq_bindings_ctx_get_u32_batch.
+ *
+ * @param topo
+ * @param level
+ * @param group
+ * @param file
+ * @param vals
+ *  The array to be written to, in the order of cpufreq_bindings_topology_get_group_policies
+ * @param status
+ *  The array to be written to with the result of each read: 0 on success, or an errno value
+ * @param len
+ *  The length of the "vals" and "status" arrays
+ * @return the number of policies read successfully, or 0 on failure (errno will be set - ERANGE if the arrays are
+ *  too short for the group's policies)
+ */
+uint32_t cpufreq_bindings_topology_get_u32(cpufreq_bindings_topology* topo, cpufreq_bindings_topology_level level,
+                                           uint32_t group, cpufreq_bindings_file file, uint32_t* vals, int* status,
+                                           uint32_t len);
+
+/**
+ * Write a single-valued file once for each of a group's policies.
+ * Supported files are: "scaling_max_freq", "scaling_min_freq", and "scaling_setspeed".
+ * Writes are submitted with io_uring when available, like cpufreq_bindings_ctx_set_u32_batch.
+ *
+ * @param topo
+ * @param level
+ * @param group
+ * @param file
+ * @param val
+ * @return the number of policies written successfully, or 0 on failure (errno will be set - if only some writes
+ *  failed, errno is set to the first failure's error)
+ */
+uint32_t cpufreq_bindings_topology_set_u32(cpufreq_bindings_topology* topo, cpufreq_bindings_topology_level level,
+                                           uint32_t group, cpufreq_bindings_file file, uint32_t val);
+
+/**
+ * Write a string file once for each of a group's policies.
+ * Supported files are: "scaling_governor" and "energy_performance_preference".
+ *
+ * @param topo
+ * @param level
+ * @param group
+ * @param file
+ * @param str
+ *  The value to write (NULL-terminated)
+ * @return the number of policies written successfully, or 0 on failure (errno will be set - if only some writes
+ *  failed, errno is set to the first failure's error)
+ */
+uint32_t cpufreq_bindings_topology_set_str(cpufreq_bindings_topology* topo, cpufreq_bindings_topology_level level,
+                                           uint32_t group, cpufreq_bindings_file file, const char* str);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,135 @@
+/**
+ * Record the library's writes (e.g., scaling_setspeed, scaling_max_freq, scaling_governor) to a compact binary trace,
+ * and read traces back for replay (see the cpufreq-bindings-replay utility).
+ *
+ * While tracing, every successful setter write - through the file descriptor, context, batch, or worker pool APIs - is
+ * appended as a fixed-size record to a memory-mapped file, costing a clock read and a 40-byte store per write.
+ * Writes elided by write coalescing are not recorded, since they never reached sysfs.
+ * Tracing is process-wide; records from concurrent threads are appended in the order they're reserved, so timestamps
+ * may be slightly out of order.
+ *
+ * Traces use the recording host's byte order.
+ * A trace whose recorder crashed is still readable: records that were never completed are marked unused.
+ *
+ * @author Connor Imes
+ * @date 2026-10-15
+ */
+#ifndef _CPUFREQ_BINDINGS_TRACE_H_
+#define _CPUFREQ_BINDINGS_TRACE_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <inttypes.h>
+#include "cpufreq-bindings.h"
+
+// "CFBT"
+#define CPUFREQ_BINDINGS_TRACE_MAGIC 0x43464254
+#define CPUFREQ_BINDINGS_TRACE_VERSION 1
+
+#define CPUFREQ_BINDINGS_TRACE_STR_LEN 24
+
+typedef enum cpufreq_bindings_trace_type {
+  // the record was reserved but never completed
+  CPUFREQ_BINDINGS_TRACE_UNUSED = 0,
+  CPUFREQ_BINDINGS_TRACE_U32,
+  CPUFREQ_BINDINGS_TRACE_STR
+} cpufreq_bindings_trace_type;
+
+// one cache line
+typedef struct cpufreq_bindings_trace_header {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t record_size;
+  uint32_t reserved0;
+  // when recording started: CLOCK_MONOTONIC, and CLOCK_REALTIME for correlating with other logs
+  uint64_t start_ns;
+  uint64_t start_realtime_ns;
+  // the number of records the file has room for
+  uint64_t capacity;
+  // the number of records reserved - any beyond the capacity were dropped
+  uint64_t count;
+  uint64_t reserved[2];
+} cpufreq_bindings_trace_header;
+
+typedef struct cpufreq_bindings_trace_record {
+  // relative to the header's start_ns, taken just before the write was issued
+  uint64_t timestamp_ns;
+  uint32_t core;
+  // a cpufreq_bindings_file
+  uint16_t file;
+  // a cpufreq_bindings_trace_type
+  uint8_t type;
+  // for strings, the length written - may exceed CPUFREQ_BINDINGS_TRACE_STR_LEN, in which case "str" is truncated
+  uint8_t len;
+  union {
+    uint32_t u32;
+    // not NULL-terminated
+    char str[CPUFREQ_BINDINGS_TRACE_STR_LEN];
+  } value;
+} cpufreq_bindings_trace_record;
+
+/**
+ * Start recording writes to a new trace file.
+ * The file is sized for "capacity" records up front; writes beyond that are dropped (but counted).
+ * Must not be called concurrently with cpufreq_bindings_trace_stop.
+ *
+ * @param path
+ *  The file to create or truncate
+ * @param capacity
+ *  The maximum number of records, must be > 0
+ * @return 0 on success, -1 on failure (errno will be set - EBUSY if already recording)
+ */
+int cpufreq_bindings_trace_start(const char* path, uint64_t capacity);
+
+/**
+ * Stop recording, waiting for in-progress records, and truncate the file to the records written.
+ *
+ * @param dropped
+ *  If not NULL, the number of writes dropped because the trace was full is written here
+ * @return 0 on success, -1 on failure (errno will be set - EINVAL if not recording)
+ */
+int cpufreq_bindings_trace_stop(uint64_t* dropped);
+
+typedef struct cpufreq_bindings_trace_reader cpufreq_bindings_trace_reader;
+
+/**
+ * Open a trace file for reading.
+ *
+ * @param path
+ * @return the reader, or NULL on failure (errno will be set - EPROTO if the file isn't a compatible trace)
+ */
+cpufreq_bindings_trace_reader* cpufreq_bindings_trace_reader_open(const char* path);
+
+/**
+ * Get a trace's header.
+ *
+ * @param reader
+ * @return the header
+ */
+const cpufreq_bindings_trace_header* cpufreq_bindings_trace_reader_header(const cpufreq_bindings_trace_reader* reader);
+
+/**
+ * Get a trace's records, including any that are CPUFREQ_BINDINGS_TRACE_UNUSED.
+ *
+ * @param reader
+ * @param count
+ *  The number of records is written here
+ * @return the records, in the order they were reserved
+ */
+const cpufreq_bindings_trace_record* cpufreq_bindings_trace_reader_records(const cpufreq_bindings_trace_reader* reader,
+                                                                           uint64_t* count);
+
+/**
+ * Close a trace reader.
+ *
+ * @param reader
+ */
+void cpufreq_bindings_trace_reader_close(cpufreq_bindings_trace_reader* reader);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,120 @@
+/**
+ * Measure frequency transition latency.
+ * "cpuinfo_transition_latency" is often wrong, or reports UINT32_MAX (CPUFREQ_ETERNAL) when unknown.
+ * These functions measure the time from requesting a frequency until a core reports running at it, by writing the
+ * target and then spin-polling "cpuinfo_cur_freq" or "scaling_cur_freq" on cached file descriptors.
+ *
+ * Measuring changes frequency settings, so it usually requires privileges.
+ * The SETSPEED method also requires the "userspace" governor, which cpufreq_bindings_ctx_measure_transitions switches
+ * to if necessary.
+ *
+ * @author Connor Imes
+ * @date 2026-10-15
+ */
+#ifndef _CPUFREQ_BINDINGS_TRANSITION_H_
+#define _CPUFREQ_BINDINGS_TRANSITION_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <inttypes.h>
+#include "cpufreq-bindings.h"
+
+#define CPUFREQ_BINDINGS_TRANSITION_HIST_BUCKETS 32
+
+typedef enum cpufreq_bindings_transition_method {
+  // write "scaling_setspeed"
+  CPUFREQ_BINDINGS_TRANSITION_SETSPEED,
+  // write "scaling_min_freq" and "scaling_max_freq" to the same value
+  CPUFREQ_BINDINGS_TRANSITION_CLAMP
+} cpufreq_bindings_transition_method;
+
+typedef struct cpufreq_bindings_transition_opts {
+  cpufreq_bindings_transition_method method;
+  // CPUFREQ_BINDINGS_FILE_CPUINFO_CUR_FREQ or CPUFREQ_BINDINGS_FILE_SCALING_CUR_FREQ
+  cpufreq_bindings_file poll_file;
+  // a reported frequency within this many KHz of the target counts as reached
+  uint32_t tolerance;
+  // give up waiting for a frequency after this long
+  uint64_t timeout_ns;
+} cpufreq_bindings_transition_opts;
+
+typedef struct cpufreq_bindings_transition_stats {
+  uint32_t from;
+  uint32_t to;
+  // successful measurements
+  uint32_t samples;
+  // measurements where the target (or the starting frequency) was not reached in time
+  uint32_t timeouts;
+  uint64_t min_ns;
+  uint64_t p50_ns;
+  uint64_t p99_ns;
+  uint64_t max_ns;
+  double mean_ns;
+  // hist[0] counts latencies < 1 us, hist[i] counts latencies in [2^(i-1), 2^i) us, the last bucket also counts longer
+  uint32_t hist[CPUFREQ_BINDINGS_TRANSITION_HIST_BUCKETS];
+} cpufreq_bindings_transition_stats;
+
+/**
+ * Set a core's frequency using the given method.
+ * For CLAMP, "scaling_min_freq" and "scaling_max_freq" are written in whichever order keeps min <= max.
+ *
+ * @param ctx
+ * @param core
+ * @param freq
+ * @param method
+ * @return 0 on success, or -1 on failure (errno will be set)
+ */
+int cpufreq_bindings_ctx_transition_set(cpufreq_bindings_ctx* ctx, uint32_t core, uint32_t freq,
+                                        cpufreq_bindings_transition_method method);
+
+/**
+ * Measure a single transition: move to "from" and wait for it to be reported, then time moving to "to".
+ * Failed reads while waiting (e.g., EBUSY) are retried until the timeout.
+ *
+ * @param ctx
+ * @param core
+ * @param from
+ * @param to
+ * @param opts
+ * @param latency_ns
+ *  Written to with the time from starting the write of "to" until it was reported
+ * @return 0 on success, or -1 on failure (errno will be set - ETIMEDOUT if a frequency was not reached in time, or the
+ *  read error if reads were still failing at the timeout)
+ */
+int cpufreq_bindings_ctx_measure_transition(cpufreq_bindings_ctx* ctx, uint32_t core, uint32_t from, uint32_t to,
+                                            const cpufreq_bindings_transition_opts* opts, uint64_t* latency_ns);
+
+/**
+ * Measure transitions between every ordered pair of distinct frequencies.
+ * Each pair is measured "reps" times, interleaved across pairs.
+ * The core's original "scaling_min_freq" and "scaling_max_freq" (CLAMP) or "scaling_setspeed" (SETSPEED) are
+ * restored afterward.
+ * For SETSPEED under another governor, the policy is switched to "userspace" for the measurements, and the original
+ * governor is restored afterward instead.
+ *
+ * @param ctx
+ * @param core
+ * @param freqs
+ *  The frequencies, e.g., from cpufreq_bindings_ctx_get_scaling_available_frequencies
+ * @param nfreqs
+ * @param reps
+ * @param opts
+ * @param stats
+ *  The array to be written to, ordered by "from" and then by "to" (in "freqs" order), skipping each frequency paired
+ *  with itself
+ * @param len
+ *  The length of the "stats" array - must be >= nfreqs * (nfreqs - 1)
+ * @return the number of pairs with at least one successful measurement, or 0 on failure (errno will be set)
+ */
+uint32_t cpufreq_bindings_ctx_measure_transitions(cpufreq_bindings_ctx* ctx, uint32_t core, const uint32_t* freqs,
+                                                  uint32_t nfreqs, uint32_t reps,
+                                                  const cpufreq_bindings_transition_opts* opts,
+                                                  cpufreq_bindings_transition_stats* stats, uint32_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,134 @@
+/**
+ * Change notification for cpufreq files.
+ * A watch tracks a set of (core, file) pairs and invokes a callback when a file's contents change, e.g., when another
+ * tool changes "scaling_max_freq" or "scaling_governor".
+ *
+ * Each file is first registered for POLLPRI notification (sysfs_notify).
+ * Files that don't support it, and files for which a notification hasn't been seen yet, are checked by an adaptive
+ * poller, which backs off while nothing changes and speeds back up when something does.
+ * Once a file delivers a notification, it is no longer polled.
+ *
+ * A watch exposes a single file descriptor that becomes readable when there may be work to do, so it can be added to
+ * an application's own poll/epoll loop, or the application can just block in cpufreq_bindings_watch_dispatch.
+ * A watch is not thread-safe.
+ *
+ * @author Connor Imes
+ * @date 2026-10-15
+ */
+#ifndef _CPUFREQ_BINDINGS_WATCH_H_
+#define _CPUFREQ_BINDINGS_WATCH_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <inttypes.h>
+#include <stddef.h>
+#include "cpufreq-bindings.h"
+
+typedef struct cpufreq_bindings_watch cpufreq_bindings_watch;
+
+/**
+ * A change callback.
+ * It must not add or remove files from the watch.
+ *
+ * @param core
+ * @param file
+ * @param val
+ *  The file's new contents, without a trailing newline
+ * @param arg
+ *  The argument given to cpufreq_bindings_watch_init
+ */
+typedef void (*cpufreq_bindings_watch_cb)(uint32_t core, cpufreq_bindings_file file, const char* val, void* arg);
+
+/**
+ * Create a watch.
+ *
+ * @param cb
+ * @param arg
+ *  Passed to the callback
+ * @param min_interval_ns
+ *  The fastest polling interval, used after a change is detected (0 for the default of 10 ms)
+ * @param max_interval_ns
+ *  The slowest polling interval, reached while nothing changes (0 for the default of 1 s)
+ * @return the watch, or NULL on failure (errno will be set)
+ */
+cpufreq_bindings_watch* cpufreq_bindings_watch_init(cpufreq_bindings_watch_cb cb, void* arg, uint64_t min_interval_ns,
+                                                    uint64_t max_interval_ns);
+
+/**
+ * Stop watching all files, close the file descriptors the watch opened, and free the watch.
+ *
+ * @param watch
+ * @return 0 on success, or -1 on failure (errno will be set)
+ */
+int cpufreq_bindings_watch_destroy(cpufreq_bindings_watch* watch);
+
+/**
+ * Watch a core's file, opening a file descriptor for it with cpufreq_bindings_file_open.
+ * The current contents are read so that only later changes are reported.
+ *
+ * @param watch
+ * @param core
+ * @param file
+ * @return 0 on success, or -1 on failure (errno will be set - EEXIST if the file is already watched)
+ */
+int cpufreq_bindings_watch_add(cpufreq_bindings_watch* watch, uint32_t core, cpufreq_bindings_file file);
+
+/**
+ * Watch a core's file using a file descriptor from cpufreq_bindings_file_open, which remains owned by the caller and
+ * must stay open while it is watched.
+ * Reading the file descriptor elsewhere can consume a notification, causing a change to be noticed only by the
+ * poller - use a file descriptor that isn't also read by other code, or use cpufreq_bindings_watch_add.
+ *
+ * @param watch
+ * @param fd
+ * @param core
+ * @param file
+ * @return 0 on success, or -1 on failure (errno will be set - EEXIST if the file is already watched)
+ */
+int cpufreq_bindings_watch_add_fd(cpufreq_bindings_watch* watch, int fd, uint32_t core, cpufreq_bindings_file file);
+
+/**
+ * Stop watching a core's file.
+ *
+ * @param watch
+ * @param core
+ * @param file
+ * @return 0 on success, or -1 on failure (errno will be set - ENOENT if the file isn't watched)
+ */
+int cpufreq_bindings_watch_remove(cpufreq_bindings_watch* watch, uint32_t core, cpufreq_bindings_file file);
+
+/**
+ * Get a file descriptor that is readable (POLLIN) whenever cpufreq_bindings_watch_dispatch has work to do.
+ * The file descriptor is owned by the watch - do not read or close it.
+ *
+ * @param watch
+ * @return the file descriptor
+ */
+int cpufreq_bindings_watch_get_fd(const cpufreq_bindings_watch* watch);
+
+/**
+ * Wait for notifications or the next poll, then invoke the callback for each file that changed.
+ *
+ * @param watch
+ * @param timeout_ms
+ *  How long to wait - 0 to return immediately (e.g., after the watch's file descriptor is readable), or -1 to wait
+ *  indefinitely
+ * @return the number of changes reported, or -1 on failure (errno will be set - EINTR if interrupted by a signal)
+ */
+int cpufreq_bindings_watch_dispatch(cpufreq_bindings_watch* watch, int timeout_ms);
+
+/**
+ * Get the number of watched files that are currently checked by polling rather than by notification.
+ *
+ * @param watch
+ * @return the number of polled files
+ */
+uint32_t cpufreq_bindings_watch_get_npolled(const cpufreq_bindings_watch* watch);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
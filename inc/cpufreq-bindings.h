@@ -37,9 +37,50 @@ typedef enum cpufreq_bindings_file {
   CPUFREQ_BINDINGS_FILE_SCALING_GOVERNOR,
   CPUFREQ_BINDINGS_FILE_SCALING_MAX_FREQ,
   CPUFREQ_BINDINGS_FILE_SCALING_MIN_FREQ,
-  CPUFREQ_BINDINGS_FILE_SCALING_SETSPEED
+  CPUFREQ_BINDINGS_FILE_SCALING_SETSPEED,
+  CPUFREQ_BINDINGS_FILE_STATS_TIME_IN_STATE,
+  CPUFREQ_BINDINGS_FILE_STATS_TOTAL_TRANS,
+  CPUFREQ_BINDINGS_FILE_STATS_TRANS_TABLE,
+  CPUFREQ_BINDINGS_FILE_BASE_FREQUENCY,
+  CPUFREQ_BINDINGS_FILE_ENERGY_PERFORMANCE_AVAILABLE_PREFERENCES,
+  CPUFREQ_BINDINGS_FILE_ENERGY_PERFORMANCE_PREFERENCE,
+  // global files, which are the same for all cores (the core is ignored)
+  CPUFREQ_BINDINGS_FILE_BOOST,
+  CPUFREQ_BINDINGS_FILE_INTEL_PSTATE_MAX_PERF_PCT,
+  CPUFREQ_BINDINGS_FILE_INTEL_PSTATE_MIN_PERF_PCT,
+  CPUFREQ_BINDINGS_FILE_INTEL_PSTATE_NO_TURBO
 } cpufreq_bindings_file;
 
+/**
+ * Set the sysfs mount point that all paths are relative to, e.g., to use a synthetic tree for testing.
+ * Only affects files opened afterward - should be called before opening files or creating contexts, and not
+ * concurrently with other functions.
+ *
+ * @param root
+ *  The sysfs root directory, or NULL to restore the default ("/sys")
+ * @return 0 on success, or -1 on failure (errno will be set)
+ */
+int cpufreq_bindings_set_sysfs_root(const char* root);
+
+/**
+ * Get the sysfs mount point that all paths are relative to.
+ *
+ * @return the sysfs root directory
+ */
+const char* cpufreq_bindings_get_sysfs_root(void);
+
+/**
+ * Parse a CPU list like "0-3,8,10-11" (the format of sysfs "*_list" files) into sorted, unique cores.
+ *
+ * @param str
+ * @param cpus
+ *  The array to be written to
+ * @param len
+ *  The length of the "cpus" array, which must also have room for any duplicate cores in "str"
+ * @return the number of cores, or 0 on failure (errno will be set)
+ */
+uint32_t cpufreq_bindings_parse_cpulist(const char* str, uint32_t* cpus, uint32_t len);
+
 /**
  * Open a file (presumably so the file descriptor can be cached/reused).
  *
@@ -51,6 +92,18 @@ typedef enum cpufreq_bindings_file {
  */
 int cpufreq_bindings_file_open(uint32_t core, cpufreq_bindings_file file, int flags);
 
+/**
+ * Open a policy file in "<sysfs root>/devices/system/cpu/cpufreq/policy<policy>/".
+ * A policy is a group of cores that share frequency settings - writing a policy file affects all of its cores.
+ *
+ * @param policy
+ * @param file
+ * @param flags
+ *  Usually O_RDONLY or O_RDWR; if < 0, open flags are chosen automatically
+ * @return the file descriptor, or -1 on error (errno will be set)
+ */
+int cpufreq_bindings_policy_file_open(uint32_t policy, cpufreq_bindings_file file, int flags);
+
 /**
  * Close a file descriptor.
  *
@@ -249,6 +302,542 @@ ssize_t cpufreq_bindings_set_scaling_min_freq(int fd, uint32_t core, uint32_t fr
  */
 ssize_t cpufreq_bindings_set_scaling_setspeed(int fd, uint32_t core, uint32_t freq);
 
+/*
+ * Statistics in "stats/", which are only present if the kernel is built with CONFIG_CPU_FREQ_STAT.
+ * They are per-policy, so reading them for more than one core in a policy reads the same values.
+ * These files can't be read in chunks, so they are read with a single pread into a stack buffer - files longer than
+ * the buffer (4 KiB) fail with EFBIG.
+ */
+
+/**
+ * Get the time spent at each frequency from "stats/time_in_state".
+ *
+ * @param fd
+ * @param core
+ * @param freqs
+ *  An array of frequencies to be written to
+ * @param times
+ *  An array of times to be written to, in units of 10 ms (USER_HZ)
+ * @param len
+ *  The length of the "freqs" and "times" arrays
+ * @return the number of frequencies found, or 0 on failure (errno will be set)
+ */
+uint32_t cpufreq_bindings_get_stats_time_in_state(int fd, uint32_t core, uint32_t* freqs, uint64_t* times,
+                                                  uint32_t len);
+
+/**
+ * Get the number of frequency transitions from "stats/total_trans".
+ * Since 0 is a valid count, set errno to 0 before calling to distinguish it from failure.
+ *
+ * @param fd
+ * @param core
+ * @return the number of transitions, or 0 on failure (errno will be set)
+ */
+uint32_t cpufreq_bindings_get_stats_total_trans(int fd, uint32_t core);
+
+/**
+ * Get the number of transitions between each pair of frequencies from "stats/trans_table".
+ *
+ * @param fd
+ * @param core
+ * @param freqs
+ *  An array of frequencies to be written to
+ * @param counts
+ *  A 2D array of transition counts to be written to - should be len * len in size; with N frequencies found, the
+ *  count of transitions from freqs[i] to freqs[j] is at counts[i * N + j]
+ * @param len
+ *  The length of the "freqs" array
+ * @return the number of frequencies found, or 0 on failure (errno will be set)
+ */
+uint32_t cpufreq_bindings_get_stats_trans_table(int fd, uint32_t core, uint32_t* freqs, uint32_t* counts,
+                                                uint32_t len);
+
+/*
+ * Performance hints in drivers like "intel_pstate" and "amd-pstate", and global turbo/boost controls.
+ */
+
+/**
+ * Get the guaranteed (non-turbo) frequency specified by "base_frequency".
+ *
+ * @param fd
+ * @param core
+ * @return the frequency on success, or 0 on failure (errno will be set)
+ */
+uint32_t cpufreq_bindings_get_base_frequency(int fd, uint32_t core);
+
+/**
+ * Get the energy-performance preferences specified by "energy_performance_available_preferences".
+ *
+ * @param fd
+ * @param core
+ * @param prefs
+ *  A character buffer to be written to (treated as a 2D char array) - should be len * width in size
+ * @param len
+ *  The number of entries in the "prefs" buffer array
+ * @param width
+ *  the width of each entry in the "prefs" buffer array
+ * @return the number of preferences found, or 0 on failure (errno will be set)
+ */
+uint32_t cpufreq_bindings_get_energy_performance_available_preferences(int fd, uint32_t core, char* prefs, size_t len,
+                                                                       size_t width);
+
+/**
+ * Get the energy-performance preference (EPP) specified by "energy_performance_preference", e.g., "performance" or
+ * "balance_power".
+ *
+ * @param fd
+ * @param core
+ * @param pref
+ * @param len
+ * @return the number of bytes read, or -1 on failure (errno will be set)
+ */
+ssize_t cpufreq_bindings_get_energy_performance_preference(int fd, uint32_t core, char* pref, size_t len);
+
+/**
+ * Set the energy-performance preference (EPP) on "energy_performance_preference".
+ *
+ * @param fd
+ * @param core
+ * @param pref
+ * @param len
+ * @return the number of bytes written, or -1 on failure (errno will be set)
+ */
+ssize_t cpufreq_bindings_set_energy_performance_preference(int fd, uint32_t core, const char* pref, size_t len);
+
+/**
+ * Get whether frequencies above the base frequency are allowed, from the global "cpufreq/boost".
+ * Since 0 is a valid value, set errno to 0 before calling to distinguish it from failure.
+ *
+ * @param fd
+ * @return 1 if boost is enabled, or 0 if disabled or on failure (errno will be set)
+ */
+uint32_t cpufreq_bindings_get_boost(int fd);
+
+/**
+ * Enable or disable boost on the global "cpufreq/boost".
+ *
+ * @param fd
+ * @param enable
+ *  1 to enable, 0 to disable
+ * @return the number of bytes written, or -1 on failure (errno will be set)
+ */
+ssize_t cpufreq_bindings_set_boost(int fd, uint32_t enable);
+
+/**
+ * Get the global "intel_pstate/max_perf_pct": the maximum P-state as a percentage of the maximum supported.
+ *
+ * @param fd
+ * @return the percentage on success, or 0 on failure (errno will be set)
+ */
+uint32_t cpufreq_bindings_get_intel_pstate_max_perf_pct(int fd);
+
+/**
+ * Set the global "intel_pstate/max_perf_pct".
+ *
+ * @param fd
+ * @param pct
+ * @return the number of bytes written, or -1 on failure (errno will be set)
+ */
+ssize_t cpufreq_bindings_set_intel_pstate_max_perf_pct(int fd, uint32_t pct);
+
+/**
+ * Get the global "intel_pstate/min_perf_pct": the minimum P-state as a percentage of the maximum supported.
+ *
+ * @param fd
+ * @return the percentage on success, or 0 on failure (errno will be set)
+ */
+uint32_t cpufreq_bindings_get_intel_pstate_min_perf_pct(int fd);
+
+/**
+ * Set the global "intel_pstate/min_perf_pct".
+ *
+ * @param fd
+ * @param pct
+ * @return the number of bytes written, or -1 on failure (errno will be set)
+ */
+ssize_t cpufreq_bindings_set_intel_pstate_min_perf_pct(int fd, uint32_t pct);
+
+/**
+ * Get whether turbo P-states are disabled, from the global "intel_pstate/no_turbo".
+ * Since 0 is a valid value, set errno to 0 before calling to distinguish it from failure.
+ *
+ * @param fd
+ * @return 1 if turbo is disabled, or 0 if enabled or on failure (errno will be set)
+ */
+uint32_t cpufreq_bindings_get_intel_pstate_no_turbo(int fd);
+
+/**
+ * Disable or enable turbo P-states on the global "intel_pstate/no_turbo".
+ *
+ * @param fd
+ * @param disable
+ *  1 to disable turbo, 0 to enable it
+ * @return the number of bytes written, or -1 on failure (errno will be set)
+ */
+ssize_t cpufreq_bindings_set_intel_pstate_no_turbo(int fd, uint32_t disable);
+
+/*
+ * Context API.
+ * A context lazily opens and caches a file descriptor for each (core, file) pair on first use, then reuses it for all
+ * subsequent calls, avoiding the open/close on every call without requiring callers to manage file descriptors.
+ * Files that can be written are opened O_RDWR if permissions allow, otherwise O_RDONLY.
+ * Opening file descriptors lazily is thread-safe; concurrent use of the same file descriptor follows pread/pwrite rules.
+ * All file descriptors are closed when the context is destroyed.
+ */
+
+typedef struct cpufreq_bindings_ctx cpufreq_bindings_ctx;
+
+/**
+ * Create a context.
+ *
+ * @param ncores
+ *  The number of cores to support (cores 0 through ncores - 1), must be > 0
+ * @return the context, or NULL on failure (errno will be set)
+ */
+cpufreq_bindings_ctx* cpufreq_bindings_ctx_init(uint32_t ncores);
+
+/**
+ * Close all cached file descriptors and free the context.
+ *
+ * @param ctx
+ * @return 0 on success, or -1 if any file descriptor failed to close (errno will be set)
+ */
+int cpufreq_bindings_ctx_destroy(cpufreq_bindings_ctx* ctx);
+
+/**
+ * Get the number of cores supported by the context.
+ *
+ * @param ctx
+ * @return the number of cores
+ */
+uint32_t cpufreq_bindings_ctx_get_ncores(const cpufreq_bindings_ctx* ctx);
+
+/**
+ * Get the cached file descriptor for a core's file, opening it if necessary.
+ * The file descriptor remains owned by the context - do not close it.
+ *
+ * @param ctx
+ * @param core
+ * @param file
+ * @return the file descriptor, or -1 on error (errno will be set)
+ */
+int cpufreq_bindings_ctx_get_fd(cpufreq_bindings_ctx* ctx, uint32_t core, cpufreq_bindings_file file);
+
+/**
+ * Context variants of the functions above - see their counterparts for parameter and return value descriptions.
+ */
+
+uint32_t cpufreq_bindings_ctx_get_affected_cpus(cpufreq_bindings_ctx* ctx, uint32_t core, uint32_t* affected,
+                                                uint32_t len);
+
+uint32_t cpufreq_bindings_ctx_get_bios_limit(cpufreq_bindings_ctx* ctx, uint32_t core);
+
+uint32_t cpufreq_bindings_ctx_get_cpuinfo_cur_freq(cpufreq_bindings_ctx* ctx, uint32_t core);
+
+uint32_t cpufreq_bindings_ctx_get_cpuinfo_max_freq(cpufreq_bindings_ctx* ctx, uint32_t core);
+
+uint32_t cpufreq_bindings_ctx_get_cpuinfo_min_freq(cpufreq_bindings_ctx* ctx, uint32_t core);
+
+uint32_t cpufreq_bindings_ctx_get_cpuinfo_transition_latency(cpufreq_bindings_ctx* ctx, uint32_t core);
+
+uint32_t cpufreq_bindings_ctx_get_related_cpus(cpufreq_bindings_ctx* ctx, uint32_t core, uint32_t* related,
+                                               uint32_t len);
+
+uint32_t cpufreq_bindings_ctx_get_scaling_available_frequencies(cpufreq_bindings_ctx* ctx, uint32_t core,
+                                                                uint32_t* freqs, uint32_t len);
+
+uint32_t cpufreq_bindings_ctx_get_scaling_available_governors(cpufreq_bindings_ctx* ctx, uint32_t core,
+                                                              char* governors, size_t len, size_t width);
+
+uint32_t cpufreq_bindings_ctx_get_scaling_cur_freq(cpufreq_bindings_ctx* ctx, uint32_t core);
+
+ssize_t cpufreq_bindings_ctx_get_scaling_driver(cpufreq_bindings_ctx* ctx, uint32_t core, char* driver, size_t len);
+
+ssize_t cpufreq_bindings_ctx_get_scaling_governor(cpufreq_bindings_ctx* ctx, uint32_t core, char* governor,
+                                                  size_t len);
+
+ssize_t cpufreq_bindings_ctx_set_scaling_governor(cpufreq_bindings_ctx* ctx, uint32_t core, const char* governor,
+                                                  size_t len);
+
+uint32_t cpufreq_bindings_ctx_get_scaling_max_freq(cpufreq_bindings_ctx* ctx, uint32_t core);
+
+ssize_t cpufreq_bindings_ctx_set_scaling_max_freq(cpufreq_bindings_ctx* ctx, uint32_t core, uint32_t freq);
+
+uint32_t cpufreq_bindings_ctx_get_scaling_min_freq(cpufreq_bindings_ctx* ctx, uint32_t core);
+
+ssize_t cpufreq_bindings_ctx_set_scaling_min_freq(cpufreq_bindings_ctx* ctx, uint32_t core, uint32_t freq);
+
+ssize_t cpufreq_bindings_ctx_set_scaling_setspeed(cpufreq_bindings_ctx* ctx, uint32_t core, uint32_t freq);
+
+uint32_t cpufreq_bindings_ctx_get_stats_time_in_state(cpufreq_bindings_ctx* ctx, uint32_t core, uint32_t* freqs,
+                                                      uint64_t* times, uint32_t len);
+
+uint32_t cpufreq_bindings_ctx_get_stats_total_trans(cpufreq_bindings_ctx* ctx, uint32_t core);
+
+uint32_t cpufreq_bindings_ctx_get_stats_trans_table(cpufreq_bindings_ctx* ctx, uint32_t core, uint32_t* freqs,
+                                                    uint32_t* counts, uint32_t len);
+
+uint32_t cpufreq_bindings_ctx_get_base_frequency(cpufreq_bindings_ctx* ctx, uint32_t core);
+
+uint32_t cpufreq_bindings_ctx_get_energy_performance_available_preferences(cpufreq_bindings_ctx* ctx, uint32_t core,
+                                                                           char* prefs, size_t len, size_t width);
+
+ssize_t cpufreq_bindings_ctx_get_energy_performance_preference(cpufreq_bindings_ctx* ctx, uint32_t core, char* pref,
+                                                               size_t len);
+
+ssize_t cpufreq_bindings_ctx_set_energy_performance_preference(cpufreq_bindings_ctx* ctx, uint32_t core,
+                                                               const char* pref, size_t len);
+
+/*
+ * Global files use a single cached file descriptor per context.
+ */
+
+uint32_t cpufreq_bindings_ctx_get_boost(cpufreq_bindings_ctx* ctx);
+
+ssize_t cpufreq_bindings_ctx_set_boost(cpufreq_bindings_ctx* ctx, uint32_t enable);
+
+uint32_t cpufreq_bindings_ctx_get_intel_pstate_max_perf_pct(cpufreq_bindings_ctx* ctx);
+
+ssize_t cpufreq_bindings_ctx_set_intel_pstate_max_perf_pct(cpufreq_bindings_ctx* ctx, uint32_t pct);
+
+uint32_t cpufreq_bindings_ctx_get_intel_pstate_min_perf_pct(cpufreq_bindings_ctx* ctx);
+
+ssize_t cpufreq_bindings_ctx_set_intel_pstate_min_perf_pct(cpufreq_bindings_ctx* ctx, uint32_t pct);
+
+uint32_t cpufreq_bindings_ctx_get_intel_pstate_no_turbo(cpufreq_bindings_ctx* ctx);
+
+ssize_t cpufreq_bindings_ctx_set_intel_pstate_no_turbo(cpufreq_bindings_ctx* ctx, uint32_t disable);
+
+/**
+ * Read a single-valued file (e.g. "scaling_cur_freq") for a set of cores using cached file descriptors.
+ * Supported files are: "bios_limit", "cpuinfo_cur_freq", "cpuinfo_max_freq", "cpuinfo_min_freq",
+ * "cpuinfo_transition_latency", "scaling_cur_freq", "scaling_max_freq", "scaling_min_freq", "scaling_setspeed",
+ * "stats/total_trans", and "base_frequency".
+ * Failures for individual cores are reported in the "status" array, not through errno.
+ * If the library is built with io_uring support and the kernel supports it, all reads in the batch are submitted with a
+ * single system call, otherwise they are performed sequentially with pread.
+ *
+ * @param ctx
+ * @param file
+ * @param cores
+ *  The cores to read
+ * @param ncores
+ *  The length of the "cores", "vals", and "status" arrays
+ * @param vals
+ *  The array to be written to - vals[i] is the value for cores[i], or 0 on failure
+ * @param status
+ *  The array to be written to - status[i] is 0 on success, or an errno value on failure
+ * @return the number of values read successfully (errno is set only if "file" is not supported)
+ */
+uint32_t cpufreq_bindings_ctx_get_u32_batch(cpufreq_bindings_ctx* ctx, cpufreq_bindings_file file,
+                                            const uint32_t* cores, uint32_t ncores, uint32_t* vals, int* status);
+
+/**
+ * Read multiple single-valued files for a set of cores - see cpufreq_bindings_ctx_get_u32_batch.
+ *
+ * @param ctx
+ * @param files
+ * @param nfiles
+ *  The length of the "files" array
+ * @param cores
+ * @param ncores
+ *  The length of the "cores" array
+ * @param vals
+ *  The array to be written to, of length ncores * nfiles - vals[i * nfiles + j] is file "files[j]" for core "cores[i]"
+ * @param status
+ *  The array to be written to, of length ncores * nfiles, indexed like "vals"
+ * @return the number of values read successfully (errno is set only if a file is not supported)
+ */
+uint32_t cpufreq_bindings_ctx_get_u32_batch_multi(cpufreq_bindings_ctx* ctx, const cpufreq_bindings_file* files,
+                                                  uint32_t nfiles, const uint32_t* cores, uint32_t ncores,
+                                                  uint32_t* vals, int* status);
+
+/**
+ * Write a single-valued file (e.g. "scaling_max_freq") for a set of cores using cached file descriptors.
+ * Supported files are: "scaling_max_freq", "scaling_min_freq", and "scaling_setspeed".
+ * Writes are submitted with io_uring when available, like cpufreq_bindings_ctx_get_u32_batch.
+ *
+ * @param ctx
+ * @param file
+ * @param cores
+ *  The cores to write
+ * @param ncores
+ *  The length of the "cores", "vals", and "status" arrays
+ * @param vals
+ *  The values to write - vals[i] is written for cores[i]
+ * @param status
+ *  The array to be written to - status[i] is 0 on success, or an errno value on failure
+ * @return the number of values written successfully (errno is set only if "file" is not supported)
+ */
+uint32_t cpufreq_bindings_ctx_set_u32_batch(cpufreq_bindings_ctx* ctx, cpufreq_bindings_file file,
+                                            const uint32_t* cores, uint32_t ncores, const uint32_t* vals,
+                                            int* status);
+
+/**
+ * Set the energy-performance preference (EPP) for a set of cores using cached file descriptors, e.g., to switch
+ * between "performance" and "balance_power" around latency-critical work.
+ * Writes are submitted with io_uring when available, like cpufreq_bindings_ctx_get_u32_batch.
+ *
+ * @param ctx
+ * @param cores
+ *  The cores to write
+ * @param ncores
+ *  The length of the "cores" and "status" arrays
+ * @param pref
+ *  The preference to write for all cores (NULL-terminated)
+ * @param status
+ *  The array to be written to - status[i] is 0 on success, or an errno value on failure
+ * @return the number of cores written successfully (errno is set only if "pref" is too long)
+ */
+uint32_t cpufreq_bindings_ctx_set_energy_performance_preference_batch(cpufreq_bindings_ctx* ctx, const uint32_t* cores,
+                                                                      uint32_t ncores, const char* pref, int* status);
+
+/**
+ * Enable or disable write coalescing for the context variants of the "scaling_max_freq", "scaling_min_freq", and
+ * "scaling_setspeed" setters.
+ * When enabled, writing the value that was last written for a policy's file (through any of its cores) is elided, and
+ * a new value written sooner than the minimum interval after the previous write is deferred - only the latest deferred
+ * value is kept.
+ * Deferred values are written by cpufreq_bindings_ctx_flush or by a later setter call once the interval has elapsed.
+ * Setters return 0 when a write is elided or deferred.
+ * Other writes through the context (batches, pools, plans, governor changes, etc.) replace the recorded value and any
+ * deferred one, but writes by other processes or through file descriptors aren't seen - disable and re-enable
+ * coalescing to forget previously written values, e.g., after those or after cpufreq_bindings_ctx_refresh_policies.
+ * Not thread-safe with respect to concurrent writes to the same policy.
+ *
+ * @param ctx
+ * @param enable
+ *  0 to disable, otherwise enable (pending values are discarded in either case)
+ * @param min_interval_ns
+ *  The minimum time between writes to a policy's file, or 0 to use its "cpuinfo_transition_latency"
+ * @return 0 on success, or -1 on failure (errno will be set)
+ */
+int cpufreq_bindings_ctx_set_write_coalescing(cpufreq_bindings_ctx* ctx, int enable, uint64_t min_interval_ns);
+
+/**
+ * Write deferred values whose minimum interval has elapsed.
+ * Call periodically when write coalescing is enabled.
+ *
+ * @param ctx
+ * @param force
+ *  If non-zero, write all deferred values regardless of the minimum interval
+ * @return the number of values that remain deferred, or -1 if a write failed (errno will be set)
+ */
+int cpufreq_bindings_ctx_flush(cpufreq_bindings_ctx* ctx, int force);
+
+/**
+ * Enable or disable caching of static attributes for the context variants of the "cpuinfo_max_freq",
+ * "cpuinfo_min_freq", "cpuinfo_transition_latency", "related_cpus", "scaling_available_frequencies",
+ * "scaling_available_governors", and "scaling_driver" getters.
+ * When enabled, these files are read once per policy on first use, and later calls (including those that fail) are
+ * served from memory without system calls.
+ * Getters are thread-safe, but enabling, disabling, and invalidating are not thread-safe with respect to other calls
+ * using the same context.
+ *
+ * @param ctx
+ * @param enable
+ *  0 to disable, otherwise enable (cached values are discarded in either case)
+ * @return 0 on success, or -1 on failure (errno will be set)
+ */
+int cpufreq_bindings_ctx_set_attr_caching(cpufreq_bindings_ctx* ctx, int enable);
+
+/**
+ * Discard cached static attributes so they are read again on next use, e.g., after CPU hotplug.
+ * Call cpufreq_bindings_ctx_refresh_policies first if policy membership may have changed.
+ * Not thread-safe with respect to other calls using the same context.
+ *
+ * @param ctx
+ * @return 0 on success, or -1 on failure (errno will be set)
+ */
+int cpufreq_bindings_ctx_invalidate_attr_cache(cpufreq_bindings_ctx* ctx);
+
+/*
+ * Policy API.
+ * Cores that share a cpufreq policy (see "related_cpus") share the same underlying files, so writing to one core
+ * writes to them all.
+ * Policies are identified by their kernel policy number, and are discovered for the context's cores on first use.
+ */
+
+/**
+ * Rediscover policies, e.g., after CPU hotplug.
+ * Safe to call while other threads use the context: they see either the old or the new policies.
+ * Replaced policies are freed once no call that may be using them is still in progress, so repeated refreshes don't
+ * accumulate memory.
+ *
+ * @param ctx
+ * @return 0 on success, or -1 on failure (errno will be set)
+ */
+int cpufreq_bindings_ctx_refresh_policies(cpufreq_bindings_ctx* ctx);
+
+/**
+ * Get the policies that the context's cores belong to.
+ *
+ * @param ctx
+ * @param policies
+ *  The array to be written to, in ascending order
+ * @param len
+ *  The length of the "policies" array
+ * @return the number of policies, or 0 on failure (errno will be set)
+ */
+uint32_t cpufreq_bindings_ctx_get_policies(cpufreq_bindings_ctx* ctx, uint32_t* policies, uint32_t len);
+
+/**
+ * Get the policy that a core belongs to.
+ *
+ * @param ctx
+ * @param core
+ * @param policy
+ *  Written to on success
+ * @return 0 on success, or -1 on failure (errno will be set)
+ */
+int cpufreq_bindings_ctx_get_core_policy(cpufreq_bindings_ctx* ctx, uint32_t core, uint32_t* policy);
+
+/**
+ * Get the context's cores that belong to a policy.
+ *
+ * @param ctx
+ * @param policy
+ * @param cpus
+ *  The array to be written to, in ascending order
+ * @param len
+ *  The length of the "cpus" array
+ * @return the number of cores, or 0 on failure (errno will be set)
+ */
+uint32_t cpufreq_bindings_ctx_get_policy_cpus(cpufreq_bindings_ctx* ctx, uint32_t policy, uint32_t* cpus,
+                                              uint32_t len);
+
+/**
+ * Get a cached file descriptor for a policy's file, for use with the fd-based functions.
+ * The file descriptor remains owned by the context - do not close it.
+ *
+ * @param ctx
+ * @param policy
+ * @param file
+ * @return the file descriptor, or -1 on error (errno will be set)
+ */
+int cpufreq_bindings_ctx_get_policy_fd(cpufreq_bindings_ctx* ctx, uint32_t policy, cpufreq_bindings_file file);
+
+/**
+ * Like cpufreq_bindings_ctx_set_u32_batch, but requests for cores that share a policy are collapsed into a single
+ * write per policy.
+ * If multiple cores in a policy are given different values, the last one in the "cores" array wins.
+ *
+ * @param ctx
+ * @param file
+ * @param cores
+ * @param ncores
+ * @param vals
+ * @param status
+ *  status[i] is the result of the write to the policy of cores[i], or ECANCELED if a later entry for the same policy
+ *  gave a different value
+ * @return the number of cores whose value was written successfully (errno is set only if "file" is not supported, in
+ *  which case "status" isn't written, or if the policies or memory for the batch couldn't be obtained, in which case
+ *  every status is set to errno)
+ */
+uint32_t cpufreq_bindings_ctx_set_u32_batch_by_policy(cpufreq_bindings_ctx* ctx, cpufreq_bindings_file file,
+                                                      const uint32_t* cores, uint32_t ncores, const uint32_t* vals,
+                                                      int* status);
+
 #ifdef __cplusplus
 }
 #endif
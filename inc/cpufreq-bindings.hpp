@@ -0,0 +1,571 @@
+/**
+ * Optional header-only C++17 interface to cpufreq-bindings.
+ *
+ * Each cpufreq_bindings_file is mapped at compile time to its value kind and access mode (see file_traits), so e.g.
+ * calling set() on a read-only file fails to compile.
+ * Operations return a result, which holds either a value or an errno value, instead of using 0 or -1 as errors.
+ * Variable-length values are read into caller-provided buffers and returned as spans and string views into them.
+ *
+ *   cpufreq::context ctx = cpufreq::context::create(ncores).value();
+ *   cpufreq::result<uint32_t> freq = ctx.at<CPUFREQ_BINDINGS_FILE_SCALING_CUR_FREQ>(core).get();
+ *   char buf[32];
+ *   cpufreq::result<std::string_view> gov = ctx.at<CPUFREQ_BINDINGS_FILE_SCALING_GOVERNOR>(core).get(buf);
+ *
+ * Every operation is an inline call to the corresponding C function, so it compiles to the same code as the C API
+ * (see bench/cpufreq-bindings-hpp-bench.cpp).
+ *
+ * @author Connor Imes
+ * @date 2026-10-15
+ */
+#ifndef _CPUFREQ_BINDINGS_HPP_
+#define _CPUFREQ_BINDINGS_HPP_
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <array>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#if __cplusplus > 201703L && __has_include(<span>)
+#include <span>
+#endif
+#include "cpufreq-bindings.h"
+
+namespace cpufreq {
+
+#if defined(__cpp_lib_span)
+template <class T>
+using span = std::span<T>;
+#else
+/**
+ * A minimal std::span for C++17: a non-owning view of a contiguous sequence.
+ */
+template <class T>
+class span {
+ public:
+  constexpr span() noexcept : data_(nullptr), size_(0) {}
+  constexpr span(T* data, std::size_t size) noexcept : data_(data), size_(size) {}
+  template <std::size_t N>
+  constexpr span(T (&arr)[N]) noexcept : data_(arr), size_(N) {}
+  template <class U, std::size_t N, class = std::enable_if_t<std::is_convertible_v<U (*)[], T (*)[]>>>
+  constexpr span(std::array<U, N>& arr) noexcept : data_(arr.data()), size_(N) {}
+  // containers like std::vector
+  template <class C, class U = std::remove_pointer_t<decltype(std::declval<C&>().data())>,
+            class = decltype(std::declval<C&>().size()),
+            class = std::enable_if_t<!std::is_array_v<C> && std::is_convertible_v<U (*)[], T (*)[]>>>
+  constexpr span(C& c) noexcept : data_(c.data()), size_(c.size()) {}
+
+  constexpr T* data() const noexcept { return data_; }
+  constexpr std::size_t size() const noexcept { return size_; }
+  constexpr bool empty() const noexcept { return size_ == 0; }
+  constexpr T* begin() const noexcept { return data_; }
+  constexpr T* end() const noexcept { return data_ + size_; }
+  constexpr T& operator[](std::size_t i) const noexcept { return data_[i]; }
+  constexpr span first(std::size_t n) const noexcept { return span(data_, n); }
+
+ private:
+  T* data_;
+  std::size_t size_;
+};
+#endif
+
+/**
+ * Tag for constructing a result that holds an error.
+ */
+struct unexpect_t {
+  explicit unexpect_t() = default;
+};
+inline constexpr unexpect_t unexpect{};
+
+/**
+ * Like std::expected<T, int>: either a value or an errno value.
+ */
+template <class T>
+class result {
+ public:
+  using value_type = T;
+
+  constexpr result(const T& value) : value_(value), err_(0) {}
+  constexpr result(T&& value) : value_(std::move(value)), err_(0) {}
+  constexpr result(unexpect_t, int err) : value_(), err_(err) {}
+
+  constexpr bool has_value() const noexcept { return err_ == 0; }
+  constexpr explicit operator bool() const noexcept { return has_value(); }
+  // the value, which must be present
+  constexpr T& operator*() & noexcept { return value_; }
+  constexpr const T& operator*() const& noexcept { return value_; }
+  constexpr T&& operator*() && noexcept { return std::move(value_); }
+  constexpr T* operator->() noexcept { return &value_; }
+  constexpr const T* operator->() const noexcept { return &value_; }
+  // the value, or throws std::system_error (aborts if exceptions are disabled) if there's an error
+  T& value() & {
+    check();
+    return value_;
+  }
+  const T& value() const& {
+    check();
+    return value_;
+  }
+  T&& value() && {
+    check();
+    return std::move(value_);
+  }
+  template <class U>
+  constexpr T value_or(U&& other) const {
+    return has_value() ? value_ : static_cast<T>(std::forward<U>(other));
+  }
+  // the errno value, or 0 if there's a value
+  constexpr int error() const noexcept { return err_; }
+  std::error_code error_code() const noexcept { return std::error_code(err_, std::generic_category()); }
+
+ private:
+  void check() const {
+    if (err_ != 0) {
+#if defined(__cpp_exceptions)
+      throw std::system_error(error_code());
+#else
+      std::abort();
+#endif
+    }
+  }
+
+  T value_;
+  int err_;
+};
+
+template <>
+class result<void> {
+ public:
+  using value_type = void;
+
+  constexpr result() noexcept : err_(0) {}
+  constexpr result(unexpect_t, int err) noexcept : err_(err) {}
+
+  constexpr bool has_value() const noexcept { return err_ == 0; }
+  constexpr explicit operator bool() const noexcept { return has_value(); }
+  void value() const {
+    if (err_ != 0) {
+#if defined(__cpp_exceptions)
+      throw std::system_error(error_code());
+#else
+      std::abort();
+#endif
+    }
+  }
+  constexpr int error() const noexcept { return err_; }
+  std::error_code error_code() const noexcept { return std::error_code(err_, std::generic_category()); }
+
+ private:
+  int err_;
+};
+
+/**
+ * Strings read into a 2D char array (see cpufreq_bindings_get_scaling_available_governors).
+ */
+class string_table {
+ public:
+  constexpr string_table() noexcept : data_(nullptr), size_(0), width_(0) {}
+  constexpr string_table(const char* data, std::size_t size, std::size_t width) noexcept
+    : data_(data), size_(size), width_(width) {}
+
+  constexpr std::size_t size() const noexcept { return size_; }
+  constexpr std::size_t width() const noexcept { return width_; }
+  // entries that fill their width aren't NULL-terminated
+  std::string_view operator[](std::size_t i) const noexcept {
+    const char* s = data_ + i * width_;
+    std::size_t n = 0;
+    while (n < width_ && s[n] != '\0') {
+      n++;
+    }
+    return std::string_view(s, n);
+  }
+
+ private:
+  const char* data_;
+  std::size_t size_;
+  std::size_t width_;
+};
+
+/*
+ * Value kinds
+ */
+
+// a single decimal value
+struct u32_kind {
+  using value_type = std::uint32_t;
+};
+// a list of decimal values, e.g. "related_cpus"
+struct u32_list_kind {
+  using value_type = span<std::uint32_t>;
+};
+// a single string, e.g. "scaling_governor"
+struct string_kind {
+  using value_type = std::string_view;
+};
+// a list of strings, e.g. "scaling_available_governors"
+struct string_list_kind {
+  using value_type = string_table;
+};
+// "stats/time_in_state" and "stats/trans_table" - the value is the number of frequencies
+struct time_in_state_kind {
+  using value_type = std::size_t;
+};
+struct trans_table_kind {
+  using value_type = std::size_t;
+};
+
+/**
+ * Compile-time properties of each file: "kind", "readable", and "writable", and static get/set functions that forward
+ * to the C functions for both file descriptors and contexts.
+ * Files without a specialization can't be used.
+ */
+template <cpufreq_bindings_file F>
+struct file_traits;
+
+template <cpufreq_bindings_file F>
+using file_kind_t = typename file_traits<F>::kind;
+
+template <cpufreq_bindings_file F>
+using file_value_t = typename file_kind_t<F>::value_type;
+
+template <cpufreq_bindings_file F>
+inline constexpr bool is_readable_v = file_traits<F>::readable;
+
+template <cpufreq_bindings_file F>
+inline constexpr bool is_writable_v = file_traits<F>::writable;
+
+#define CPUFREQ_BINDINGS_HPP_GET(name) \
+  template <class... A> \
+  static auto get(int fd, std::uint32_t core, A... a) { return cpufreq_bindings_get_##name(fd, core, a...); } \
+  template <class... A> \
+  static auto get(cpufreq_bindings_ctx* ctx, std::uint32_t core, A... a) { \
+    return cpufreq_bindings_ctx_get_##name(ctx, core, a...); \
+  }
+
+#define CPUFREQ_BINDINGS_HPP_SET(name) \
+  template <class... A> \
+  static auto set(int fd, std::uint32_t core, A... a) { return cpufreq_bindings_set_##name(fd, core, a...); } \
+  template <class... A> \
+  static auto set(cpufreq_bindings_ctx* ctx, std::uint32_t core, A... a) { \
+    return cpufreq_bindings_ctx_set_##name(ctx, core, a...); \
+  }
+
+// global files ignore the core
+#define CPUFREQ_BINDINGS_HPP_GLOBAL(name) \
+  static std::uint32_t get(int fd, std::uint32_t) { return cpufreq_bindings_get_##name(fd); } \
+  static std::uint32_t get(cpufreq_bindings_ctx* ctx, std::uint32_t) { return cpufreq_bindings_ctx_get_##name(ctx); } \
+  static ssize_t set(int fd, std::uint32_t, std::uint32_t v) { return cpufreq_bindings_set_##name(fd, v); } \
+  static ssize_t set(cpufreq_bindings_ctx* ctx, std::uint32_t, std::uint32_t v) { \
+    return cpufreq_bindings_ctx_set_##name(ctx, v); \
+  }
+
+#define CPUFREQ_BINDINGS_HPP_FILE(file, k, r, w, ...) \
+  template <> \
+  struct file_traits<CPUFREQ_BINDINGS_FILE_##file> { \
+    using kind = k; \
+    static constexpr bool readable = r; \
+    static constexpr bool writable = w; \
+    __VA_ARGS__ \
+  };
+
+CPUFREQ_BINDINGS_HPP_FILE(AFFECTED_CPUS, u32_list_kind, true, false, CPUFREQ_BINDINGS_HPP_GET(affected_cpus))
+CPUFREQ_BINDINGS_HPP_FILE(BIOS_LIMIT, u32_kind, true, false, CPUFREQ_BINDINGS_HPP_GET(bios_limit))
+CPUFREQ_BINDINGS_HPP_FILE(CPUINFO_CUR_FREQ, u32_kind, true, false, CPUFREQ_BINDINGS_HPP_GET(cpuinfo_cur_freq))
+CPUFREQ_BINDINGS_HPP_FILE(CPUINFO_MAX_FREQ, u32_kind, true, false, CPUFREQ_BINDINGS_HPP_GET(cpuinfo_max_freq))
+CPUFREQ_BINDINGS_HPP_FILE(CPUINFO_MIN_FREQ, u32_kind, true, false, CPUFREQ_BINDINGS_HPP_GET(cpuinfo_min_freq))
+CPUFREQ_BINDINGS_HPP_FILE(CPUINFO_TRANSITION_LATENCY, u32_kind, true, false,
+                          CPUFREQ_BINDINGS_HPP_GET(cpuinfo_transition_latency))
+CPUFREQ_BINDINGS_HPP_FILE(RELATED_CPUS, u32_list_kind, true, false, CPUFREQ_BINDINGS_HPP_GET(related_cpus))
+CPUFREQ_BINDINGS_HPP_FILE(SCALING_AVAILABLE_FREQUENCIES, u32_list_kind, true, false,
+                          CPUFREQ_BINDINGS_HPP_GET(scaling_available_frequencies))
+CPUFREQ_BINDINGS_HPP_FILE(SCALING_AVAILABLE_GOVERNORS, string_list_kind, true, false,
+                          CPUFREQ_BINDINGS_HPP_GET(scaling_available_governors))
+CPUFREQ_BINDINGS_HPP_FILE(SCALING_CUR_FREQ, u32_kind, true, false, CPUFREQ_BINDINGS_HPP_GET(scaling_cur_freq))
+CPUFREQ_BINDINGS_HPP_FILE(SCALING_DRIVER, string_kind, true, false, CPUFREQ_BINDINGS_HPP_GET(scaling_driver))
+CPUFREQ_BINDINGS_HPP_FILE(SCALING_GOVERNOR, string_kind, true, true, CPUFREQ_BINDINGS_HPP_GET(scaling_governor)
+                          CPUFREQ_BINDINGS_HPP_SET(scaling_governor))
+CPUFREQ_BINDINGS_HPP_FILE(SCALING_MAX_FREQ, u32_kind, true, true, CPUFREQ_BINDINGS_HPP_GET(scaling_max_freq)
+                          CPUFREQ_BINDINGS_HPP_SET(scaling_max_freq))
+CPUFREQ_BINDINGS_HPP_FILE(SCALING_MIN_FREQ, u32_kind, true, true, CPUFREQ_BINDINGS_HPP_GET(scaling_min_freq)
+                          CPUFREQ_BINDINGS_HPP_SET(scaling_min_freq))
+CPUFREQ_BINDINGS_HPP_FILE(SCALING_SETSPEED, u32_kind, false, true, CPUFREQ_BINDINGS_HPP_SET(scaling_setspeed))
+CPUFREQ_BINDINGS_HPP_FILE(STATS_TIME_IN_STATE, time_in_state_kind, true, false,
+                          CPUFREQ_BINDINGS_HPP_GET(stats_time_in_state))
+CPUFREQ_BINDINGS_HPP_FILE(STATS_TOTAL_TRANS, u32_kind, true, false, CPUFREQ_BINDINGS_HPP_GET(stats_total_trans))
+CPUFREQ_BINDINGS_HPP_FILE(STATS_TRANS_TABLE, trans_table_kind, true, false,
+                          CPUFREQ_BINDINGS_HPP_GET(stats_trans_table))
+CPUFREQ_BINDINGS_HPP_FILE(BASE_FREQUENCY, u32_kind, true, false, CPUFREQ_BINDINGS_HPP_GET(base_frequency))
+CPUFREQ_BINDINGS_HPP_FILE(ENERGY_PERFORMANCE_AVAILABLE_PREFERENCES, string_list_kind, true, false,
+                          CPUFREQ_BINDINGS_HPP_GET(energy_performance_available_preferences))
+CPUFREQ_BINDINGS_HPP_FILE(ENERGY_PERFORMANCE_PREFERENCE, string_kind, true, true,
+                          CPUFREQ_BINDINGS_HPP_GET(energy_performance_preference)
+                          CPUFREQ_BINDINGS_HPP_SET(energy_performance_preference))
+CPUFREQ_BINDINGS_HPP_FILE(BOOST, u32_kind, true, true, CPUFREQ_BINDINGS_HPP_GLOBAL(boost))
+CPUFREQ_BINDINGS_HPP_FILE(INTEL_PSTATE_MAX_PERF_PCT, u32_kind, true, true,
+                          CPUFREQ_BINDINGS_HPP_GLOBAL(intel_pstate_max_perf_pct))
+CPUFREQ_BINDINGS_HPP_FILE(INTEL_PSTATE_MIN_PERF_PCT, u32_kind, true, true,
+                          CPUFREQ_BINDINGS_HPP_GLOBAL(intel_pstate_min_perf_pct))
+CPUFREQ_BINDINGS_HPP_FILE(INTEL_PSTATE_NO_TURBO, u32_kind, true, true,
+                          CPUFREQ_BINDINGS_HPP_GLOBAL(intel_pstate_no_turbo))
+
+#undef CPUFREQ_BINDINGS_HPP_FILE
+#undef CPUFREQ_BINDINGS_HPP_GLOBAL
+#undef CPUFREQ_BINDINGS_HPP_SET
+#undef CPUFREQ_BINDINGS_HPP_GET
+
+/**
+ * Typed access to a core's file through a handle: a file descriptor (int) or a context (cpufreq_bindings_ctx*).
+ * The handle isn't owned.
+ * Each get() overload applies only to the file kind it is documented for.
+ */
+template <cpufreq_bindings_file F, class H>
+class basic_file {
+ public:
+  using traits = file_traits<F>;
+  using kind = typename traits::kind;
+
+  constexpr basic_file(H handle, std::uint32_t core) noexcept : handle_(handle), core_(core) {}
+
+  constexpr H handle() const noexcept { return handle_; }
+  constexpr std::uint32_t core() const noexcept { return core_; }
+
+  // u32_kind
+  result<std::uint32_t> get() const {
+    static_assert(std::is_same_v<kind, u32_kind>, "file is not single-valued");
+    static_assert(traits::readable, "file is write-only");
+    // 0 is ambiguous
+    errno = 0;
+    std::uint32_t val = traits::get(handle_, core_);
+    if (val == 0 && errno != 0) {
+      return result<std::uint32_t>(unexpect, errno);
+    }
+    return val;
+  }
+
+  // u32_list_kind: returns the values, a prefix of "out"
+  result<span<std::uint32_t>> get(span<std::uint32_t> out) const {
+    static_assert(std::is_same_v<kind, u32_list_kind>, "file is not a list of values");
+    std::uint32_t n = traits::get(handle_, core_, out.data(), static_cast<std::uint32_t>(out.size()));
+    if (n == 0) {
+      return result<span<std::uint32_t>>(unexpect, errno);
+    }
+    return out.first(n);
+  }
+
+  // string_kind: returns a view into "buf" without the trailing newline
+  result<std::string_view> get(span<char> buf) const {
+    static_assert(std::is_same_v<kind, string_kind>, "file is not a string");
+    std::size_t n = 0;
+    ssize_t ret;
+    if (buf.size() < 2) {
+      return result<std::string_view>(unexpect, EINVAL);
+    }
+    // keep the last character as a terminator
+    buf[buf.size() - 1] = '\0';
+    if ((ret = traits::get(handle_, core_, buf.data(), buf.size() - 1)) < 0) {
+      return result<std::string_view>(unexpect, errno);
+    }
+    while (n < static_cast<std::size_t>(ret) && buf[n] != '\0' && buf[n] != '\n') {
+      n++;
+    }
+    return std::string_view(buf.data(), n);
+  }
+
+  // string_list_kind: "buf" is treated as a 2D char array with entries of "width" characters
+  result<string_table> get(span<char> buf, std::size_t width) const {
+    static_assert(std::is_same_v<kind, string_list_kind>, "file is not a list of strings");
+    std::size_t len = width == 0 ? 0 : buf.size() / width;
+    std::uint32_t n = traits::get(handle_, core_, buf.data(), len, width);
+    if (n == 0) {
+      return result<string_table>(unexpect, errno);
+    }
+    return string_table(buf.data(), n, width);
+  }
+
+  // time_in_state_kind: returns the number of frequencies, with times in units of 10 ms
+  result<std::size_t> get(span<std::uint32_t> freqs, span<std::uint64_t> times) const {
+    static_assert(std::is_same_v<kind, time_in_state_kind>, "file is not \"stats/time_in_state\"");
+    std::size_t len = freqs.size() < times.size() ? freqs.size() : times.size();
+    std::uint32_t n = traits::get(handle_, core_, freqs.data(), times.data(), static_cast<std::uint32_t>(len));
+    if (n == 0) {
+      return result<std::size_t>(unexpect, errno);
+    }
+    return static_cast<std::size_t>(n);
+  }
+
+  // trans_table_kind: returns the number of frequencies N, with counts[from * N + to]
+  result<std::size_t> get(span<std::uint32_t> freqs, span<std::uint32_t> counts) const {
+    static_assert(std::is_same_v<kind, trans_table_kind>, "file is not \"stats/trans_table\"");
+    std::size_t len = freqs.size();
+    while (len * len > counts.size()) {
+      len--;
+    }
+    std::uint32_t n = traits::get(handle_, core_, freqs.data(), counts.data(), static_cast<std::uint32_t>(len));
+    if (n == 0) {
+      return result<std::size_t>(unexpect, errno);
+    }
+    return static_cast<std::size_t>(n);
+  }
+
+  // u32_kind
+  result<void> set(std::uint32_t val) const {
+    static_assert(traits::writable, "file is read-only");
+    static_assert(std::is_same_v<kind, u32_kind>, "file is not single-valued");
+    if (traits::set(handle_, core_, val) < 0) {
+      return result<void>(unexpect, errno);
+    }
+    return result<void>();
+  }
+
+  // string_kind
+  result<void> set(std::string_view val) const {
+    static_assert(traits::writable, "file is read-only");
+    static_assert(std::is_same_v<kind, string_kind>, "file is not a string");
+    if (traits::set(handle_, core_, val.data(), val.size()) < 0) {
+      return result<void>(unexpect, errno);
+    }
+    return result<void>();
+  }
+
+ private:
+  H handle_;
+  std::uint32_t core_;
+};
+
+/**
+ * An owned file descriptor, closed on destruction.
+ */
+class unique_fd {
+ public:
+  constexpr unique_fd() noexcept : fd_(-1) {}
+  constexpr explicit unique_fd(int fd) noexcept : fd_(fd) {}
+  unique_fd(unique_fd&& other) noexcept : fd_(other.release()) {}
+  unique_fd& operator=(unique_fd&& other) noexcept {
+    reset(other.release());
+    return *this;
+  }
+  unique_fd(const unique_fd&) = delete;
+  unique_fd& operator=(const unique_fd&) = delete;
+  ~unique_fd() { reset(); }
+
+  constexpr int get() const noexcept { return fd_; }
+  constexpr explicit operator bool() const noexcept { return fd_ > 0; }
+  int release() noexcept { return std::exchange(fd_, -1); }
+  void reset(int fd = -1) noexcept {
+    if (fd_ > 0) {
+      cpufreq_bindings_file_close(fd_);
+    }
+    fd_ = fd;
+  }
+
+ private:
+  int fd_;
+};
+
+/**
+ * A core's file, opened once and closed on destruction.
+ */
+template <cpufreq_bindings_file F>
+class file : public basic_file<F, int> {
+ public:
+  /**
+   * Open a core's file (see cpufreq_bindings_file_open).
+   *
+   * @param core
+   * @param flags
+   *  The open flags, or -1 to use O_RDWR for writable files and O_RDONLY otherwise
+   */
+  static result<file> open(std::uint32_t core, int flags = -1) {
+    int fd = cpufreq_bindings_file_open(core, F, flags);
+    if (fd < 0) {
+      return result<file>(unexpect, errno);
+    }
+    return file(unique_fd(fd), core);
+  }
+
+  /**
+   * Open a policy's file (see cpufreq_bindings_policy_file_open).
+   */
+  static result<file> open_policy(std::uint32_t policy, int flags = -1) {
+    int fd = cpufreq_bindings_policy_file_open(policy, F, flags);
+    if (fd < 0) {
+      return result<file>(unexpect, errno);
+    }
+    return file(unique_fd(fd), policy);
+  }
+
+  file() noexcept : basic_file<F, int>(-1, 0) {}
+  // the moved-from file is left closed, with a handle of -1 rather than the moved fd
+  file(file&& other) noexcept : basic_file<F, int>(other), fd_(std::move(other.fd_)) { other.clear_handle(); }
+  file& operator=(file&& other) noexcept {
+    if (this != &other) {
+      static_cast<basic_file<F, int>&>(*this) = other;
+      fd_ = std::move(other.fd_);
+      other.clear_handle();
+    }
+    return *this;
+  }
+
+ private:
+  file(unique_fd fd, std::uint32_t core) noexcept : basic_file<F, int>(fd.get(), core), fd_(std::move(fd)) {}
+
+  void clear_handle() noexcept { static_cast<basic_file<F, int>&>(*this) = basic_file<F, int>(-1, this->core()); }
+
+  unique_fd fd_;
+};
+
+/**
+ * An owned context (see cpufreq_bindings_ctx_init), destroyed on destruction.
+ */
+class context {
+ public:
+  static result<context> create(std::uint32_t ncores) {
+    cpufreq_bindings_ctx* ctx = cpufreq_bindings_ctx_init(ncores);
+    if (ctx == nullptr) {
+      return result<context>(unexpect, errno);
+    }
+    return context(ctx);
+  }
+
+  context() noexcept : ctx_(nullptr) {}
+  context(context&& other) noexcept : ctx_(std::exchange(other.ctx_, nullptr)) {}
+  context& operator=(context&& other) noexcept {
+    reset(std::exchange(other.ctx_, nullptr));
+    return *this;
+  }
+  context(const context&) = delete;
+  context& operator=(const context&) = delete;
+  ~context() { reset(); }
+
+  cpufreq_bindings_ctx* get() const noexcept { return ctx_; }
+  explicit operator bool() const noexcept { return ctx_ != nullptr; }
+  std::uint32_t ncores() const noexcept { return cpufreq_bindings_ctx_get_ncores(ctx_); }
+
+  /**
+   * A core's file, using the context's cached file descriptor (and its caching and write coalescing, if enabled).
+   * The view must not outlive the context.
+   */
+  template <cpufreq_bindings_file F>
+  basic_file<F, cpufreq_bindings_ctx*> at(std::uint32_t core) const noexcept {
+    return basic_file<F, cpufreq_bindings_ctx*>(ctx_, core);
+  }
+
+ private:
+  explicit context(cpufreq_bindings_ctx* ctx) noexcept : ctx_(ctx) {}
+
+  void reset(cpufreq_bindings_ctx* ctx = nullptr) noexcept {
+    if (ctx_ != nullptr) {
+      cpufreq_bindings_ctx_destroy(ctx_);
+    }
+    ctx_ = ctx;
+  }
+
+  cpufreq_bindings_ctx* ctx_;
+};
+
+}  // namespace cpufreq
+
+#endif
@@ -0,0 +1,307 @@
+/**
+ * Static attribute caching: read attributes that can't change while the system runs once per policy.
+ *
+ * Entries are filled on first use and published to per-core slots with compare-and-swap, so getters are lock-free.
+ * Cores in the same policy share their representative core's entry.
+ *
+ * @author Connor Imes
+ * @date 2026-10-15
+ */
+// for strnlen
+#define _POSIX_C_SOURCE 200809L
+#include <errno.h>
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+#include "cpufreq-bindings.h"
+#include "cpufreq-bindings-common.h"
+#include "cpufreq-bindings-ctx.h"
+
+// the kernel limits governor and driver names to 16 characters
+#define CACHE_GOVS 32
+#define CACHE_GOV_WIDTH 32
+#define CACHE_STR_LEN 64
+
+// the initial length of array buffers, which grow until the file fits
+#define CACHE_ARR_LEN_MIN 64
+#define CACHE_ARR_LEN_MAX 65536
+
+// cached u32 files, in "u32" order
+#define CACHE_U32_COUNT 3
+
+typedef struct cache_u32arr {
+  uint32_t* vals;
+  uint32_t n;
+  int err;
+} cache_u32arr;
+
+typedef struct cache_entry {
+  // all entries, for freeing
+  struct cache_entry* next;
+  // errors are cached too - "err" is the errno value if a read failed, otherwise 0
+  uint32_t u32[CACHE_U32_COUNT];
+  int u32_err[CACHE_U32_COUNT];
+  cache_u32arr related;
+  cache_u32arr freqs;
+  char governors[CACHE_GOVS][CACHE_GOV_WIDTH];
+  uint32_t ngovernors;
+  int governors_err;
+  char driver[CACHE_STR_LEN];
+  ssize_t driver_len;
+  int driver_err;
+} cache_entry;
+
+struct cpufreq_bindings_attr_cache {
+  // per core, NULL until first use
+  cache_entry** slots;
+  cache_entry* all;
+};
+
+static int cache_u32_index(cpufreq_bindings_file file) {
+  switch (file) {
+    case CPUFREQ_BINDINGS_FILE_CPUINFO_MAX_FREQ:
+      return 0;
+    case CPUFREQ_BINDINGS_FILE_CPUINFO_MIN_FREQ:
+      return 1;
+    case CPUFREQ_BINDINGS_FILE_CPUINFO_TRANSITION_LATENCY:
+      return 2;
+    default:
+      break;
+  }
+  return -1;
+}
+
+static const cpufreq_bindings_file CACHE_U32_FILES[CACHE_U32_COUNT] = {
+  CPUFREQ_BINDINGS_FILE_CPUINFO_MAX_FREQ,
+  CPUFREQ_BINDINGS_FILE_CPUINFO_MIN_FREQ,
+  CPUFREQ_BINDINGS_FILE_CPUINFO_TRANSITION_LATENCY
+};
+
+static void entry_free(cache_entry* e) {
+  free(e->related.vals);
+  free(e->freqs.vals);
+  free(e);
+}
+
+static void cache_free(cpufreq_bindings_attr_cache* cache) {
+  cache_entry* e;
+  while ((e = cache->all) != NULL) {
+    cache->all = e->next;
+    entry_free(e);
+  }
+  free(cache->slots);
+  free(cache);
+}
+
+static uint32_t read_u32(int fd, uint32_t core, cpufreq_bindings_file file) {
+  switch (file) {
+    case CPUFREQ_BINDINGS_FILE_CPUINFO_MAX_FREQ:
+      return cpufreq_bindings_get_cpuinfo_max_freq(fd, core);
+    case CPUFREQ_BINDINGS_FILE_CPUINFO_MIN_FREQ:
+      return cpufreq_bindings_get_cpuinfo_min_freq(fd, core);
+    default:
+      return cpufreq_bindings_get_cpuinfo_transition_latency(fd, core);
+  }
+}
+
+// read an array file, growing the buffer until it fits
+static void fill_u32arr(cpufreq_bindings_ctx* ctx, uint32_t core, cpufreq_bindings_file file, cache_u32arr* arr) {
+  uint32_t* vals;
+  uint32_t len;
+  int fd;
+  if ((fd = cpufreq_bindings_ctx_get_fd(ctx, core, file)) < 0) {
+    arr->err = errno;
+    return;
+  }
+  for (len = CACHE_ARR_LEN_MIN; len <= CACHE_ARR_LEN_MAX; len *= 2) {
+    if ((vals = realloc(arr->vals, len * sizeof(uint32_t))) == NULL) {
+      arr->err = errno;
+      return;
+    }
+    arr->vals = vals;
+    arr->n = file == CPUFREQ_BINDINGS_FILE_RELATED_CPUS ?
+             cpufreq_bindings_get_related_cpus(fd, core, vals, len) :
+             cpufreq_bindings_get_scaling_available_frequencies(fd, core, vals, len);
+    if (arr->n > 0 || errno != ERANGE) {
+      break;
+    }
+  }
+  arr->err = arr->n > 0 ? 0 : errno;
+}
+
+static cache_entry* entry_fill(cpufreq_bindings_ctx* ctx, uint32_t core) {
+  cache_entry* e;
+  uint32_t i;
+  int fd;
+  if ((e = calloc(1, sizeof(cache_entry))) == NULL) {
+    return NULL;
+  }
+  for (i = 0; i < CACHE_U32_COUNT; i++) {
+    if ((fd = cpufreq_bindings_ctx_get_fd(ctx, core, CACHE_U32_FILES[i])) < 0 ||
+        (e->u32[i] = read_u32(fd, core, CACHE_U32_FILES[i])) == 0) {
+      e->u32_err[i] = errno;
+    }
+  }
+  fill_u32arr(ctx, core, CPUFREQ_BINDINGS_FILE_RELATED_CPUS, &e->related);
+  fill_u32arr(ctx, core, CPUFREQ_BINDINGS_FILE_SCALING_AVAILABLE_FREQUENCIES, &e->freqs);
+  if ((fd = cpufreq_bindings_ctx_get_fd(ctx, core, CPUFREQ_BINDINGS_FILE_SCALING_AVAILABLE_GOVERNORS)) < 0 ||
+      (e->ngovernors = cpufreq_bindings_get_scaling_available_governors(fd, core, e->governors[0], CACHE_GOVS,
+                                                                         CACHE_GOV_WIDTH)) == 0) {
+    e->governors_err = errno;
+  }
+  if ((fd = cpufreq_bindings_ctx_get_fd(ctx, core, CPUFREQ_BINDINGS_FILE_SCALING_DRIVER)) < 0 ||
+      (e->driver_len = cpufreq_bindings_get_scaling_driver(fd, core, e->driver, sizeof(e->driver) - 1)) <= 0) {
+    e->driver_err = errno;
+  }
+  return e;
+}
+
+static cache_entry* cache_lookup(cpufreq_bindings_ctx* ctx, uint32_t core) {
+  cpufreq_bindings_attr_cache* cache = ctx->attr_cache;
+  const cpufreq_bindings_policies* p;
+  cache_entry** slot;
+  cache_entry* e;
+  cache_entry* expected = NULL;
+  uint32_t rep = core;
+  int err_save;
+  if (core >= ctx->ncores) {
+    errno = EINVAL;
+    return NULL;
+  }
+  slot = &cache->slots[core];
+  if ((e = __atomic_load_n(slot, __ATOMIC_ACQUIRE)) != NULL) {
+    return e;
+  }
+  // cache per core if policies are unknown
+  err_save = errno;
+  if ((p = cpufreq_bindings_ctx_policies(ctx)) != NULL) {
+    if (p->core_idx[core] != UINT32_MAX) {
+      rep = p->reps[p->core_idx[core]];
+    }
+    cpufreq_bindings_ctx_policies_release(ctx);
+  }
+  errno = err_save;
+  if (rep != core) {
+    // the representative's entry is owned by the cache once published
+    if ((e = cache_lookup(ctx, rep)) != NULL) {
+      __atomic_store_n(slot, e, __ATOMIC_RELEASE);
+    }
+    return e;
+  }
+  if ((e = entry_fill(ctx, core)) == NULL) {
+    return NULL;
+  }
+  if (!__atomic_compare_exchange_n(slot, &expected, e, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+    // another thread won the race
+    entry_free(e);
+    return expected;
+  }
+  e->next = __atomic_load_n(&cache->all, __ATOMIC_RELAXED);
+  while (!__atomic_compare_exchange_n(&cache->all, &e->next, e, 1, __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+  return e;
+}
+
+int cpufreq_bindings_ctx_set_attr_caching(cpufreq_bindings_ctx* ctx, int enable) {
+  cpufreq_bindings_attr_cache* c = NULL;
+  if (enable) {
+    if ((c = calloc(1, sizeof(cpufreq_bindings_attr_cache))) == NULL) {
+      return -1;
+    }
+    if ((c->slots = calloc(ctx->ncores, sizeof(cache_entry*))) == NULL) {
+      free(c);
+      return -1;
+    }
+  }
+  if (ctx->attr_cache != NULL) {
+    cache_free(ctx->attr_cache);
+  }
+  ctx->attr_cache = c;
+  return 0;
+}
+
+int cpufreq_bindings_ctx_invalidate_attr_cache(cpufreq_bindings_ctx* ctx) {
+  return cpufreq_bindings_ctx_set_attr_caching(ctx, ctx->attr_cache != NULL);
+}
+
+void cpufreq_bindings_attr_cache_free(cpufreq_bindings_attr_cache* cache) {
+  cache_free(cache);
+}
+
+uint32_t cpufreq_bindings_attr_cache_get_u32(cpufreq_bindings_ctx* ctx, uint32_t core, cpufreq_bindings_file file) {
+  const cache_entry* e;
+  int idx = cache_u32_index(file);
+  if (idx < 0) {
+    errno = EINVAL;
+    return 0;
+  }
+  if ((e = cache_lookup(ctx, core)) == NULL) {
+    return 0;
+  }
+  if (e->u32_err[idx]) {
+    errno = e->u32_err[idx];
+    return 0;
+  }
+  return e->u32[idx];
+}
+
+uint32_t cpufreq_bindings_attr_cache_get_u32arr(cpufreq_bindings_ctx* ctx, uint32_t core, cpufreq_bindings_file file,
+                                                uint32_t* arr, uint32_t len) {
+  const cache_entry* e;
+  const cache_u32arr* a;
+  if ((e = cache_lookup(ctx, core)) == NULL) {
+    return 0;
+  }
+  a = file == CPUFREQ_BINDINGS_FILE_RELATED_CPUS ? &e->related : &e->freqs;
+  if (a->err) {
+    errno = a->err;
+    return 0;
+  }
+  if (a->n > len) {
+    errno = ERANGE;
+    return 0;
+  }
+  memcpy(arr, a->vals, a->n * sizeof(uint32_t));
+  return a->n;
+}
+
+uint32_t cpufreq_bindings_attr_cache_get_governors(cpufreq_bindings_ctx* ctx, uint32_t core, char* governors,
+                                                   size_t len, size_t width) {
+  const cache_entry* e;
+  size_t n;
+  uint32_t i;
+  if ((e = cache_lookup(ctx, core)) == NULL) {
+    return 0;
+  }
+  if (e->governors_err) {
+    errno = e->governors_err;
+    return 0;
+  }
+  if (e->ngovernors > len) {
+    errno = ERANGE;
+    return 0;
+  }
+  // like the parser: truncate to "width" and zero-fill the rest
+  for (i = 0; i < e->ngovernors; i++) {
+    n = strnlen(e->governors[i], CACHE_GOV_WIDTH);
+    n = n < width ? n : width;
+    memcpy(&governors[i * width], e->governors[i], n);
+    memset(&governors[i * width + n], 0, width - n);
+  }
+  return e->ngovernors;
+}
+
+ssize_t cpufreq_bindings_attr_cache_get_driver(cpufreq_bindings_ctx* ctx, uint32_t core, char* driver, size_t len) {
+  const cache_entry* e;
+  size_t n;
+  if ((e = cache_lookup(ctx, core)) == NULL) {
+    return -1;
+  }
+  if (e->driver_err) {
+    errno = e->driver_err;
+    return -1;
+  }
+  // like a read: copy up to "len" bytes of what was read
+  n = (size_t) e->driver_len < len ? (size_t) e->driver_len : len;
+  memcpy(driver, e->driver, n);
+  return (ssize_t) n;
+}
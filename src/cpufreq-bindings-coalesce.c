@@ -0,0 +1,208 @@
+/**
+ * Write coalescing: elide redundant writes and rate-limit frequency changes.
+ *
+ * @author Connor Imes
+ * @date 2026-10-15
+ */
+// for clock_gettime
+#define _POSIX_C_SOURCE 200809L
+#include <errno.h>
+#include <inttypes.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include "cpufreq-bindings.h"
+#include "cpufreq-bindings-common.h"
+#include "cpufreq-bindings-ctx.h"
+#include "cpufreq-bindings-instrument.h"
+
+// the files that are coalesced
+#define COALESCE_FILE_COUNT 3
+
+#define ENTRY_WRITTEN 0x1
+#define ENTRY_PENDING 0x2
+
+#define INTERVAL_UNKNOWN UINT64_MAX
+
+static int coalesce_file_index(cpufreq_bindings_file file) {
+  switch (file) {
+    case CPUFREQ_BINDINGS_FILE_SCALING_MAX_FREQ:
+      return 0;
+    case CPUFREQ_BINDINGS_FILE_SCALING_MIN_FREQ:
+      return 1;
+    case CPUFREQ_BINDINGS_FILE_SCALING_SETSPEED:
+      return 2;
+    default:
+      break;
+  }
+  return -1;
+}
+
+static const cpufreq_bindings_file COALESCE_FILES[COALESCE_FILE_COUNT] = {
+  CPUFREQ_BINDINGS_FILE_SCALING_MAX_FREQ,
+  CPUFREQ_BINDINGS_FILE_SCALING_MIN_FREQ,
+  CPUFREQ_BINDINGS_FILE_SCALING_SETSPEED
+};
+
+void cpufreq_bindings_coalesce_free(cpufreq_bindings_coalesce* coalesce) {
+  free(coalesce->interval_ns);
+  free(coalesce->entries);
+  free(coalesce);
+}
+
+int cpufreq_bindings_ctx_set_write_coalescing(cpufreq_bindings_ctx* ctx, int enable, uint64_t min_interval_ns) {
+  cpufreq_bindings_coalesce* c = NULL;
+  uint32_t i;
+  if (enable) {
+    if ((c = calloc(1, sizeof(cpufreq_bindings_coalesce))) == NULL) {
+      return -1;
+    }
+    c->min_interval_ns = min_interval_ns;
+    c->interval_ns = malloc(ctx->ncores * sizeof(uint64_t));
+    c->entries = calloc((size_t) ctx->ncores * COALESCE_FILE_COUNT, sizeof(cpufreq_bindings_coalesce_entry));
+    if (c->interval_ns == NULL || c->entries == NULL) {
+      cpufreq_bindings_coalesce_free(c);
+      return -1;
+    }
+    for (i = 0; i < ctx->ncores; i++) {
+      c->interval_ns[i] = INTERVAL_UNKNOWN;
+    }
+  }
+  if (ctx->coalesce != NULL) {
+    cpufreq_bindings_coalesce_free(ctx->coalesce);
+  }
+  ctx->coalesce = c;
+  return 0;
+}
+
+// a policy's cores share its representative's entries, since they share the same files
+static uint32_t entry_core(cpufreq_bindings_ctx* ctx, uint32_t core) {
+  const cpufreq_bindings_policies* p;
+  uint32_t rep = core;
+  int err_save = errno;
+  if ((p = cpufreq_bindings_ctx_policies(ctx)) != NULL) {
+    if (p->core_idx[core] != UINT32_MAX) {
+      rep = p->reps[p->core_idx[core]];
+    }
+    cpufreq_bindings_ctx_policies_release(ctx);
+  }
+  errno = err_save;
+  return rep;
+}
+
+static uint64_t get_interval_ns(cpufreq_bindings_ctx* ctx, uint32_t core) {
+  cpufreq_bindings_coalesce* c = ctx->coalesce;
+  uint32_t latency;
+  if (c->min_interval_ns > 0) {
+    return c->min_interval_ns;
+  }
+  if (c->interval_ns[core] == INTERVAL_UNKNOWN) {
+    // the kernel reports UINT32_MAX (CPUFREQ_ETERNAL) when the latency is unknown - don't rate-limit then
+    latency = cpufreq_bindings_ctx_get_cpuinfo_transition_latency(ctx, core);
+    c->interval_ns[core] = latency == UINT32_MAX ? 0 : latency;
+  }
+  return c->interval_ns[core];
+}
+
+static ssize_t write_entry(cpufreq_bindings_ctx* ctx, uint32_t core, cpufreq_bindings_file file,
+                           cpufreq_bindings_coalesce_entry* e, uint32_t val, uint64_t now) {
+  ssize_t ret;
+  int fd;
+  if ((fd = cpufreq_bindings_ctx_get_fd(ctx, core, file)) < 0) {
+    return -1;
+  }
+  switch (file) {
+    case CPUFREQ_BINDINGS_FILE_SCALING_MAX_FREQ:
+      ret = cpufreq_bindings_set_scaling_max_freq(fd, core, val);
+      break;
+    case CPUFREQ_BINDINGS_FILE_SCALING_MIN_FREQ:
+      ret = cpufreq_bindings_set_scaling_min_freq(fd, core, val);
+      break;
+    default:
+      ret = cpufreq_bindings_set_scaling_setspeed(fd, core, val);
+      break;
+  }
+  if (ret >= 0) {
+    e->last_val = val;
+    e->last_ns = now;
+    e->flags = ENTRY_WRITTEN;
+  }
+  return ret;
+}
+
+ssize_t cpufreq_bindings_coalesce_write(cpufreq_bindings_ctx* ctx, uint32_t core, cpufreq_bindings_file file,
+                                        uint32_t val) {
+  cpufreq_bindings_coalesce_entry* e;
+  uint64_t now;
+  int idx = coalesce_file_index(file);
+  if (core >= ctx->ncores || idx < 0) {
+    errno = EINVAL;
+    return -1;
+  }
+  core = entry_core(ctx, core);
+  e = &ctx->coalesce->entries[(size_t) core * COALESCE_FILE_COUNT + (size_t) idx];
+  if ((e->flags & ENTRY_WRITTEN) && e->last_val == val) {
+    // already set - this also cancels any pending change
+    e->flags &= ~ENTRY_PENDING;
+    STATS_COUNT(COUNTER_WRITE_ELIDED);
+    return 0;
+  }
+  now = now_ns();
+  if ((e->flags & ENTRY_WRITTEN) && now - e->last_ns < get_interval_ns(ctx, core)) {
+    // too soon - keep only the latest value
+    e->pending_val = val;
+    e->flags |= ENTRY_PENDING;
+    STATS_COUNT(COUNTER_WRITE_DEFERRED);
+    return 0;
+  }
+  return write_entry(ctx, core, file, e, val, now);
+}
+
+void cpufreq_bindings_coalesce_update(cpufreq_bindings_ctx* ctx, uint32_t core, cpufreq_bindings_file file,
+                                      const uint32_t* val) {
+  cpufreq_bindings_coalesce_entry* e;
+  int idx = coalesce_file_index(file);
+  if (core >= ctx->ncores || idx < 0) {
+    return;
+  }
+  e = &ctx->coalesce->entries[(size_t) entry_core(ctx, core) * COALESCE_FILE_COUNT + (size_t) idx];
+  // the bypassing write is newer than any deferred value
+  if (val == NULL) {
+    e->flags = 0;
+  } else {
+    e->last_val = *val;
+    e->last_ns = now_ns();
+    e->flags = ENTRY_WRITTEN;
+  }
+}
+
+int cpufreq_bindings_ctx_flush(cpufreq_bindings_ctx* ctx, int force) {
+  cpufreq_bindings_coalesce_entry* e;
+  uint64_t now;
+  size_t i;
+  uint32_t core;
+  int pending = 0;
+  int err_save = 0;
+  if (ctx->coalesce == NULL) {
+    return 0;
+  }
+  now = now_ns();
+  for (i = 0; i < (size_t) ctx->ncores * COALESCE_FILE_COUNT; i++) {
+    e = &ctx->coalesce->entries[i];
+    if (!(e->flags & ENTRY_PENDING)) {
+      continue;
+    }
+    core = (uint32_t) (i / COALESCE_FILE_COUNT);
+    if (!force && now - e->last_ns < get_interval_ns(ctx, core)) {
+      pending++;
+    } else if (write_entry(ctx, core, COALESCE_FILES[i % COALESCE_FILE_COUNT], e, e->pending_val, now) < 0) {
+      // remains pending
+      err_save = errno;
+    }
+  }
+  if (err_save) {
+    errno = err_save;
+    return -1;
+  }
+  return pending;
+}
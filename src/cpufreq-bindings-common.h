@@ -11,36 +11,64 @@
 extern "C" {
 #endif
 
-#include <stdio.h>
+#include <errno.h>
+#include <inttypes.h>
+#include "cpufreq-bindings-log.h"
 
 typedef enum cpufreq_bindings_loglevel {
-  DEBUG = 0,
-  INFO,
-  WARN,
-  ERROR,
-  OFF
+  DEBUG = CPUFREQ_BINDINGS_LOG_LEVEL_DEBUG,
+  INFO = CPUFREQ_BINDINGS_LOG_LEVEL_INFO,
+  WARN = CPUFREQ_BINDINGS_LOG_LEVEL_WARN,
+  ERROR = CPUFREQ_BINDINGS_LOG_LEVEL_ERROR,
+  OFF = CPUFREQ_BINDINGS_LOG_LEVEL_OFF
 } cpufreq_bindings_loglevel;
 
+// the default runtime log level
 #ifndef CPUFREQ_BINDINGS_LOG_LEVEL
   #define CPUFREQ_BINDINGS_LOG_LEVEL WARN
 #endif
 
-#define TO_FILE(severity) (severity) >= WARN ? stderr : stdout
+// for messages not specific to a core or file
+#define LOG_NO_CORE UINT32_MAX
+#define LOG_NO_FILE -1
 
-#define TO_LOG_PREFIX(severity) \
-  (severity) == DEBUG ? "[DEBUG]" : \
-  (severity) == INFO  ? "[INFO] " : \
-  (severity) == WARN  ? "[WARN] " : \
-                        "[ERROR]"
+// the runtime log level, checked before formatting
+extern int cpufreq_bindings_log_level_cur;
+
+// check printf-style arguments where the compiler supports it
+#if defined(__GNUC__)
+  #define PRINTF_FORMAT(fmt_idx, args_idx) __attribute__((format(printf, fmt_idx, args_idx)))
+#else
+  #define PRINTF_FORMAT(fmt_idx, args_idx)
+#endif
+
+void cpufreq_bindings_log_printf(int severity, const char* fmt, ...) PRINTF_FORMAT(2, 3);
+
+void cpufreq_bindings_log_errno(int severity, uint32_t core, int file, int err, const char* msg);
 
 #define LOG(severity, ...) \
-  do { if ((severity) >= CPUFREQ_BINDINGS_LOG_LEVEL) { \
-      fprintf(TO_FILE((severity)), "%s [cpufreq-bindings] ", TO_LOG_PREFIX((severity))); \
-      fprintf(TO_FILE((severity)), __VA_ARGS__); \
+  do { if ((int) (severity) >= __atomic_load_n(&cpufreq_bindings_log_level_cur, __ATOMIC_RELAXED)) { \
+      cpufreq_bindings_log_printf((severity), __VA_ARGS__); \
     } } while (0)
 
+// errors are rate-limited per (core, file, errno) and recorded in the ring of recent errors regardless of the level
+#define PERROR_AT(severity, core, file, msg) \
+  cpufreq_bindings_log_errno((severity), (core), (int) (file), errno, (msg))
+
 #define PERROR(severity, msg) \
-  LOG(severity, "%s: %s\n", msg, strerror(errno))
+  PERROR_AT(severity, LOG_NO_CORE, LOG_NO_FILE, msg)
+
+// sources that use it define _POSIX_C_SOURCE (for clock_gettime) before any includes
+#if defined(_POSIX_C_SOURCE) && _POSIX_C_SOURCE >= 199309L
+#include <time.h>
+
+// CLOCK_MONOTONIC in nanoseconds
+static inline uint64_t now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t) ts.tv_sec * 1000000000ULL + (uint64_t) ts.tv_nsec;
+}
+#endif
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,200 @@
+/**
+ * Context internals shared between library sources.
+ *
+ * @author Connor Imes
+ * @date 2026-10-15
+ */
+#ifndef _CPUFREQ_BINDINGS_CTX_H_
+#define _CPUFREQ_BINDINGS_CTX_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <inttypes.h>
+#include <pthread.h>
+#include "cpufreq-bindings.h"
+#ifdef CPUFREQ_BINDINGS_IO_URING
+#include "cpufreq-bindings-uring.h"
+#endif
+
+#define BINDINGS_FILE_COUNT (CPUFREQ_BINDINGS_FILE_INTEL_PSTATE_NO_TURBO + 1)
+
+#define U32_MAX_LEN 12
+
+// the sysfs root is at most SYSFS_ROOT_MAX_LEN - 1 characters, leaving room for the rest of any path
+#define SYSFS_ROOT_MAX_LEN 256
+#define SYSFS_PATH_MAX_LEN (SYSFS_ROOT_MAX_LEN + 128)
+
+// policies discovered for the cores in a context
+typedef struct cpufreq_bindings_policies {
+  uint32_t npolicies;
+  // sorted kernel policy numbers, length npolicies
+  uint32_t* ids;
+  // the lowest online context core in each policy (the lowest core if none are online), length npolicies
+  uint32_t* reps;
+  // index into "ids" for each core, or UINT32_MAX if unknown, length ncores
+  uint32_t* core_idx;
+  // the next table in the context's "retired" list
+  struct cpufreq_bindings_policies* next;
+} cpufreq_bindings_policies;
+
+// write coalescing state for a (policy, file) pair
+typedef struct cpufreq_bindings_coalesce_entry {
+  uint64_t last_ns;
+  uint32_t last_val;
+  uint32_t pending_val;
+  int flags;
+} cpufreq_bindings_coalesce_entry;
+
+typedef struct cpufreq_bindings_coalesce {
+  // if 0, use each core's "cpuinfo_transition_latency"
+  uint64_t min_interval_ns;
+  // per core, UINT64_MAX until read
+  uint64_t* interval_ns;
+  // per (core, coalesced file), but only used for policy representatives and cores with unknown policies
+  cpufreq_bindings_coalesce_entry* entries;
+} cpufreq_bindings_coalesce;
+
+typedef struct cpufreq_bindings_attr_cache cpufreq_bindings_attr_cache;
+
+struct cpufreq_bindings_ctx {
+  uint32_t ncores;
+  // indexed by (core * BINDINGS_FILE_COUNT + file); 0 if not yet opened
+  int* fds;
+  // discovered on first use
+  cpufreq_bindings_policies* policies;
+  // threads between cpufreq_bindings_ctx_policies and cpufreq_bindings_ctx_policies_release
+  uint32_t policy_readers;
+  // tables replaced by refreshes, freed once there are no readers - modified only with "policy_lock" held
+  cpufreq_bindings_policies* retired;
+  pthread_mutex_t policy_lock;
+  // NULL unless write coalescing is enabled
+  cpufreq_bindings_coalesce* coalesce;
+  // NULL unless static attribute caching is enabled
+  cpufreq_bindings_attr_cache* attr_cache;
+#ifdef CPUFREQ_BINDINGS_IO_URING
+  // created on first batch; only used by the thread that holds "io_busy"
+  cpufreq_bindings_uring* ring;
+  cpufreq_bindings_io* ios;
+  char* io_bufs;
+  int io_busy;
+  int io_failed;
+#endif
+};
+
+/**
+ * Format a path relative to the sysfs root, e.g., "/devices/system/cpu/cpu%u/cpufreq/%s".
+ *
+ * @return 0 on success, or -1 if the path is too long (errno will be set)
+ */
+int cpufreq_bindings_sysfs_path(char* buf, size_t len, const char* fmt, ...)
+#if defined(__GNUC__)
+  __attribute__((format(printf, 3, 4)))
+#endif
+  ;
+
+/**
+ * Read or write single-valued files for a set of cores, using io_uring if available.
+ * Operation i is on file "files[i % nfiles]" for core "cores[i / nfiles]".
+ *
+ * @param ctx
+ * @param files
+ * @param nfiles
+ * @param cores
+ * @param ncores
+ * @param in
+ *  Values to write, or NULL to read
+ * @param out
+ *  Values read, or NULL if writing
+ * @param status
+ *  0 or an errno value for each operation
+ * @return the number of successful operations
+ */
+uint32_t cpufreq_bindings_ctx_u32_batch(cpufreq_bindings_ctx* ctx, const cpufreq_bindings_file* files, uint32_t nfiles,
+                                        const uint32_t* cores, uint32_t ncores, const uint32_t* in, uint32_t* out,
+                                        int* status);
+
+/**
+ * Read a single-valued file synchronously.
+ *
+ * @return 0 on success, or an errno value on failure
+ */
+int cpufreq_bindings_ctx_u32_read(cpufreq_bindings_ctx* ctx, uint32_t core, cpufreq_bindings_file file,
+                                  uint32_t* val);
+
+/**
+ * Write a single-valued file synchronously, bypassing write coalescing.
+ *
+ * @return 0 on success, or an errno value on failure
+ */
+int cpufreq_bindings_ctx_u32_write(cpufreq_bindings_ctx* ctx, uint32_t core, cpufreq_bindings_file file,
+                                  uint32_t val);
+
+/**
+ * Get the context's policies, discovering them if necessary.
+ * The table stays valid, even if the policies are refreshed, until cpufreq_bindings_ctx_policies_release.
+ *
+ * @return the policies, or NULL on failure (errno will be set - don't release)
+ */
+cpufreq_bindings_policies* cpufreq_bindings_ctx_policies(cpufreq_bindings_ctx* ctx);
+
+/**
+ * Finish using a table from cpufreq_bindings_ctx_policies.
+ * Preserves errno.
+ */
+void cpufreq_bindings_ctx_policies_release(cpufreq_bindings_ctx* ctx);
+
+/**
+ * Free a context's policy tables, including retired ones.
+ */
+void cpufreq_bindings_ctx_policies_free(cpufreq_bindings_ctx* ctx);
+
+/**
+ * Free a policy table.
+ */
+void cpufreq_bindings_policies_free(cpufreq_bindings_policies* policies);
+
+/**
+ * Write a value subject to the context's write coalescing rules.
+ *
+ * @return the number of bytes written, 0 if the write was elided or deferred, or -1 on failure (errno will be set)
+ */
+ssize_t cpufreq_bindings_coalesce_write(cpufreq_bindings_ctx* ctx, uint32_t core, cpufreq_bindings_file file,
+                                        uint32_t val);
+
+/**
+ * Record a write that bypassed coalescing, replacing any deferred value for the core's policy.
+ * Does nothing for files that aren't coalesced.
+ * Preserves errno.
+ *
+ * @param val
+ *  The value written, or NULL if the file's value is unknown (e.g., the write failed)
+ */
+void cpufreq_bindings_coalesce_update(cpufreq_bindings_ctx* ctx, uint32_t core, cpufreq_bindings_file file,
+                                      const uint32_t* val);
+
+void cpufreq_bindings_coalesce_free(cpufreq_bindings_coalesce* coalesce);
+
+/**
+ * Static attribute cache getters, with the same semantics as the uncached getters.
+ * "file" is "cpuinfo_max_freq", "cpuinfo_min_freq", or "cpuinfo_transition_latency" for u32 values, and
+ * "related_cpus" or "scaling_available_frequencies" for arrays.
+ */
+uint32_t cpufreq_bindings_attr_cache_get_u32(cpufreq_bindings_ctx* ctx, uint32_t core, cpufreq_bindings_file file);
+
+uint32_t cpufreq_bindings_attr_cache_get_u32arr(cpufreq_bindings_ctx* ctx, uint32_t core, cpufreq_bindings_file file,
+                                                uint32_t* arr, uint32_t len);
+
+uint32_t cpufreq_bindings_attr_cache_get_governors(cpufreq_bindings_ctx* ctx, uint32_t core, char* governors,
+                                                   size_t len, size_t width);
+
+ssize_t cpufreq_bindings_attr_cache_get_driver(cpufreq_bindings_ctx* ctx, uint32_t core, char* driver, size_t len);
+
+void cpufreq_bindings_attr_cache_free(cpufreq_bindings_attr_cache* cache);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,245 @@
+/**
+ * Sorted frequency tables with O(1) lookups for evenly-spaced tables and binary search otherwise.
+ *
+ * @author Connor Imes
+ * @date 2026-10-15
+ */
+#include <errno.h>
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+#include "cpufreq-bindings.h"
+#include "cpufreq-bindings-common.h"
+#include "cpufreq-bindings-freq-table.h"
+
+// "scaling_available_frequencies" is read into a buffer that grows until the file fits
+#define FREQ_TABLE_READ_LEN_MIN 64
+// also limits the size of synthesized tables
+#define FREQ_TABLE_LEN_MAX 65536
+
+// no level
+#define FREQ_TABLE_NONE UINT32_MAX
+
+struct cpufreq_bindings_freq_table {
+  uint32_t* freqs;
+  uint32_t len;
+  // the distance between all adjacent frequencies, or 0 if it varies
+  uint32_t stride;
+  int synthesized;
+};
+
+static int cmp_u32(const void* a, const void* b) {
+  uint32_t x = *(const uint32_t*) a;
+  uint32_t y = *(const uint32_t*) b;
+  return x < y ? -1 : (x > y ? 1 : 0);
+}
+
+// takes ownership of "freqs", which must have len > 0
+static cpufreq_bindings_freq_table* table_create(uint32_t* freqs, uint32_t len, int synthesized) {
+  cpufreq_bindings_freq_table* table;
+  uint32_t n;
+  uint32_t i;
+  if ((table = malloc(sizeof(cpufreq_bindings_freq_table))) == NULL) {
+    free(freqs);
+    return NULL;
+  }
+  qsort(freqs, len, sizeof(uint32_t), cmp_u32);
+  for (n = 1, i = 1; i < len; i++) {
+    if (freqs[i] != freqs[n - 1]) {
+      freqs[n++] = freqs[i];
+    }
+  }
+  table->freqs = freqs;
+  table->len = n;
+  table->stride = n > 1 ? freqs[1] - freqs[0] : 0;
+  for (i = 2; i < n && table->stride > 0; i++) {
+    if (freqs[i] - freqs[i - 1] != table->stride) {
+      table->stride = 0;
+    }
+  }
+  table->synthesized = synthesized;
+  return table;
+}
+
+static cpufreq_bindings_freq_table* table_synthesize(uint32_t min, uint32_t max, uint32_t step) {
+  uint32_t* freqs;
+  uint64_t len;
+  uint32_t i;
+  if (min == 0 || max < min) {
+    errno = EINVAL;
+    return NULL;
+  }
+  len = (max - min) / step + 1;
+  if ((max - min) % step) {
+    len++;
+  }
+  if (len > FREQ_TABLE_LEN_MAX) {
+    errno = ERANGE;
+    return NULL;
+  }
+  if ((freqs = malloc(len * sizeof(uint32_t))) == NULL) {
+    return NULL;
+  }
+  for (i = 0; i < len - 1; i++) {
+    freqs[i] = min + i * step;
+  }
+  freqs[len - 1] = max;
+  return table_create(freqs, (uint32_t) len, 1);
+}
+
+cpufreq_bindings_freq_table* cpufreq_bindings_freq_table_init(cpufreq_bindings_ctx* ctx, uint32_t core,
+                                                              uint32_t step_khz) {
+  uint32_t* freqs = NULL;
+  uint32_t* tmp;
+  uint32_t len;
+  uint32_t n = 0;
+  uint32_t min;
+  uint32_t max;
+  for (len = FREQ_TABLE_READ_LEN_MIN; len <= FREQ_TABLE_LEN_MAX; len *= 2) {
+    if ((tmp = realloc(freqs, len * sizeof(uint32_t))) == NULL) {
+      free(freqs);
+      return NULL;
+    }
+    freqs = tmp;
+    if ((n = cpufreq_bindings_ctx_get_scaling_available_frequencies(ctx, core, freqs, len)) > 0 || errno != ERANGE) {
+      break;
+    }
+  }
+  if (n > 0) {
+    return table_create(freqs, n, 0);
+  }
+  free(freqs);
+  // e.g., the driver doesn't provide the file
+  LOG(DEBUG, "cpufreq_bindings_freq_table_init: synthesizing table for core %"PRIu32"\n", core);
+  if ((min = cpufreq_bindings_ctx_get_cpuinfo_min_freq(ctx, core)) == 0 ||
+      (max = cpufreq_bindings_ctx_get_cpuinfo_max_freq(ctx, core)) == 0) {
+    return NULL;
+  }
+  return table_synthesize(min, max, step_khz > 0 ? step_khz : CPUFREQ_BINDINGS_FREQ_TABLE_STEP_DEFAULT);
+}
+
+cpufreq_bindings_freq_table* cpufreq_bindings_freq_table_init_array(const uint32_t* freqs, uint32_t len) {
+  uint32_t* copy;
+  if (freqs == NULL || len == 0) {
+    errno = EINVAL;
+    return NULL;
+  }
+  if ((copy = malloc(len * sizeof(uint32_t))) == NULL) {
+    return NULL;
+  }
+  memcpy(copy, freqs, len * sizeof(uint32_t));
+  return table_create(copy, len, 0);
+}
+
+void cpufreq_bindings_freq_table_destroy(cpufreq_bindings_freq_table* table) {
+  if (table != NULL) {
+    free(table->freqs);
+    free(table);
+  }
+}
+
+uint32_t cpufreq_bindings_freq_table_get_len(const cpufreq_bindings_freq_table* table) {
+  return table->len;
+}
+
+const uint32_t* cpufreq_bindings_freq_table_get_freqs(const cpufreq_bindings_freq_table* table) {
+  return table->freqs;
+}
+
+int cpufreq_bindings_freq_table_is_synthesized(const cpufreq_bindings_freq_table* table) {
+  return table->synthesized;
+}
+
+// the level of the highest frequency <= freq, or FREQ_TABLE_NONE
+static uint32_t floor_idx(const cpufreq_bindings_freq_table* table, uint32_t freq) {
+  uint32_t lo;
+  uint32_t hi;
+  uint32_t mid;
+  if (freq < table->freqs[0]) {
+    return FREQ_TABLE_NONE;
+  }
+  if (freq >= table->freqs[table->len - 1]) {
+    return table->len - 1;
+  }
+  if (table->stride > 0) {
+    return (freq - table->freqs[0]) / table->stride;
+  }
+  // invariant: freqs[lo] <= freq < freqs[hi]
+  lo = 0;
+  hi = table->len - 1;
+  while (hi - lo > 1) {
+    mid = lo + (hi - lo) / 2;
+    if (table->freqs[mid] <= freq) {
+      lo = mid;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+static uint32_t nearest_idx(const cpufreq_bindings_freq_table* table, uint32_t freq) {
+  uint32_t i = floor_idx(table, freq);
+  if (i == FREQ_TABLE_NONE) {
+    return 0;
+  }
+  if (i == table->len - 1 || freq - table->freqs[i] <= table->freqs[i + 1] - freq) {
+    return i;
+  }
+  return i + 1;
+}
+
+uint32_t cpufreq_bindings_freq_table_get(const cpufreq_bindings_freq_table* table, uint32_t idx) {
+  if (idx >= table->len) {
+    errno = ERANGE;
+    return 0;
+  }
+  return table->freqs[idx];
+}
+
+uint32_t cpufreq_bindings_freq_table_nearest(const cpufreq_bindings_freq_table* table, uint32_t freq) {
+  return table->freqs[nearest_idx(table, freq)];
+}
+
+uint32_t cpufreq_bindings_freq_table_floor(const cpufreq_bindings_freq_table* table, uint32_t freq) {
+  uint32_t i = floor_idx(table, freq);
+  if (i == FREQ_TABLE_NONE) {
+    errno = ERANGE;
+    return 0;
+  }
+  return table->freqs[i];
+}
+
+uint32_t cpufreq_bindings_freq_table_ceil(const cpufreq_bindings_freq_table* table, uint32_t freq) {
+  uint32_t i = floor_idx(table, freq);
+  if (i == FREQ_TABLE_NONE) {
+    return table->freqs[0];
+  }
+  if (table->freqs[i] == freq) {
+    return freq;
+  }
+  if (i == table->len - 1) {
+    errno = ERANGE;
+    return 0;
+  }
+  return table->freqs[i + 1];
+}
+
+int64_t cpufreq_bindings_freq_table_index_of(const cpufreq_bindings_freq_table* table, uint32_t freq) {
+  uint32_t i = floor_idx(table, freq);
+  if (i == FREQ_TABLE_NONE || table->freqs[i] != freq) {
+    errno = ENOENT;
+    return -1;
+  }
+  return i;
+}
+
+uint32_t cpufreq_bindings_freq_table_step(const cpufreq_bindings_freq_table* table, uint32_t freq, int32_t levels) {
+  int64_t i = (int64_t) nearest_idx(table, freq) + levels;
+  if (i < 0) {
+    i = 0;
+  } else if (i >= table->len) {
+    i = table->len - 1;
+  }
+  return table->freqs[i];
+}
@@ -0,0 +1,496 @@
+/**
+ * A userspace governor engine driven by "/proc/stat" utilization deltas, with built-in policies.
+ *
+ * Each period reads "/proc/stat" with a single pread, calls the policy function for each cpufreq policy until the
+ * overhead budget is exhausted, and writes the changed frequencies to each policy's representative core in one batch.
+ *
+ * @author Connor Imes
+ * @date 2026-10-15
+ */
+// for clock_gettime, clock_nanosleep, pread
+#define _POSIX_C_SOURCE 200809L
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "cpufreq-bindings.h"
+#include "cpufreq-bindings-common.h"
+#include "cpufreq-bindings-ctx.h"
+#include "cpufreq-bindings-freq-table.h"
+#include "cpufreq-bindings-governor.h"
+
+#define GOVERNOR_PROCFS_ROOT_DEFAULT "/proc"
+#define GOVERNOR_STAT_BUF_LEN_MIN 4096
+#define GOVERNOR_UP_THRESHOLD_DEFAULT 0.8
+
+typedef struct governor_policy {
+  uint32_t policy;
+  uint32_t rep;
+  // the context cores in the policy
+  uint32_t* cores;
+  uint32_t ncores;
+  cpufreq_bindings_freq_table* table;
+  uint32_t cur_freq;
+  double state[CPUFREQ_BINDINGS_GOVERNOR_STATE_LEN];
+} governor_policy;
+
+struct cpufreq_bindings_governor {
+  cpufreq_bindings_ctx* ctx;
+  cpufreq_bindings_governor_opts opts;
+  int stat_fd;
+  char* buf;
+  size_t buf_len;
+  governor_policy* policies;
+  uint32_t npolicies;
+  // the length of "policies", which may exceed npolicies
+  uint32_t policies_len;
+  // per context core: "/proc/stat" totals from the previous period, and utilization over the last one
+  uint64_t* prev_total;
+  uint64_t* prev_idle;
+  double* util;
+  int primed;
+  uint64_t start_ns;
+  uint64_t last_ns;
+  // write batch scratch, per policy
+  uint32_t* reps;
+  uint32_t* vals;
+  int* status;
+  uint32_t* idxs;
+  uint64_t* decided_ns;
+  // thread
+  pthread_t thread;
+  int running;
+  int started;
+  cpufreq_bindings_governor_stats stats;
+};
+
+static const cpufreq_bindings_file GOVERNOR_FILE = CPUFREQ_BINDINGS_FILE_SCALING_SETSPEED;
+
+static void stat_add(uint64_t* stat, uint64_t val) {
+  __atomic_fetch_add(stat, val, __ATOMIC_RELAXED);
+}
+
+static void stat_max(uint64_t* stat, uint64_t val) {
+  // only the governor's thread writes stats
+  if (val > __atomic_load_n(stat, __ATOMIC_RELAXED)) {
+    __atomic_store_n(stat, val, __ATOMIC_RELAXED);
+  }
+}
+
+static uint32_t table_min(const cpufreq_bindings_freq_table* table) {
+  return cpufreq_bindings_freq_table_get_freqs(table)[0];
+}
+
+static uint32_t table_max(const cpufreq_bindings_freq_table* table) {
+  return cpufreq_bindings_freq_table_get_freqs(table)[cpufreq_bindings_freq_table_get_len(table) - 1];
+}
+
+uint32_t cpufreq_bindings_governor_ondemand(const cpufreq_bindings_governor_input* in, void* arg) {
+  const cpufreq_bindings_governor_ondemand_params* params = arg;
+  double threshold = params != NULL && params->up_threshold > 0 ? params->up_threshold :
+                     GOVERNOR_UP_THRESHOLD_DEFAULT;
+  uint32_t min = table_min(in->table);
+  uint32_t max = table_max(in->table);
+  if (in->util > threshold) {
+    return max;
+  }
+  return min + (uint32_t) (in->util * (max - min));
+}
+
+uint32_t cpufreq_bindings_governor_pid(const cpufreq_bindings_governor_input* in, void* arg) {
+  const cpufreq_bindings_governor_pid_params* params = arg;
+  // state: integral, previous error, initialized, and the unrounded frequency
+  double* integral = &in->state[0];
+  double* prev_err = &in->state[1];
+  double* freq = &in->state[3];
+  int init = in->state[2] > 0;
+  double min = table_min(in->table);
+  double max = table_max(in->table);
+  double err = in->util - params->setpoint;
+  double deriv = init ? err - *prev_err : 0;
+  double next;
+  if (!init) {
+    *freq = in->cur_freq > 0 ? in->cur_freq : max;
+    in->state[2] = 1;
+  }
+  *integral += err;
+  next = *freq + (params->kp * err + params->ki * *integral + params->kd * deriv) * (max - min);
+  if (next < min || next > max) {
+    // anti-windup: don't integrate while saturated
+    *integral -= err;
+    next = next < min ? min : max;
+  }
+  *prev_err = err;
+  *freq = next;
+  // round here, so the engine doesn't always round up
+  return cpufreq_bindings_freq_table_nearest(in->table, (uint32_t) next);
+}
+
+uint32_t cpufreq_bindings_governor_schedule(const cpufreq_bindings_governor_input* in, void* arg) {
+  const cpufreq_bindings_governor_schedule_params* params = arg;
+  uint64_t total = 0;
+  uint64_t t;
+  uint32_t i;
+  for (i = 0; i < params->nentries; i++) {
+    total += params->entries[i].duration_ns;
+  }
+  if (total == 0) {
+    return 0;
+  }
+  t = in->elapsed_ns % total;
+  for (i = 0; t >= params->entries[i].duration_ns; i++) {
+    t -= params->entries[i].duration_ns;
+  }
+  return params->entries[i].freq;
+}
+
+// read "/proc/stat" and update per-core utilization
+static int read_stat(cpufreq_bindings_governor* g) {
+  unsigned long long v[8];
+  uint64_t total;
+  uint64_t idle;
+  uint64_t dtotal;
+  uint64_t didle;
+  ssize_t n;
+  uint32_t core;
+  char* line;
+  char* tmp;
+  // the whole file must be read at once to get a consistent snapshot
+  while ((n = pread(g->stat_fd, g->buf, g->buf_len, 0)) >= 0 && (size_t) n == g->buf_len) {
+    if ((tmp = realloc(g->buf, g->buf_len * 2)) == NULL) {
+      return -1;
+    }
+    g->buf = tmp;
+    g->buf_len *= 2;
+  }
+  if (n < 0) {
+    return -1;
+  }
+  g->buf[n] = '\0';
+  for (line = g->buf; line != NULL && *line != '\0'; line = (tmp = strchr(line, '\n')) == NULL ? NULL : tmp + 1) {
+    // "cpuN user nice system idle iowait irq softirq steal ..." - guest time is included in user time
+    if (strncmp(line, "cpu", 3) || line[3] < '0' || line[3] > '9' ||
+        sscanf(line + 3, "%"SCNu32" %llu %llu %llu %llu %llu %llu %llu %llu", &core, &v[0], &v[1], &v[2], &v[3],
+               &v[4], &v[5], &v[6], &v[7]) != 9 || core >= g->ctx->ncores) {
+      continue;
+    }
+    total = v[0] + v[1] + v[2] + v[3] + v[4] + v[5] + v[6] + v[7];
+    idle = v[3] + v[4];
+    dtotal = total - g->prev_total[core];
+    didle = idle - g->prev_idle[core];
+    // counters go backwards if a core was hotplugged
+    g->util[core] = total > g->prev_total[core] && idle >= g->prev_idle[core] && didle <= dtotal ?
+                    (double) (dtotal - didle) / (double) dtotal : 0;
+    g->prev_total[core] = total;
+    g->prev_idle[core] = idle;
+  }
+  return 0;
+}
+
+static int policies_init(cpufreq_bindings_governor* g, const cpufreq_bindings_policies* p, const uint32_t* cores,
+                         uint32_t ncores) {
+  governor_policy* gp;
+  uint32_t* slot;
+  uint32_t idx;
+  uint32_t i;
+  uint32_t j;
+  if ((slot = malloc(p->npolicies * sizeof(uint32_t))) == NULL) {
+    return -1;
+  }
+  memset(slot, 0xff, p->npolicies * sizeof(uint32_t));
+  if ((g->policies = calloc(p->npolicies, sizeof(governor_policy))) == NULL) {
+    free(slot);
+    return -1;
+  }
+  g->policies_len = p->npolicies;
+  for (i = 0; i < ncores; i++) {
+    if (cores[i] >= g->ctx->ncores || (idx = p->core_idx[cores[i]]) == UINT32_MAX) {
+      free(slot);
+      errno = EINVAL;
+      return -1;
+    }
+    if (slot[idx] != UINT32_MAX) {
+      continue;
+    }
+    slot[idx] = g->npolicies;
+    gp = &g->policies[g->npolicies++];
+    gp->policy = p->ids[idx];
+    gp->rep = p->reps[idx];
+    if ((gp->cores = malloc(g->ctx->ncores * sizeof(uint32_t))) == NULL ||
+        (gp->table = cpufreq_bindings_freq_table_init(g->ctx, gp->rep, g->opts.step_khz)) == NULL) {
+      free(slot);
+      return -1;
+    }
+    for (j = 0; j < g->ctx->ncores; j++) {
+      if (p->core_idx[j] == idx) {
+        gp->cores[gp->ncores++] = j;
+      }
+    }
+  }
+  free(slot);
+  return 0;
+}
+
+static int governor_policies_init(cpufreq_bindings_governor* g, const uint32_t* cores, uint32_t ncores) {
+  const cpufreq_bindings_policies* p;
+  int ret;
+  if ((p = cpufreq_bindings_ctx_policies(g->ctx)) == NULL) {
+    return -1;
+  }
+  ret = policies_init(g, p, cores, ncores);
+  cpufreq_bindings_ctx_policies_release(g->ctx);
+  return ret;
+}
+
+cpufreq_bindings_governor* cpufreq_bindings_governor_init(cpufreq_bindings_ctx* ctx, const uint32_t* cores,
+                                                          uint32_t ncores, const cpufreq_bindings_governor_opts* opts) {
+  cpufreq_bindings_governor* g;
+  char path[SYSFS_PATH_MAX_LEN];
+  const char* root;
+  int err_save;
+  if (ctx == NULL || cores == NULL || ncores == 0 || opts == NULL || opts->policy == NULL || opts->period_ns == 0) {
+    errno = EINVAL;
+    return NULL;
+  }
+  root = opts->procfs_root != NULL ? opts->procfs_root : GOVERNOR_PROCFS_ROOT_DEFAULT;
+  if (strlen(root) >= SYSFS_ROOT_MAX_LEN) {
+    errno = ENAMETOOLONG;
+    return NULL;
+  }
+  snprintf(path, sizeof(path), "%s/stat", root);
+  if ((g = calloc(1, sizeof(cpufreq_bindings_governor))) == NULL) {
+    return NULL;
+  }
+  g->ctx = ctx;
+  g->opts = *opts;
+  // not kept
+  g->opts.procfs_root = NULL;
+  if ((g->stat_fd = open(path, O_RDONLY)) < 0) {
+    err_save = errno;
+    LOG(ERROR, "cpufreq_bindings_governor_init: %s: %s\n", path, strerror(errno));
+    free(g);
+    errno = err_save;
+    return NULL;
+  }
+  g->buf_len = GOVERNOR_STAT_BUF_LEN_MIN;
+  g->buf = malloc(g->buf_len);
+  g->prev_total = calloc(ctx->ncores, sizeof(uint64_t));
+  g->prev_idle = calloc(ctx->ncores, sizeof(uint64_t));
+  g->util = calloc(ctx->ncores, sizeof(double));
+  g->reps = malloc(ctx->ncores * sizeof(uint32_t));
+  g->vals = malloc(ctx->ncores * sizeof(uint32_t));
+  g->status = malloc(ctx->ncores * sizeof(int));
+  g->idxs = malloc(ctx->ncores * sizeof(uint32_t));
+  g->decided_ns = malloc(ctx->ncores * sizeof(uint64_t));
+  if (g->buf == NULL || g->prev_total == NULL || g->prev_idle == NULL || g->util == NULL || g->reps == NULL ||
+      g->vals == NULL || g->status == NULL || g->idxs == NULL || g->decided_ns == NULL ||
+      governor_policies_init(g, cores, ncores)) {
+    err_save = errno;
+    cpufreq_bindings_governor_destroy(g);
+    errno = err_save;
+    return NULL;
+  }
+  return g;
+}
+
+void cpufreq_bindings_governor_destroy(cpufreq_bindings_governor* governor) {
+  uint32_t i;
+  if (governor->started) {
+    cpufreq_bindings_governor_stop(governor);
+  }
+  // includes a policy that was partially initialized if init failed
+  for (i = 0; i < governor->policies_len; i++) {
+    free(governor->policies[i].cores);
+    cpufreq_bindings_freq_table_destroy(governor->policies[i].table);
+  }
+  close(governor->stat_fd);
+  free(governor->buf);
+  free(governor->prev_total);
+  free(governor->prev_idle);
+  free(governor->util);
+  free(governor->reps);
+  free(governor->vals);
+  free(governor->status);
+  free(governor->idxs);
+  free(governor->decided_ns);
+  free(governor->policies);
+  free(governor);
+}
+
+static uint32_t decide(cpufreq_bindings_governor* g, governor_policy* gp, uint32_t idx, uint64_t now,
+                       uint64_t period_ns) {
+  cpufreq_bindings_governor_input in;
+  uint32_t freq;
+  uint32_t i;
+  in.policy = gp->policy;
+  in.idx = idx;
+  in.util = 0;
+  for (i = 0; i < gp->ncores; i++) {
+    if (g->util[gp->cores[i]] > in.util) {
+      in.util = g->util[gp->cores[i]];
+    }
+  }
+  in.cur_freq = gp->cur_freq;
+  in.table = gp->table;
+  in.elapsed_ns = now - g->start_ns;
+  in.period_ns = period_ns;
+  in.state = gp->state;
+  if ((freq = g->opts.policy(&in, g->opts.arg)) == 0) {
+    return 0;
+  }
+  // round up, or down to the highest frequency
+  return freq > table_max(gp->table) ? table_max(gp->table) : cpufreq_bindings_freq_table_ceil(gp->table, freq);
+}
+
+static int governor_period(cpufreq_bindings_governor* g) {
+  governor_policy* gp;
+  uint64_t start = now_ns();
+  uint64_t now = start;
+  uint64_t period_ns;
+  uint64_t done;
+  uint64_t lat;
+  uint32_t freq;
+  uint32_t n = 0;
+  uint32_t i;
+  if (read_stat(g)) {
+    stat_add(&g->stats.errors, 1);
+    return -1;
+  }
+  if (!g->primed) {
+    g->primed = 1;
+    g->start_ns = start;
+    g->last_ns = start;
+    return 0;
+  }
+  period_ns = start - g->last_ns;
+  g->last_ns = start;
+  // the budget includes reading "/proc/stat"
+  now = now_ns();
+  for (i = 0; i < g->npolicies; i++) {
+    if (g->opts.budget_ns > 0 && now - start > g->opts.budget_ns) {
+      stat_add(&g->stats.skipped, g->npolicies - i);
+      stat_add(&g->stats.over_budget, 1);
+      break;
+    }
+    gp = &g->policies[i];
+    freq = decide(g, gp, i, start, period_ns);
+    now = now_ns();
+    stat_add(&g->stats.decisions, 1);
+    if (freq == 0 || freq == gp->cur_freq) {
+      continue;
+    }
+    g->reps[n] = gp->rep;
+    g->vals[n] = freq;
+    g->idxs[n] = i;
+    g->decided_ns[n] = now;
+    n++;
+  }
+  if (n > 0) {
+    cpufreq_bindings_ctx_u32_batch(g->ctx, &GOVERNOR_FILE, 1, g->reps, n, g->vals, NULL, g->status);
+    done = now_ns();
+    for (i = 0; i < n; i++) {
+      if (g->status[i]) {
+        stat_add(&g->stats.errors, 1);
+        continue;
+      }
+      g->policies[g->idxs[i]].cur_freq = g->vals[i];
+      lat = done - g->decided_ns[i];
+      stat_add(&g->stats.writes, 1);
+      stat_add(&g->stats.write_latency_ns_total, lat);
+      stat_max(&g->stats.write_latency_ns_max, lat);
+    }
+  }
+  lat = now_ns() - start;
+  stat_add(&g->stats.periods, 1);
+  stat_add(&g->stats.overhead_ns_total, lat);
+  stat_max(&g->stats.overhead_ns_max, lat);
+  return 0;
+}
+
+static void* governor_thread(void* arg) {
+  cpufreq_bindings_governor* g = arg;
+  struct timespec ts;
+  uint64_t deadline = now_ns();
+  uint64_t missed;
+  uint64_t now;
+  while (__atomic_load_n(&g->running, __ATOMIC_ACQUIRE)) {
+    now = now_ns();
+    if (now - deadline >= g->opts.period_ns) {
+      // skip the periods we slept through rather than bursting to catch up
+      missed = (now - deadline) / g->opts.period_ns;
+      stat_add(&g->stats.dropped, missed);
+      deadline += missed * g->opts.period_ns;
+    }
+    governor_period(g);
+    deadline += g->opts.period_ns;
+    ts.tv_sec = (time_t) (deadline / 1000000000ULL);
+    ts.tv_nsec = (long) (deadline % 1000000000ULL);
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR);
+  }
+  return NULL;
+}
+
+int cpufreq_bindings_governor_start(cpufreq_bindings_governor* governor) {
+  int ret;
+  if (governor->started) {
+    errno = EBUSY;
+    return -1;
+  }
+  __atomic_store_n(&governor->running, 1, __ATOMIC_RELEASE);
+  if ((ret = pthread_create(&governor->thread, NULL, governor_thread, governor))) {
+    __atomic_store_n(&governor->running, 0, __ATOMIC_RELEASE);
+    errno = ret;
+    PERROR(ERROR, "cpufreq_bindings_governor_start: pthread_create");
+    return -1;
+  }
+  governor->started = 1;
+  return 0;
+}
+
+int cpufreq_bindings_governor_stop(cpufreq_bindings_governor* governor) {
+  int ret;
+  if (!governor->started) {
+    errno = EINVAL;
+    return -1;
+  }
+  __atomic_store_n(&governor->running, 0, __ATOMIC_RELEASE);
+  if ((ret = pthread_join(governor->thread, NULL))) {
+    errno = ret;
+    PERROR(ERROR, "cpufreq_bindings_governor_stop: pthread_join");
+    return -1;
+  }
+  governor->started = 0;
+  return 0;
+}
+
+int cpufreq_bindings_governor_step(cpufreq_bindings_governor* governor) {
+  if (governor->started) {
+    errno = EBUSY;
+    return -1;
+  }
+  return governor_period(governor);
+}
+
+uint32_t cpufreq_bindings_governor_get_npolicies(const cpufreq_bindings_governor* governor) {
+  return governor->npolicies;
+}
+
+void cpufreq_bindings_governor_get_stats(const cpufreq_bindings_governor* governor,
+                                         cpufreq_bindings_governor_stats* stats) {
+  stats->periods = __atomic_load_n(&governor->stats.periods, __ATOMIC_RELAXED);
+  stats->dropped = __atomic_load_n(&governor->stats.dropped, __ATOMIC_RELAXED);
+  stats->decisions = __atomic_load_n(&governor->stats.decisions, __ATOMIC_RELAXED);
+  stats->skipped = __atomic_load_n(&governor->stats.skipped, __ATOMIC_RELAXED);
+  stats->over_budget = __atomic_load_n(&governor->stats.over_budget, __ATOMIC_RELAXED);
+  stats->writes = __atomic_load_n(&governor->stats.writes, __ATOMIC_RELAXED);
+  stats->errors = __atomic_load_n(&governor->stats.errors, __ATOMIC_RELAXED);
+  stats->overhead_ns_total = __atomic_load_n(&governor->stats.overhead_ns_total, __ATOMIC_RELAXED);
+  stats->overhead_ns_max = __atomic_load_n(&governor->stats.overhead_ns_max, __ATOMIC_RELAXED);
+  stats->write_latency_ns_total = __atomic_load_n(&governor->stats.write_latency_ns_total, __ATOMIC_RELAXED);
+  stats->write_latency_ns_max = __atomic_load_n(&governor->stats.write_latency_ns_max, __ATOMIC_RELAXED);
+}
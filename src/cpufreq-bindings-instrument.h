@@ -0,0 +1,78 @@
+/**
+ * Instrumentation hooks for the I/O paths.
+ * The STATS macros expand to nothing unless CPUFREQ_BINDINGS_STATS is defined.
+ *
+ * @author Connor Imes
+ * @date 2026-10-15
+ */
+#ifndef _CPUFREQ_BINDINGS_INSTRUMENT_H_
+#define _CPUFREQ_BINDINGS_INSTRUMENT_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <inttypes.h>
+#include <stddef.h>
+#include "cpufreq-bindings.h"
+
+#ifdef CPUFREQ_BINDINGS_STATS
+
+typedef enum cpufreq_bindings_counter {
+  COUNTER_OPEN,
+  COUNTER_PREAD,
+  COUNTER_PWRITE,
+  COUNTER_CLOSE,
+  COUNTER_OPEN_PER_CALL,
+  COUNTER_URING_SUBMIT,
+  COUNTER_PARSE_ERROR,
+  COUNTER_WRITE_ELIDED,
+  COUNTER_WRITE_DEFERRED
+} cpufreq_bindings_counter;
+
+void cpufreq_bindings_stats_count(cpufreq_bindings_counter counter);
+
+// returns a start time for cpufreq_bindings_stats_io
+uint64_t cpufreq_bindings_stats_start(void);
+
+// "start_ns" is 0 for I/O batched through io_uring, which is counted separately and not timed
+void cpufreq_bindings_stats_io(cpufreq_bindings_file file, int write, int failed, uint64_t start_ns);
+
+#define STATS_COUNT(counter) cpufreq_bindings_stats_count(counter)
+#define STATS_START() cpufreq_bindings_stats_start()
+#define STATS_IO(file, write, failed, start_ns) cpufreq_bindings_stats_io(file, write, failed, start_ns)
+
+#else
+
+#define STATS_COUNT(counter) ((void) 0)
+#define STATS_START() ((uint64_t) 0)
+#define STATS_IO(file, write, failed, start_ns) ((void) (start_ns))
+
+#endif
+
+// tracing is enabled at runtime (see cpufreq-bindings-trace.h), so these hooks are always compiled in
+extern int cpufreq_bindings_trace_enabled;
+
+uint64_t cpufreq_bindings_trace_now(void);
+
+void cpufreq_bindings_trace_u32(uint64_t start_ns, uint32_t core, cpufreq_bindings_file file, uint32_t val);
+
+void cpufreq_bindings_trace_str(uint64_t start_ns, uint32_t core, cpufreq_bindings_file file, const char* str,
+                                size_t len);
+
+// returns a start time for TRACE_U32 and TRACE_STR, or 0 if not tracing
+#define TRACE_START() \
+  (__atomic_load_n(&cpufreq_bindings_trace_enabled, __ATOMIC_RELAXED) ? cpufreq_bindings_trace_now() : 0)
+
+// record a successful write
+#define TRACE_U32(start_ns, core, file, val) \
+  do { if ((start_ns) != 0) { cpufreq_bindings_trace_u32((start_ns), (core), (file), (val)); } } while (0)
+
+#define TRACE_STR(start_ns, core, file, str, len) \
+  do { if ((start_ns) != 0) { cpufreq_bindings_trace_str((start_ns), (core), (file), (str), (len)); } } while (0)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
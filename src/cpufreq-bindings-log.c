@@ -0,0 +1,221 @@
+/**
+ * Library logging: runtime level, sink, rate limiting, and the ring of recent errors.
+ *
+ * @author Connor Imes
+ * @date 2026-10-15
+ */
+// for clock_gettime
+#define _POSIX_C_SOURCE 200809L
+#include <errno.h>
+#include <inttypes.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "cpufreq-bindings-common.h"
+#include "cpufreq-bindings-log.h"
+
+// must be a power of 2
+#define LIMIT_SLOTS 256
+
+// an odd sequence number means the entry is being written
+typedef struct log_ring_entry {
+  uint64_t seq;
+  cpufreq_bindings_log_event ev;
+} log_ring_entry;
+
+// slots are shared by keys with the same hash - a collision just resets the slot, so limiting is approximate
+typedef struct limit_slot {
+  uint64_t key;
+  uint64_t window_ns;
+  uint32_t count;
+  uint32_t suppressed;
+} limit_slot;
+
+int cpufreq_bindings_log_level_cur = CPUFREQ_BINDINGS_LOG_LEVEL;
+
+static cpufreq_bindings_log_fn log_fn = NULL;
+static void* log_arg = NULL;
+
+static uint64_t limit_interval_ns = 1000000000ULL;
+static uint32_t limit_burst = 1;
+static uint64_t suppressed_total = 0;
+static limit_slot limit_slots[LIMIT_SLOTS];
+
+static uint64_t ring_head = 0;
+static log_ring_entry ring[CPUFREQ_BINDINGS_LOG_RING_LEN];
+
+void cpufreq_bindings_log_set_level(cpufreq_bindings_log_level level) {
+  __atomic_store_n(&cpufreq_bindings_log_level_cur, (int) level, __ATOMIC_RELAXED);
+}
+
+cpufreq_bindings_log_level cpufreq_bindings_log_get_level(void) {
+  return (cpufreq_bindings_log_level) __atomic_load_n(&cpufreq_bindings_log_level_cur, __ATOMIC_RELAXED);
+}
+
+void cpufreq_bindings_log_set_callback(cpufreq_bindings_log_fn fn, void* arg) {
+  __atomic_store_n(&log_arg, arg, __ATOMIC_RELAXED);
+  __atomic_store_n(&log_fn, fn, __ATOMIC_RELEASE);
+}
+
+void cpufreq_bindings_log_set_rate_limit(uint64_t interval_ns, uint32_t burst) {
+  __atomic_store_n(&limit_interval_ns, interval_ns, __ATOMIC_RELAXED);
+  __atomic_store_n(&limit_burst, burst, __ATOMIC_RELAXED);
+}
+
+uint64_t cpufreq_bindings_log_get_suppressed(void) {
+  return __atomic_load_n(&suppressed_total, __ATOMIC_RELAXED);
+}
+
+static void ring_push(const cpufreq_bindings_log_event* ev) {
+  uint64_t seq = __atomic_fetch_add(&ring_head, 1, __ATOMIC_RELAXED);
+  log_ring_entry* e = &ring[seq % CPUFREQ_BINDINGS_LOG_RING_LEN];
+  __atomic_store_n(&e->seq, 2 * seq + 1, __ATOMIC_RELAXED);
+  __atomic_thread_fence(__ATOMIC_RELEASE);
+  memcpy(&e->ev, ev, sizeof(e->ev));
+  __atomic_store_n(&e->seq, 2 * seq + 2, __ATOMIC_RELEASE);
+}
+
+uint32_t cpufreq_bindings_log_get_recent(cpufreq_bindings_log_event* events, uint32_t len) {
+  uint64_t head = __atomic_load_n(&ring_head, __ATOMIC_ACQUIRE);
+  uint64_t n = head < CPUFREQ_BINDINGS_LOG_RING_LEN ? head : CPUFREQ_BINDINGS_LOG_RING_LEN;
+  const log_ring_entry* e;
+  uint64_t seq;
+  uint64_t s;
+  uint32_t out = 0;
+  if (n > len) {
+    n = len;
+  }
+  for (s = head - n; s < head; s++) {
+    e = &ring[s % CPUFREQ_BINDINGS_LOG_RING_LEN];
+    // skip entries still being written or already overwritten
+    if ((seq = __atomic_load_n(&e->seq, __ATOMIC_ACQUIRE)) != 2 * s + 2) {
+      continue;
+    }
+    memcpy(&events[out], &e->ev, sizeof(events[out]));
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    if (__atomic_load_n(&e->seq, __ATOMIC_RELAXED) == seq) {
+      out++;
+    }
+  }
+  return out;
+}
+
+static uint64_t mix64(uint64_t x) {
+  x ^= x >> 33;
+  x *= 0xff51afd7ed558ccdULL;
+  x ^= x >> 33;
+  x *= 0xc4ceb9fe1a85ec53ULL;
+  x ^= x >> 33;
+  return x;
+}
+
+// returns -1 if the error should be suppressed, otherwise the number suppressed since the last one that wasn't
+static int64_t rate_limit(uint64_t key, uint64_t now) {
+  limit_slot* slot = &limit_slots[mix64(key) & (LIMIT_SLOTS - 1)];
+  uint32_t burst = __atomic_load_n(&limit_burst, __ATOMIC_RELAXED);
+  uint64_t window;
+  if (burst == 0) {
+    return 0;
+  }
+  if (__atomic_load_n(&slot->key, __ATOMIC_RELAXED) != key) {
+    __atomic_store_n(&slot->key, key, __ATOMIC_RELAXED);
+    __atomic_store_n(&slot->window_ns, now, __ATOMIC_RELAXED);
+    __atomic_store_n(&slot->count, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&slot->suppressed, 0, __ATOMIC_RELAXED);
+  }
+  window = __atomic_load_n(&slot->window_ns, __ATOMIC_RELAXED);
+  if (now - window >= __atomic_load_n(&limit_interval_ns, __ATOMIC_RELAXED) &&
+      __atomic_compare_exchange_n(&slot->window_ns, &window, now, 0, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+    __atomic_store_n(&slot->count, 0, __ATOMIC_RELAXED);
+  }
+  if (__atomic_fetch_add(&slot->count, 1, __ATOMIC_RELAXED) >= burst) {
+    __atomic_fetch_add(&slot->suppressed, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&suppressed_total, 1, __ATOMIC_RELAXED);
+    return -1;
+  }
+  return __atomic_exchange_n(&slot->suppressed, 0, __ATOMIC_RELAXED);
+}
+
+static void default_sink(const cpufreq_bindings_log_event* ev) {
+  FILE* f = ev->level >= CPUFREQ_BINDINGS_LOG_LEVEL_WARN ? stderr : stdout;
+  const char* prefix = ev->level == CPUFREQ_BINDINGS_LOG_LEVEL_DEBUG ? "[DEBUG]" :
+                       ev->level == CPUFREQ_BINDINGS_LOG_LEVEL_INFO  ? "[INFO] " :
+                       ev->level == CPUFREQ_BINDINGS_LOG_LEVEL_WARN  ? "[WARN] " :
+                                                                       "[ERROR]";
+  if (ev->err == 0) {
+    fprintf(f, "%s [cpufreq-bindings] %s\n", prefix, ev->msg);
+  } else if (ev->suppressed == 0) {
+    fprintf(f, "%s [cpufreq-bindings] %s: %s\n", prefix, ev->msg, strerror(ev->err));
+  } else {
+    fprintf(f, "%s [cpufreq-bindings] %s: %s (%"PRIu32" similar messages suppressed)\n", prefix, ev->msg,
+            strerror(ev->err), ev->suppressed);
+  }
+}
+
+static void emit(const cpufreq_bindings_log_event* ev) {
+  cpufreq_bindings_log_fn fn = __atomic_load_n(&log_fn, __ATOMIC_ACQUIRE);
+  if (fn != NULL) {
+    fn(ev, __atomic_load_n(&log_arg, __ATOMIC_RELAXED));
+  } else {
+    default_sink(ev);
+  }
+}
+
+void cpufreq_bindings_log_printf(int severity, const char* fmt, ...) {
+  cpufreq_bindings_log_event ev;
+  int err_save = errno;
+  size_t n;
+  va_list args;
+  ev.timestamp_ns = now_ns();
+  ev.level = (cpufreq_bindings_log_level) severity;
+  ev.err = 0;
+  ev.core = LOG_NO_CORE;
+  ev.file = LOG_NO_FILE;
+  ev.suppressed = 0;
+  va_start(args, fmt);
+  vsnprintf(ev.msg, sizeof(ev.msg), fmt, args);
+  va_end(args);
+  // format strings end with a newline, which the sink adds
+  n = strlen(ev.msg);
+  if (n > 0 && ev.msg[n - 1] == '\n') {
+    ev.msg[n - 1] = '\0';
+  }
+  if (severity >= WARN) {
+    ring_push(&ev);
+  }
+  emit(&ev);
+  errno = err_save;
+}
+
+void cpufreq_bindings_log_errno(int severity, uint32_t core, int file, int err, const char* msg) {
+  cpufreq_bindings_log_event ev;
+  int record = severity >= WARN;
+  int to_sink = severity >= __atomic_load_n(&cpufreq_bindings_log_level_cur, __ATOMIC_RELAXED);
+  int64_t suppressed = 0;
+  uint64_t key;
+  if (!record && !to_sink) {
+    return;
+  }
+  ev.timestamp_ns = now_ns();
+  if (to_sink) {
+    // errors not specific to a core or file are distinguished by their message instead
+    key = (core == LOG_NO_CORE && file == LOG_NO_FILE) ? (uint64_t) (uintptr_t) msg :
+          (uint64_t) core | ((uint64_t) (uint8_t) (file + 1) << 32);
+    suppressed = rate_limit(key ^ ((uint64_t) (uint16_t) err << 48), ev.timestamp_ns);
+  }
+  ev.level = (cpufreq_bindings_log_level) severity;
+  ev.err = err;
+  ev.core = core;
+  ev.file = file;
+  ev.suppressed = suppressed < 0 ? 0 : (uint32_t) suppressed;
+  strncpy(ev.msg, msg, sizeof(ev.msg) - 1);
+  ev.msg[sizeof(ev.msg) - 1] = '\0';
+  if (record) {
+    ring_push(&ev);
+  }
+  if (to_sink && suppressed >= 0) {
+    emit(&ev);
+  }
+  errno = err;
+}
@@ -0,0 +1,322 @@
+/**
+ * Allocation-free parsers for sysfs file contents.
+ *
+ * @author Connor Imes
+ * @date 2026-10-15
+ */
+#include <errno.h>
+#include <inttypes.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include "cpufreq-bindings.h"
+#include "cpufreq-bindings-parse.h"
+
+#define IS_DIGIT(c) ((c) >= '0' && (c) <= '9')
+#define IS_SPACE(c) ((c) == ' ' || (c) == '\n' || (c) == '\t' || (c) == '\0')
+
+int cpufreq_bindings_parse_u32(const char* buf, size_t len, uint32_t* val) {
+  uint64_t v = 0;
+  size_t i;
+  for (i = 0; i < len && IS_DIGIT(buf[i]); i++) {
+    v = v * 10 + (uint64_t) (buf[i] - '0');
+    if (v > UINT32_MAX) {
+      return ERANGE;
+    }
+  }
+  if (i == 0 || (i < len && !IS_SPACE(buf[i]))) {
+    return EINVAL;
+  }
+  *val = (uint32_t) v;
+  return 0;
+}
+
+void cpufreq_bindings_u32arr_parser_init(cpufreq_bindings_u32arr_parser* p, uint32_t* arr, uint32_t len) {
+  memset(p, 0, sizeof(*p));
+  p->arr = arr;
+  p->len = len;
+}
+
+// the end of a number token
+static int u32arr_end_value(cpufreq_bindings_u32arr_parser* p) {
+  uint32_t v;
+  uint32_t start = p->in_range ? p->range_start : (uint32_t) p->val;
+  if (p->in_range && (p->ndigits == 0 || p->val < p->range_start)) {
+    return EINVAL;
+  }
+  if ((uint64_t) (p->val - start) >= (uint64_t) (p->len - p->n)) {
+    // the array isn't big enough
+    return ERANGE;
+  }
+  for (v = start; v <= (uint32_t) p->val; v++) {
+    p->arr[p->n++] = v;
+    if (v == UINT32_MAX) {
+      break;
+    }
+  }
+  p->val = 0;
+  p->ndigits = 0;
+  p->in_range = 0;
+  return 0;
+}
+
+int cpufreq_bindings_u32arr_parse(cpufreq_bindings_u32arr_parser* p, const char* buf, size_t len) {
+  // work on local copies - stores to the array could otherwise alias the parser state
+  uint64_t val = p->val;
+  uint32_t ndigits = p->ndigits;
+  size_t i;
+  char c;
+  for (i = 0; i < len && !p->err; i++) {
+    c = buf[i];
+    if (IS_DIGIT(c)) {
+      val = val * 10 + (uint64_t) (c - '0');
+      ndigits++;
+      if (val > UINT32_MAX) {
+        p->err = ERANGE;
+      }
+    } else if (c == '-' && ndigits > 0 && !p->in_range) {
+      p->range_start = (uint32_t) val;
+      p->in_range = 1;
+      val = 0;
+      ndigits = 0;
+    } else if (IS_SPACE(c) || c == ',') {
+      if (ndigits > 0) {
+        p->val = val;
+        p->ndigits = ndigits;
+        p->err = u32arr_end_value(p);
+        val = 0;
+        ndigits = 0;
+      } else if (p->in_range) {
+        p->err = EINVAL;
+      }
+    } else {
+      p->err = EINVAL;
+    }
+  }
+  p->val = val;
+  p->ndigits = ndigits;
+  return p->err;
+}
+
+uint32_t cpufreq_bindings_u32arr_parser_finish(cpufreq_bindings_u32arr_parser* p) {
+  if (!p->err && (p->ndigits > 0 || p->in_range)) {
+    p->err = u32arr_end_value(p);
+  }
+  if (p->err) {
+    errno = p->err;
+    return 0;
+  }
+  return p->n;
+}
+
+static int cmp_u32(const void* a, const void* b) {
+  uint32_t x = *(const uint32_t*) a;
+  uint32_t y = *(const uint32_t*) b;
+  return x < y ? -1 : x > y ? 1 : 0;
+}
+
+uint32_t cpufreq_bindings_parse_cpulist(const char* str, uint32_t* cpus, uint32_t len) {
+  cpufreq_bindings_u32arr_parser p;
+  uint32_t n;
+  uint32_t i;
+  uint32_t j;
+  cpufreq_bindings_u32arr_parser_init(&p, cpus, len);
+  // finishing reports any parse error
+  cpufreq_bindings_u32arr_parse(&p, str, strlen(str));
+  if ((n = cpufreq_bindings_u32arr_parser_finish(&p)) == 0) {
+    if (!p.err) {
+      // nothing but separators
+      errno = EINVAL;
+    }
+    return 0;
+  }
+  qsort(cpus, n, sizeof(uint32_t), cmp_u32);
+  for (i = 1, j = 1; i < n; i++) {
+    if (cpus[i] != cpus[j - 1]) {
+      cpus[j++] = cpus[i];
+    }
+  }
+  return j;
+}
+
+void cpufreq_bindings_strarr_parser_init(cpufreq_bindings_strarr_parser* p, char* arr, size_t len, size_t width) {
+  memset(p, 0, sizeof(*p));
+  p->arr = arr;
+  p->len = len;
+  p->width = width;
+}
+
+// the end of a string token
+static void strarr_end_value(cpufreq_bindings_strarr_parser* p) {
+  if (p->pos < p->width) {
+    memset(&p->arr[p->n * p->width + p->pos], 0, p->width - p->pos);
+  }
+  p->n++;
+  p->pos = 0;
+}
+
+int cpufreq_bindings_strarr_parse(cpufreq_bindings_strarr_parser* p, const char* buf, size_t len) {
+  size_t i = 0;
+  size_t start;
+  size_t n;
+  while (i < len && !p->err) {
+    if (IS_SPACE(buf[i])) {
+      if (p->pos > 0) {
+        strarr_end_value(p);
+      }
+      i++;
+      continue;
+    }
+    if (p->n == p->len) {
+      // the array isn't big enough
+      p->err = ERANGE;
+      break;
+    }
+    // copy the rest of the token in this chunk at once
+    for (start = i; i < len && !IS_SPACE(buf[i]); i++);
+    if (p->pos < p->width) {
+      n = i - start < p->width - p->pos ? i - start : p->width - p->pos;
+      memcpy(&p->arr[p->n * p->width + p->pos], &buf[start], n);
+    }
+    p->pos += i - start;
+  }
+  return p->err;
+}
+
+uint32_t cpufreq_bindings_strarr_parser_finish(cpufreq_bindings_strarr_parser* p) {
+  if (!p->err && p->pos > 0) {
+    strarr_end_value(p);
+  }
+  if (p->err) {
+    errno = p->err;
+    return 0;
+  }
+  return (uint32_t) p->n;
+}
+
+// skip spaces and tabs, but not newlines
+static size_t skip_blanks(const char* buf, size_t len, size_t i) {
+  while (i < len && (buf[i] == ' ' || buf[i] == '\t')) {
+    i++;
+  }
+  return i;
+}
+
+static size_t skip_space(const char* buf, size_t len, size_t i) {
+  while (i < len && IS_SPACE(buf[i])) {
+    i++;
+  }
+  return i;
+}
+
+// parse a decimal value that starts at buf[*i], leaving *i at the first character after it
+static int parse_u64_at(const char* buf, size_t len, size_t* i, uint64_t max, uint64_t* val) {
+  uint64_t v = 0;
+  uint64_t d;
+  size_t start = *i;
+  for (; *i < len && IS_DIGIT(buf[*i]); (*i)++) {
+    d = (uint64_t) (buf[*i] - '0');
+    if (v > (max - d) / 10) {
+      return ERANGE;
+    }
+    v = v * 10 + d;
+  }
+  if (*i == start) {
+    return EINVAL;
+  }
+  *val = v;
+  return 0;
+}
+
+// the end of a line, which may also be the end of the buffer
+static int at_eol(const char* buf, size_t len, size_t i) {
+  return i == len || buf[i] == '\n' || buf[i] == '\0';
+}
+
+int cpufreq_bindings_parse_time_in_state(const char* buf, size_t len, uint32_t* freqs, uint64_t* times, uint32_t max,
+                                         uint32_t* n) {
+  uint64_t freq;
+  uint64_t time;
+  size_t i = 0;
+  size_t sep;
+  int err;
+  *n = 0;
+  while ((i = skip_space(buf, len, i)) < len) {
+    if ((err = parse_u64_at(buf, len, &i, UINT32_MAX, &freq))) {
+      return err;
+    }
+    sep = i;
+    i = skip_blanks(buf, len, i);
+    if (i == sep) {
+      return EINVAL;
+    }
+    if ((err = parse_u64_at(buf, len, &i, UINT64_MAX, &time))) {
+      return err;
+    }
+    i = skip_blanks(buf, len, i);
+    if (!at_eol(buf, len, i)) {
+      return EINVAL;
+    }
+    if (*n == max) {
+      return ERANGE;
+    }
+    freqs[*n] = (uint32_t) freq;
+    times[*n] = time;
+    (*n)++;
+  }
+  return 0;
+}
+
+int cpufreq_bindings_parse_trans_table(const char* buf, size_t len, uint32_t* freqs, uint32_t* counts, uint32_t max,
+                                       uint32_t* n) {
+  const char* nl;
+  uint64_t v;
+  size_t i;
+  uint32_t nfreqs = 0;
+  uint32_t from;
+  uint32_t to;
+  int err;
+  *n = 0;
+  // skip the "From : To" line
+  if ((nl = memchr(buf, '\n', len)) == NULL) {
+    return EINVAL;
+  }
+  // the frequencies, after a ':' that lines up with the one on each row
+  i = skip_blanks(buf, len, (size_t) (nl - buf) + 1);
+  if (i == len || buf[i] != ':') {
+    return EINVAL;
+  }
+  for (i = skip_blanks(buf, len, i + 1); !at_eol(buf, len, i); i = skip_blanks(buf, len, i)) {
+    if (nfreqs == max) {
+      return ERANGE;
+    }
+    if ((err = parse_u64_at(buf, len, &i, UINT32_MAX, &v))) {
+      return err;
+    }
+    freqs[nfreqs++] = (uint32_t) v;
+  }
+  // one row per frequency, in the same order
+  for (from = 0; from < nfreqs; from++) {
+    i = skip_space(buf, len, i);
+    if ((err = parse_u64_at(buf, len, &i, UINT32_MAX, &v))) {
+      return err;
+    }
+    if (v != freqs[from] || i == len || buf[i] != ':') {
+      return EINVAL;
+    }
+    i++;
+    for (to = 0; to < nfreqs; to++) {
+      i = skip_blanks(buf, len, i);
+      if ((err = parse_u64_at(buf, len, &i, UINT32_MAX, &v))) {
+        return err;
+      }
+      counts[(size_t) from * nfreqs + to] = (uint32_t) v;
+    }
+    i = skip_blanks(buf, len, i);
+    if (!at_eol(buf, len, i)) {
+      return EINVAL;
+    }
+  }
+  *n = nfreqs;
+  return 0;
+}
@@ -0,0 +1,108 @@
+/**
+ * Allocation-free parsers for sysfs file contents.
+ * Array parsers are incremental so files can be parsed in chunks as they are read.
+ *
+ * @author Connor Imes
+ * @date 2026-10-15
+ */
+#ifndef _CPUFREQ_BINDINGS_PARSE_H_
+#define _CPUFREQ_BINDINGS_PARSE_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <inttypes.h>
+#include <stddef.h>
+
+// sysfs files are limited to a page, so most files are parsed in a single chunk
+#define PARSE_CHUNK_LEN 4096
+
+/**
+ * Parse a single decimal value, terminated by whitespace, a NULL character, or the end of the buffer.
+ *
+ * @return 0 on success, or an errno value on failure
+ */
+int cpufreq_bindings_parse_u32(const char* buf, size_t len, uint32_t* val);
+
+/**
+ * Parser for lists of decimal values separated by whitespace or commas, e.g., "0 1 2 3" or "0-3,8-11".
+ * Ranges ("a-b") are expanded into their individual values.
+ */
+typedef struct cpufreq_bindings_u32arr_parser {
+  uint32_t* arr;
+  uint32_t len;
+  uint32_t n;
+  uint64_t val;
+  uint32_t range_start;
+  uint32_t ndigits;
+  int in_range;
+  // errno value
+  int err;
+} cpufreq_bindings_u32arr_parser;
+
+void cpufreq_bindings_u32arr_parser_init(cpufreq_bindings_u32arr_parser* p, uint32_t* arr, uint32_t len);
+
+/**
+ * @return 0 on success, or an errno value on failure (EINVAL for malformed input, ERANGE if the array is too small)
+ */
+int cpufreq_bindings_u32arr_parse(cpufreq_bindings_u32arr_parser* p, const char* buf, size_t len);
+
+/**
+ * @return the number of values parsed, or 0 on failure (errno will be set)
+ */
+uint32_t cpufreq_bindings_u32arr_parser_finish(cpufreq_bindings_u32arr_parser* p);
+
+/**
+ * Parser for whitespace-separated strings, written to a 2D char array (like strncpy for each entry).
+ */
+typedef struct cpufreq_bindings_strarr_parser {
+  char* arr;
+  size_t len;
+  size_t width;
+  size_t n;
+  size_t pos;
+  int err;
+} cpufreq_bindings_strarr_parser;
+
+void cpufreq_bindings_strarr_parser_init(cpufreq_bindings_strarr_parser* p, char* arr, size_t len, size_t width);
+
+/**
+ * @return 0 on success, or an errno value on failure (ERANGE if the array is too small)
+ */
+int cpufreq_bindings_strarr_parse(cpufreq_bindings_strarr_parser* p, const char* buf, size_t len);
+
+/**
+ * @return the number of strings parsed, or 0 on failure (errno will be set)
+ */
+uint32_t cpufreq_bindings_strarr_parser_finish(cpufreq_bindings_strarr_parser* p);
+
+/**
+ * Parse "stats/time_in_state": one "<frequency> <time>" pair per line.
+ * Unlike the array parsers, the buffer must hold the whole file.
+ *
+ * @param n
+ *  The number of pairs parsed
+ * @return 0 on success, or an errno value on failure (EINVAL for malformed input, ERANGE if the arrays are too small)
+ */
+int cpufreq_bindings_parse_time_in_state(const char* buf, size_t len, uint32_t* freqs, uint64_t* times, uint32_t max,
+                                         uint32_t* n);
+
+/**
+ * Parse "stats/trans_table": a header line, a line of the N frequencies, then one line per frequency of N transition
+ * counts ("<from>: <count to freqs[0]> ... <count to freqs[N - 1]>").
+ * Counts are written row-major, i.e., counts[from * N + to], so "counts" must have room for max * max values.
+ * Unlike the array parsers, the buffer must hold the whole file.
+ *
+ * @param n
+ *  The number of frequencies parsed
+ * @return 0 on success, or an errno value on failure (EINVAL for malformed input, ERANGE if the arrays are too small)
+ */
+int cpufreq_bindings_parse_trans_table(const char* buf, size_t len, uint32_t* freqs, uint32_t* counts, uint32_t max,
+                                       uint32_t* n);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,390 @@
+/**
+ * Frequency plans: diff desired policy settings against current ones and write the difference in a safe order.
+ *
+ * Each limit write either widens or narrows a policy's range.
+ * Widening writes are always accepted, and once a range is as wide as both the old and new ranges, narrowing it to the
+ * new range is always accepted too, so all policies can be written in four batches: raise max, lower min, lower max,
+ * raise min.
+ * Rollback uses the same steps with the original settings as the target.
+ *
+ * @author Connor Imes
+ * @date 2026-10-15
+ */
+#include <errno.h>
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+#include "cpufreq-bindings.h"
+#include "cpufreq-bindings-common.h"
+#include "cpufreq-bindings-ctx.h"
+#include "cpufreq-bindings-plan.h"
+
+#define PLAN_NONE UINT32_MAX
+
+typedef struct plan_entry {
+  uint32_t policy;
+  // requested settings - 0 or "" to leave unchanged
+  uint32_t min_freq;
+  uint32_t max_freq;
+  char governor[CPUFREQ_BINDINGS_PLAN_GOVERNOR_LEN];
+  // state during apply
+  uint32_t rep;
+  uint32_t orig_min;
+  uint32_t orig_max;
+  uint32_t cur_min;
+  uint32_t cur_max;
+  char orig_governor[CPUFREQ_BINDINGS_PLAN_GOVERNOR_LEN];
+  int governor_written;
+} plan_entry;
+
+struct cpufreq_bindings_plan {
+  cpufreq_bindings_ctx* ctx;
+  plan_entry* entries;
+  uint32_t nentries;
+  uint32_t capacity;
+  // batch scratch space - "vals" and "status" have length 2 * capacity for reading both limits
+  uint32_t* cores;
+  uint32_t* vals;
+  int* status;
+  plan_entry** batch;
+};
+
+static const cpufreq_bindings_file PLAN_LIMIT_FILES[2] = {
+  CPUFREQ_BINDINGS_FILE_SCALING_MIN_FREQ,
+  CPUFREQ_BINDINGS_FILE_SCALING_MAX_FREQ
+};
+
+// the order of limit writes: widen first, then narrow
+typedef struct plan_step {
+  cpufreq_bindings_file file;
+  int widen;
+} plan_step;
+
+static const plan_step PLAN_STEPS[4] = {
+  { CPUFREQ_BINDINGS_FILE_SCALING_MAX_FREQ, 1 },
+  { CPUFREQ_BINDINGS_FILE_SCALING_MIN_FREQ, 1 },
+  { CPUFREQ_BINDINGS_FILE_SCALING_MAX_FREQ, 0 },
+  { CPUFREQ_BINDINGS_FILE_SCALING_MIN_FREQ, 0 }
+};
+
+cpufreq_bindings_plan* cpufreq_bindings_plan_init(cpufreq_bindings_ctx* ctx) {
+  cpufreq_bindings_plan* plan;
+  if (ctx == NULL) {
+    errno = EINVAL;
+    return NULL;
+  }
+  if ((plan = calloc(1, sizeof(cpufreq_bindings_plan))) == NULL) {
+    return NULL;
+  }
+  plan->ctx = ctx;
+  return plan;
+}
+
+void cpufreq_bindings_plan_destroy(cpufreq_bindings_plan* plan) {
+  if (plan != NULL) {
+    free(plan->entries);
+    free(plan->cores);
+    free(plan->vals);
+    free(plan->status);
+    free(plan->batch);
+    free(plan);
+  }
+}
+
+void cpufreq_bindings_plan_clear(cpufreq_bindings_plan* plan) {
+  plan->nentries = 0;
+}
+
+static int plan_grow(cpufreq_bindings_plan* plan) {
+  uint32_t capacity = plan->capacity == 0 ? 8 : plan->capacity * 2;
+  void* tmp;
+  // on failure, arrays that were already grown are just larger than needed
+  if ((tmp = realloc(plan->entries, capacity * sizeof(plan_entry))) == NULL) {
+    return -1;
+  }
+  plan->entries = tmp;
+  if ((tmp = realloc(plan->cores, capacity * sizeof(uint32_t))) == NULL) {
+    return -1;
+  }
+  plan->cores = tmp;
+  if ((tmp = realloc(plan->vals, 2 * capacity * sizeof(uint32_t))) == NULL) {
+    return -1;
+  }
+  plan->vals = tmp;
+  if ((tmp = realloc(plan->status, 2 * capacity * sizeof(int))) == NULL) {
+    return -1;
+  }
+  plan->status = tmp;
+  if ((tmp = realloc(plan->batch, capacity * sizeof(plan_entry*))) == NULL) {
+    return -1;
+  }
+  plan->batch = tmp;
+  plan->capacity = capacity;
+  return 0;
+}
+
+static int plan_set(cpufreq_bindings_plan* plan, uint32_t policy, uint32_t min_freq, uint32_t max_freq,
+                    const char* governor) {
+  plan_entry* e = NULL;
+  uint32_t i;
+  if (governor != NULL && (governor[0] == '\0' || strlen(governor) >= CPUFREQ_BINDINGS_PLAN_GOVERNOR_LEN)) {
+    errno = EINVAL;
+    return -1;
+  }
+  for (i = 0; i < plan->nentries; i++) {
+    if (plan->entries[i].policy == policy) {
+      e = &plan->entries[i];
+      break;
+    }
+  }
+  if (e == NULL) {
+    if (plan->nentries == plan->capacity && plan_grow(plan)) {
+      return -1;
+    }
+    e = &plan->entries[plan->nentries++];
+    memset(e, 0, sizeof(*e));
+    e->policy = policy;
+  }
+  if (min_freq > 0) {
+    e->min_freq = min_freq;
+  }
+  if (max_freq > 0) {
+    e->max_freq = max_freq;
+  }
+  if (governor != NULL) {
+    strcpy(e->governor, governor);
+  }
+  return 0;
+}
+
+int cpufreq_bindings_plan_set(cpufreq_bindings_plan* plan, uint32_t core, uint32_t min_freq, uint32_t max_freq,
+                              const char* governor) {
+  uint32_t policy;
+  if (cpufreq_bindings_ctx_get_core_policy(plan->ctx, core, &policy)) {
+    return -1;
+  }
+  return plan_set(plan, policy, min_freq, max_freq, governor);
+}
+
+static uint32_t policy_idx(const cpufreq_bindings_policies* p, uint32_t policy) {
+  uint32_t lo = 0;
+  uint32_t hi = p->npolicies;
+  uint32_t mid;
+  // "ids" is sorted
+  while (lo < hi) {
+    mid = lo + (hi - lo) / 2;
+    if (p->ids[mid] == policy) {
+      return mid;
+    }
+    if (p->ids[mid] < policy) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return PLAN_NONE;
+}
+
+int cpufreq_bindings_plan_set_policy(cpufreq_bindings_plan* plan, uint32_t policy, uint32_t min_freq,
+                                     uint32_t max_freq, const char* governor) {
+  const cpufreq_bindings_policies* p;
+  uint32_t idx;
+  if ((p = cpufreq_bindings_ctx_policies(plan->ctx)) == NULL) {
+    return -1;
+  }
+  idx = policy_idx(p, policy);
+  cpufreq_bindings_ctx_policies_release(plan->ctx);
+  if (idx == PLAN_NONE) {
+    errno = ENOENT;
+    return -1;
+  }
+  return plan_set(plan, policy, min_freq, max_freq, governor);
+}
+
+static int has_limits(const plan_entry* e) {
+  return e->min_freq > 0 || e->max_freq > 0;
+}
+
+static uint32_t target_limit(const plan_entry* e, cpufreq_bindings_file file, int rollback) {
+  if (file == CPUFREQ_BINDINGS_FILE_SCALING_MAX_FREQ) {
+    return rollback || e->max_freq == 0 ? e->orig_max : e->max_freq;
+  }
+  return rollback || e->min_freq == 0 ? e->orig_min : e->min_freq;
+}
+
+// write limits toward their targets, returning 0 or the first errno value
+// when not rolling back, stop after the first step with a failure; when rolling back, make as much progress as possible
+static int move_limits(cpufreq_bindings_plan* plan, int rollback, cpufreq_bindings_plan_result* r) {
+  const plan_step* step;
+  plan_entry* e;
+  uint32_t* cur;
+  uint32_t target;
+  uint32_t n;
+  uint32_t i;
+  uint32_t s;
+  int err = 0;
+  for (s = 0; s < sizeof(PLAN_STEPS) / sizeof(PLAN_STEPS[0]); s++) {
+    step = &PLAN_STEPS[s];
+    n = 0;
+    for (i = 0; i < plan->nentries; i++) {
+      e = &plan->entries[i];
+      if (!has_limits(e)) {
+        continue;
+      }
+      cur = step->file == CPUFREQ_BINDINGS_FILE_SCALING_MAX_FREQ ? &e->cur_max : &e->cur_min;
+      target = target_limit(e, step->file, rollback);
+      if (target == *cur ||
+          step->widen != (step->file == CPUFREQ_BINDINGS_FILE_SCALING_MAX_FREQ ? target > *cur : target < *cur)) {
+        continue;
+      }
+      plan->batch[n] = e;
+      plan->cores[n] = e->rep;
+      plan->vals[n] = target;
+      n++;
+    }
+    if (n == 0) {
+      continue;
+    }
+    cpufreq_bindings_ctx_u32_batch(plan->ctx, &step->file, 1, plan->cores, n, plan->vals, NULL, plan->status);
+    for (i = 0; i < n; i++) {
+      e = plan->batch[i];
+      if (plan->status[i] == 0) {
+        *(step->file == CPUFREQ_BINDINGS_FILE_SCALING_MAX_FREQ ? &e->cur_max : &e->cur_min) = plan->vals[i];
+        if (!rollback) {
+          r->writes++;
+        }
+      } else if (err == 0) {
+        err = plan->status[i];
+        if (!rollback) {
+          r->failed_policy = e->policy;
+        }
+      }
+    }
+    if (err && !rollback) {
+      break;
+    }
+  }
+  return err;
+}
+
+// undo successful writes, returning 1 if everything was restored
+static int rollback(cpufreq_bindings_plan* plan, cpufreq_bindings_plan_result* r) {
+  plan_entry* e;
+  uint32_t i;
+  int ok = !move_limits(plan, 1, r);
+  for (i = 0; i < plan->nentries; i++) {
+    e = &plan->entries[i];
+    if (e->governor_written &&
+        cpufreq_bindings_ctx_set_scaling_governor(plan->ctx, e->rep, e->orig_governor, strlen(e->orig_governor)) < 0) {
+      ok = 0;
+    }
+  }
+  return ok;
+}
+
+// read current settings and validate targets, returning 0 or an errno value
+static int plan_prepare(cpufreq_bindings_plan* plan, cpufreq_bindings_plan_result* r) {
+  const cpufreq_bindings_policies* p;
+  plan_entry* e;
+  uint32_t idx;
+  uint32_t n = 0;
+  uint32_t i;
+  if ((p = cpufreq_bindings_ctx_policies(plan->ctx)) == NULL) {
+    return errno;
+  }
+  for (i = 0; i < plan->nentries; i++) {
+    e = &plan->entries[i];
+    e->governor_written = 0;
+    // policies may have changed since the entry was added
+    if ((idx = policy_idx(p, e->policy)) == PLAN_NONE) {
+      cpufreq_bindings_ctx_policies_release(plan->ctx);
+      r->failed_policy = e->policy;
+      return ENOENT;
+    }
+    e->rep = p->reps[idx];
+    if (has_limits(e)) {
+      plan->batch[n] = e;
+      plan->cores[n] = e->rep;
+      n++;
+    }
+  }
+  cpufreq_bindings_ctx_policies_release(plan->ctx);
+  if (n > 0) {
+    cpufreq_bindings_ctx_u32_batch(plan->ctx, PLAN_LIMIT_FILES, 2, plan->cores, n, NULL, plan->vals, plan->status);
+  }
+  for (i = 0; i < n; i++) {
+    e = plan->batch[i];
+    if (plan->status[2 * i] || plan->status[2 * i + 1]) {
+      r->failed_policy = e->policy;
+      return plan->status[2 * i] ? plan->status[2 * i] : plan->status[2 * i + 1];
+    }
+    e->orig_min = e->cur_min = plan->vals[2 * i];
+    e->orig_max = e->cur_max = plan->vals[2 * i + 1];
+    if (target_limit(e, CPUFREQ_BINDINGS_FILE_SCALING_MIN_FREQ, 0) >
+        target_limit(e, CPUFREQ_BINDINGS_FILE_SCALING_MAX_FREQ, 0)) {
+      r->failed_policy = e->policy;
+      return EINVAL;
+    }
+    r->elided += (e->min_freq == e->orig_min) + (e->max_freq == e->orig_max);
+  }
+  for (i = 0; i < plan->nentries; i++) {
+    e = &plan->entries[i];
+    if (e->governor[0] == '\0') {
+      continue;
+    }
+    memset(e->orig_governor, 0, sizeof(e->orig_governor));
+    if (cpufreq_bindings_ctx_get_scaling_governor(plan->ctx, e->rep, e->orig_governor,
+                                                  sizeof(e->orig_governor) - 1) <= 0) {
+      r->failed_policy = e->policy;
+      return errno;
+    }
+    if (!strcmp(e->governor, e->orig_governor)) {
+      r->elided++;
+    }
+  }
+  return 0;
+}
+
+int cpufreq_bindings_plan_apply(cpufreq_bindings_plan* plan, cpufreq_bindings_plan_result* result) {
+  cpufreq_bindings_plan_result r;
+  plan_entry* e;
+  uint32_t i;
+  int err;
+  memset(&r, 0, sizeof(r));
+  r.failed_policy = PLAN_NONE;
+  r.rolled_back = 1;
+  if ((err = plan_prepare(plan, &r)) == 0) {
+    for (i = 0; i < plan->nentries; i++) {
+      e = &plan->entries[i];
+      if (e->governor[0] == '\0' || !strcmp(e->governor, e->orig_governor)) {
+        continue;
+      }
+      if (cpufreq_bindings_ctx_set_scaling_governor(plan->ctx, e->rep, e->governor, strlen(e->governor)) < 0) {
+        err = errno;
+        r.failed_policy = e->policy;
+        break;
+      }
+      e->governor_written = 1;
+      r.writes++;
+    }
+    if (err == 0) {
+      err = move_limits(plan, 0, &r);
+    }
+    if (err) {
+      LOG(WARN, "cpufreq_bindings_plan_apply: write to policy %"PRIu32" failed: %s\n", r.failed_policy,
+          strerror(err));
+      r.rolled_back = rollback(plan, &r);
+      if (!r.rolled_back) {
+        LOG(ERROR, "cpufreq_bindings_plan_apply: rollback failed\n");
+      }
+    }
+  }
+  if (result != NULL) {
+    *result = r;
+  }
+  if (err) {
+    errno = err;
+    return -1;
+  }
+  return 0;
+}
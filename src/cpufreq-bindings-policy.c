@@ -0,0 +1,433 @@
+/**
+ * Discover cpufreq policies (groups of cores that share frequency settings) and deduplicate writes to them.
+ *
+ * @author Connor Imes
+ * @date 2026-10-15
+ */
+// for opendir, readdir
+#define _POSIX_C_SOURCE 200809L
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "cpufreq-bindings.h"
+#include "cpufreq-bindings-common.h"
+#include "cpufreq-bindings-ctx.h"
+
+#define POLICY_DIR "/devices/system/cpu/cpufreq"
+
+// the largest CONFIG_NR_CPUS supported by the kernel
+#define RELATED_CPUS_MAX 8192
+
+#define NO_POLICY UINT32_MAX
+
+void cpufreq_bindings_policies_free(cpufreq_bindings_policies* policies) {
+  if (policies != NULL) {
+    free(policies->ids);
+    free(policies->reps);
+    free(policies->core_idx);
+    free(policies);
+  }
+}
+
+static int cmp_u32(const void* a, const void* b) {
+  uint32_t x = *(const uint32_t*) a;
+  uint32_t y = *(const uint32_t*) b;
+  return x < y ? -1 : x > y ? 1 : 0;
+}
+
+static uint32_t read_policy_cpus(uint32_t policy, cpufreq_bindings_file file, uint32_t* cpus, uint32_t len) {
+  uint32_t n;
+  int fd;
+  if ((fd = cpufreq_bindings_policy_file_open(policy, file, O_RDONLY)) < 0) {
+    return 0;
+  }
+  n = file == CPUFREQ_BINDINGS_FILE_RELATED_CPUS ? cpufreq_bindings_get_related_cpus(fd, policy, cpus, len) :
+                                                   cpufreq_bindings_get_affected_cpus(fd, policy, cpus, len);
+  cpufreq_bindings_file_close(fd);
+  return n;
+}
+
+// prefer online cores ("affected_cpus") as representatives, since offline cores have no cpufreq directory
+static void assign_cores(uint32_t id, const uint32_t* related, uint32_t nrelated, const uint32_t* affected,
+                         uint32_t naffected, uint32_t ncores, uint32_t* core_id, uint32_t* core_online) {
+  uint32_t i;
+  for (i = 0; i < nrelated; i++) {
+    if (related[i] < ncores) {
+      core_id[related[i]] = id;
+    }
+  }
+  for (i = 0; i < naffected; i++) {
+    if (affected[i] < ncores) {
+      core_online[affected[i]] = 1;
+    }
+  }
+}
+
+static int parse_policy_name(const char* name, uint32_t* id) {
+  char* end;
+  unsigned long val;
+  if (strncmp(name, "policy", 6) || name[6] < '0' || name[6] > '9') {
+    return -1;
+  }
+  val = strtoul(&name[6], &end, 10);
+  if (*end != '\0' || val > UINT32_MAX) {
+    return -1;
+  }
+  *id = (uint32_t) val;
+  return 0;
+}
+
+static int discover_from_policy_dirs(uint32_t ncores, uint32_t* related, uint32_t* affected, uint32_t* core_id,
+                                     uint32_t* core_online) {
+  char path[SYSFS_PATH_MAX_LEN];
+  struct dirent* ent;
+  DIR* dir;
+  uint32_t nrelated;
+  uint32_t naffected;
+  uint32_t id;
+  int found = 0;
+  if (cpufreq_bindings_sysfs_path(path, sizeof(path), POLICY_DIR) || (dir = opendir(path)) == NULL) {
+    return -1;
+  }
+  while ((ent = readdir(dir)) != NULL) {
+    if (parse_policy_name(ent->d_name, &id)) {
+      continue;
+    }
+    if ((nrelated = read_policy_cpus(id, CPUFREQ_BINDINGS_FILE_RELATED_CPUS, related, RELATED_CPUS_MAX)) > 0) {
+      naffected = read_policy_cpus(id, CPUFREQ_BINDINGS_FILE_AFFECTED_CPUS, affected, RELATED_CPUS_MAX);
+      assign_cores(id, related, nrelated, affected, naffected, ncores, core_id, core_online);
+      found = 1;
+    }
+  }
+  closedir(dir);
+  return found ? 0 : -1;
+}
+
+// older kernels don't have policy directories - the policy is named after its first related core
+static void discover_from_cores(cpufreq_bindings_ctx* ctx, uint32_t* related, uint32_t* affected, uint32_t* core_id,
+                                uint32_t* core_online) {
+  uint32_t nrelated;
+  uint32_t naffected;
+  uint32_t core;
+  uint32_t i;
+  uint32_t id;
+  for (core = 0; core < ctx->ncores; core++) {
+    if (core_id[core] != NO_POLICY) {
+      continue;
+    }
+    if ((nrelated = cpufreq_bindings_ctx_get_related_cpus(ctx, core, related, RELATED_CPUS_MAX)) > 0) {
+      naffected = cpufreq_bindings_ctx_get_affected_cpus(ctx, core, affected, RELATED_CPUS_MAX);
+      for (i = 0, id = related[0]; i < nrelated; i++) {
+        if (related[i] < id) {
+          id = related[i];
+        }
+      }
+      assign_cores(id, related, nrelated, affected, naffected, ctx->ncores, core_id, core_online);
+    }
+  }
+}
+
+static int build_index(cpufreq_bindings_policies* p, uint32_t ncores, const uint32_t* core_id,
+                       const uint32_t* core_online) {
+  uint32_t* found;
+  uint32_t core;
+  uint32_t i;
+  uint32_t n = 0;
+  // collect unique policy numbers
+  for (core = 0; core < ncores; core++) {
+    if (core_id[core] != NO_POLICY) {
+      p->ids[n++] = core_id[core];
+    }
+  }
+  if (n == 0) {
+    errno = ENODEV;
+    return -1;
+  }
+  qsort(p->ids, n, sizeof(uint32_t), cmp_u32);
+  for (i = 1, p->npolicies = 1; i < n; i++) {
+    if (p->ids[i] != p->ids[p->npolicies - 1]) {
+      p->ids[p->npolicies++] = p->ids[i];
+    }
+  }
+  for (i = 0; i < p->npolicies; i++) {
+    p->reps[i] = NO_POLICY;
+  }
+  // map cores to policies, choosing the lowest online core as the representative
+  for (core = 0; core < ncores; core++) {
+    if (core_id[core] == NO_POLICY) {
+      p->core_idx[core] = NO_POLICY;
+      continue;
+    }
+    found = bsearch(&core_id[core], p->ids, p->npolicies, sizeof(uint32_t), cmp_u32);
+    p->core_idx[core] = (uint32_t) (found - p->ids);
+    if (p->reps[p->core_idx[core]] == NO_POLICY ||
+        (core_online[core] && !core_online[p->reps[p->core_idx[core]]])) {
+      p->reps[p->core_idx[core]] = core;
+    }
+  }
+  return 0;
+}
+
+static cpufreq_bindings_policies* discover(cpufreq_bindings_ctx* ctx) {
+  cpufreq_bindings_policies* p;
+  uint32_t* related = malloc(2 * RELATED_CPUS_MAX * sizeof(uint32_t));
+  uint32_t* core_id = malloc(ctx->ncores * sizeof(uint32_t));
+  uint32_t* core_online = calloc(ctx->ncores, sizeof(uint32_t));
+  uint32_t core;
+  int err_save;
+  if ((p = calloc(1, sizeof(cpufreq_bindings_policies))) != NULL) {
+    p->ids = malloc(ctx->ncores * sizeof(uint32_t));
+    p->reps = malloc(ctx->ncores * sizeof(uint32_t));
+    p->core_idx = malloc(ctx->ncores * sizeof(uint32_t));
+  }
+  if (related == NULL || core_id == NULL || core_online == NULL || p == NULL || p->ids == NULL || p->reps == NULL ||
+      p->core_idx == NULL) {
+    goto fail;
+  }
+  for (core = 0; core < ctx->ncores; core++) {
+    core_id[core] = NO_POLICY;
+  }
+  if (discover_from_policy_dirs(ctx->ncores, related, &related[RELATED_CPUS_MAX], core_id, core_online)) {
+    LOG(DEBUG, "discover: %s not available, using per-core related_cpus\n", POLICY_DIR);
+    discover_from_cores(ctx, related, &related[RELATED_CPUS_MAX], core_id, core_online);
+  }
+  if (build_index(p, ctx->ncores, core_id, core_online)) {
+    goto fail;
+  }
+  free(related);
+  free(core_id);
+  free(core_online);
+  return p;
+
+fail:
+  err_save = errno;
+  if (p != NULL) {
+    cpufreq_bindings_policies_free(p);
+  }
+  free(related);
+  free(core_id);
+  free(core_online);
+  errno = err_save;
+  return NULL;
+}
+
+// frees retired tables if there are no readers - "policy_lock" must be held
+static void free_retired(cpufreq_bindings_ctx* ctx) {
+  cpufreq_bindings_policies* p;
+  cpufreq_bindings_policies* next;
+  // readers register before loading the table, so once there are none, none can still hold a retired table
+  if (__atomic_load_n(&ctx->policy_readers, __ATOMIC_SEQ_CST) > 0) {
+    return;
+  }
+  p = __atomic_exchange_n(&ctx->retired, NULL, __ATOMIC_SEQ_CST);
+  for (; p != NULL; p = next) {
+    next = p->next;
+    cpufreq_bindings_policies_free(p);
+  }
+}
+
+cpufreq_bindings_policies* cpufreq_bindings_ctx_policies(cpufreq_bindings_ctx* ctx) {
+  cpufreq_bindings_policies* expected = NULL;
+  cpufreq_bindings_policies* p;
+  __atomic_add_fetch(&ctx->policy_readers, 1, __ATOMIC_SEQ_CST);
+  if ((p = __atomic_load_n(&ctx->policies, __ATOMIC_SEQ_CST)) != NULL) {
+    return p;
+  }
+  if ((p = discover(ctx)) == NULL) {
+    cpufreq_bindings_ctx_policies_release(ctx);
+    return NULL;
+  }
+  if (!__atomic_compare_exchange_n(&ctx->policies, &expected, p, 0, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST)) {
+    // another thread won the race
+    cpufreq_bindings_policies_free(p);
+    p = expected;
+  }
+  return p;
+}
+
+void cpufreq_bindings_ctx_policies_release(cpufreq_bindings_ctx* ctx) {
+  int err_save = errno;
+  // the last reader frees tables retired while it was reading
+  if (__atomic_sub_fetch(&ctx->policy_readers, 1, __ATOMIC_SEQ_CST) == 0 &&
+      __atomic_load_n(&ctx->retired, __ATOMIC_SEQ_CST) != NULL) {
+    pthread_mutex_lock(&ctx->policy_lock);
+    free_retired(ctx);
+    pthread_mutex_unlock(&ctx->policy_lock);
+  }
+  errno = err_save;
+}
+
+void cpufreq_bindings_ctx_policies_free(cpufreq_bindings_ctx* ctx) {
+  cpufreq_bindings_policies_free(ctx->policies);
+  free_retired(ctx);
+}
+
+static uint32_t find_policy(const cpufreq_bindings_policies* p, uint32_t policy) {
+  const uint32_t* found = bsearch(&policy, p->ids, p->npolicies, sizeof(uint32_t), cmp_u32);
+  return found == NULL ? NO_POLICY : (uint32_t) (found - p->ids);
+}
+
+int cpufreq_bindings_ctx_refresh_policies(cpufreq_bindings_ctx* ctx) {
+  cpufreq_bindings_policies* p;
+  if ((p = discover(ctx)) == NULL) {
+    return -1;
+  }
+  pthread_mutex_lock(&ctx->policy_lock);
+  // other threads may still be reading the old table, so retire it until they're done
+  if ((p = __atomic_exchange_n(&ctx->policies, p, __ATOMIC_SEQ_CST)) != NULL) {
+    p->next = __atomic_load_n(&ctx->retired, __ATOMIC_RELAXED);
+    __atomic_store_n(&ctx->retired, p, __ATOMIC_SEQ_CST);
+  }
+  free_retired(ctx);
+  pthread_mutex_unlock(&ctx->policy_lock);
+  return 0;
+}
+
+uint32_t cpufreq_bindings_ctx_get_policies(cpufreq_bindings_ctx* ctx, uint32_t* policies, uint32_t len) {
+  const cpufreq_bindings_policies* p;
+  uint32_t n = 0;
+  if ((p = cpufreq_bindings_ctx_policies(ctx)) == NULL) {
+    return 0;
+  }
+  if (p->npolicies > len) {
+    errno = ERANGE;
+  } else {
+    memcpy(policies, p->ids, p->npolicies * sizeof(uint32_t));
+    n = p->npolicies;
+  }
+  cpufreq_bindings_ctx_policies_release(ctx);
+  return n;
+}
+
+int cpufreq_bindings_ctx_get_core_policy(cpufreq_bindings_ctx* ctx, uint32_t core, uint32_t* policy) {
+  const cpufreq_bindings_policies* p;
+  int ret = 0;
+  if ((p = cpufreq_bindings_ctx_policies(ctx)) == NULL) {
+    return -1;
+  }
+  if (core >= ctx->ncores || p->core_idx[core] == NO_POLICY) {
+    errno = EINVAL;
+    ret = -1;
+  } else {
+    *policy = p->ids[p->core_idx[core]];
+  }
+  cpufreq_bindings_ctx_policies_release(ctx);
+  return ret;
+}
+
+static uint32_t policy_cpus(const cpufreq_bindings_ctx* ctx, const cpufreq_bindings_policies* p, uint32_t policy,
+                            uint32_t* cpus, uint32_t len) {
+  uint32_t idx;
+  uint32_t core;
+  uint32_t n = 0;
+  if ((idx = find_policy(p, policy)) == NO_POLICY) {
+    errno = EINVAL;
+    return 0;
+  }
+  for (core = 0; core < ctx->ncores; core++) {
+    if (p->core_idx[core] == idx) {
+      if (n == len) {
+        // the array wasn't big enough
+        errno = ERANGE;
+        return 0;
+      }
+      cpus[n++] = core;
+    }
+  }
+  return n;
+}
+
+uint32_t cpufreq_bindings_ctx_get_policy_cpus(cpufreq_bindings_ctx* ctx, uint32_t policy, uint32_t* cpus,
+                                              uint32_t len) {
+  const cpufreq_bindings_policies* p;
+  uint32_t n;
+  if ((p = cpufreq_bindings_ctx_policies(ctx)) == NULL) {
+    return 0;
+  }
+  n = policy_cpus(ctx, p, policy, cpus, len);
+  cpufreq_bindings_ctx_policies_release(ctx);
+  return n;
+}
+
+int cpufreq_bindings_ctx_get_policy_fd(cpufreq_bindings_ctx* ctx, uint32_t policy, cpufreq_bindings_file file) {
+  const cpufreq_bindings_policies* p;
+  uint32_t idx;
+  uint32_t rep;
+  if ((p = cpufreq_bindings_ctx_policies(ctx)) == NULL) {
+    return -1;
+  }
+  idx = find_policy(p, policy);
+  rep = idx == NO_POLICY ? NO_POLICY : p->reps[idx];
+  cpufreq_bindings_ctx_policies_release(ctx);
+  if (rep == NO_POLICY) {
+    errno = EINVAL;
+    return -1;
+  }
+  // a core's cpufreq directory is a link to its policy directory
+  return cpufreq_bindings_ctx_get_fd(ctx, rep, file);
+}
+
+uint32_t cpufreq_bindings_ctx_set_u32_batch_by_policy(cpufreq_bindings_ctx* ctx, cpufreq_bindings_file file,
+                                                      const uint32_t* cores, uint32_t ncores, const uint32_t* vals,
+                                                      int* status) {
+  const cpufreq_bindings_policies* p;
+  uint32_t* slot;
+  uint32_t* reps;
+  uint32_t* pvals;
+  int* pstatus;
+  uint32_t npending = 0;
+  uint32_t n = 0;
+  uint32_t idx;
+  uint32_t i;
+  if (file != CPUFREQ_BINDINGS_FILE_SCALING_MAX_FREQ && file != CPUFREQ_BINDINGS_FILE_SCALING_MIN_FREQ &&
+      file != CPUFREQ_BINDINGS_FILE_SCALING_SETSPEED) {
+    errno = EINVAL;
+    return 0;
+  }
+  if ((p = cpufreq_bindings_ctx_policies(ctx)) == NULL ||
+      // slot per policy (NO_POLICY until requested), then per-write core, value, and status
+      (slot = malloc(p->npolicies * (3 * sizeof(uint32_t) + sizeof(int)))) == NULL) {
+    if (p != NULL) {
+      cpufreq_bindings_ctx_policies_release(ctx);
+    }
+    for (i = 0; i < ncores; i++) {
+      status[i] = errno;
+    }
+    return 0;
+  }
+  reps = &slot[p->npolicies];
+  pvals = &reps[p->npolicies];
+  pstatus = (int*) (void*) &pvals[p->npolicies];
+  for (i = 0; i < p->npolicies; i++) {
+    slot[i] = NO_POLICY;
+  }
+  // collapse requests to one write per policy - the last request for a policy wins
+  for (i = 0; i < ncores; i++) {
+    if (cores[i] >= ctx->ncores || (idx = p->core_idx[cores[i]]) == NO_POLICY) {
+      status[i] = EINVAL;
+      continue;
+    }
+    if (slot[idx] == NO_POLICY) {
+      slot[idx] = npending++;
+      reps[slot[idx]] = p->reps[idx];
+    }
+    pvals[slot[idx]] = vals[i];
+  }
+  cpufreq_bindings_ctx_u32_batch(ctx, &file, 1, reps, npending, pvals, NULL, pstatus);
+  for (i = 0; i < ncores; i++) {
+    if (cores[i] < ctx->ncores && (idx = p->core_idx[cores[i]]) != NO_POLICY) {
+      // earlier requests for a different value were never written
+      if ((status[i] = vals[i] == pvals[slot[idx]] ? pstatus[slot[idx]] : ECANCELED) == 0) {
+        n++;
+      }
+    }
+  }
+  cpufreq_bindings_ctx_policies_release(ctx);
+  free(slot);
+  return n;
+}
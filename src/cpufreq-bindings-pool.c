@@ -0,0 +1,275 @@
+/**
+ * A reusable worker pool that applies writes grouped by policy.
+ *
+ * An apply sorts the writes into tasks (one per policy, or per core if the policy is unknown), publishes them, and
+ * wakes the workers.
+ * The workers and the calling thread claim tasks with an atomic counter until none remain.
+ *
+ * @author Connor Imes
+ * @date 2026-10-15
+ */
+#include <errno.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include "cpufreq-bindings.h"
+#include "cpufreq-bindings-common.h"
+#include "cpufreq-bindings-ctx.h"
+#include "cpufreq-bindings-pool.h"
+
+// a write, keyed by the task it belongs to
+typedef struct pool_item {
+  uint32_t key;
+  uint32_t idx;
+} pool_item;
+
+typedef struct pool_task {
+  // the core whose files are written
+  uint32_t core;
+  // a range of the sorted items
+  uint32_t first;
+  uint32_t count;
+} pool_task;
+
+struct cpufreq_bindings_pool {
+  cpufreq_bindings_ctx* ctx;
+  pthread_t* threads;
+  uint32_t nthreads;
+  // serializes applies
+  pthread_mutex_t apply_lock;
+  // protects the fields below, which workers wait on
+  pthread_mutex_t lock;
+  pthread_cond_t work_cond;
+  pthread_cond_t done_cond;
+  uint64_t generation;
+  uint32_t busy;
+  int shutdown;
+  // the current apply
+  const cpufreq_bindings_write* writes;
+  int* status;
+  uint32_t next_task;
+  uint32_t ntasks;
+  // scratch, grown as needed
+  pool_item* items;
+  pool_task* tasks;
+  uint32_t capacity;
+};
+
+static void run_task(cpufreq_bindings_pool* pool, const pool_task* task) {
+  const pool_item* items = &pool->items[task->first];
+  cpufreq_bindings_file file;
+  uint32_t val;
+  uint32_t i;
+  uint32_t j;
+  int err;
+  for (i = 0; i < task->count; i = j) {
+    // collapse a run of writes to the same file into the last one
+    file = pool->writes[items[i].idx].file;
+    for (j = i + 1; j < task->count && pool->writes[items[j].idx].file == file; j++);
+    val = pool->writes[items[j - 1].idx].val;
+    err = cpufreq_bindings_ctx_u32_write(pool->ctx, task->core, file, val);
+    for (; i < j; i++) {
+      // an earlier write with a different value was never applied
+      pool->status[items[i].idx] = pool->writes[items[i].idx].val == val ? err : ECANCELED;
+    }
+  }
+}
+
+static void run_tasks(cpufreq_bindings_pool* pool) {
+  uint32_t t;
+  while ((t = __atomic_fetch_add(&pool->next_task, 1, __ATOMIC_RELAXED)) < pool->ntasks) {
+    run_task(pool, &pool->tasks[t]);
+  }
+}
+
+static void* pool_thread(void* arg) {
+  cpufreq_bindings_pool* pool = arg;
+  uint64_t generation = 0;
+  pthread_mutex_lock(&pool->lock);
+  for (;;) {
+    while (!pool->shutdown && pool->generation == generation) {
+      pthread_cond_wait(&pool->work_cond, &pool->lock);
+    }
+    if (pool->shutdown) {
+      break;
+    }
+    generation = pool->generation;
+    pthread_mutex_unlock(&pool->lock);
+    run_tasks(pool);
+    pthread_mutex_lock(&pool->lock);
+    if (--pool->busy == 0) {
+      pthread_cond_signal(&pool->done_cond);
+    }
+  }
+  pthread_mutex_unlock(&pool->lock);
+  return NULL;
+}
+
+static void pool_stop(cpufreq_bindings_pool* pool, uint32_t nstarted) {
+  uint32_t i;
+  pthread_mutex_lock(&pool->lock);
+  pool->shutdown = 1;
+  pthread_cond_broadcast(&pool->work_cond);
+  pthread_mutex_unlock(&pool->lock);
+  for (i = 0; i < nstarted; i++) {
+    pthread_join(pool->threads[i], NULL);
+  }
+}
+
+static void pool_free(cpufreq_bindings_pool* pool) {
+  pthread_cond_destroy(&pool->done_cond);
+  pthread_cond_destroy(&pool->work_cond);
+  pthread_mutex_destroy(&pool->lock);
+  pthread_mutex_destroy(&pool->apply_lock);
+  free(pool->threads);
+  free(pool->items);
+  free(pool->tasks);
+  free(pool);
+}
+
+cpufreq_bindings_pool* cpufreq_bindings_pool_init(cpufreq_bindings_ctx* ctx, uint32_t nthreads) {
+  cpufreq_bindings_pool* pool;
+  uint32_t i;
+  int ret;
+  if ((pool = calloc(1, sizeof(cpufreq_bindings_pool))) == NULL) {
+    return NULL;
+  }
+  if (nthreads > 0 && (pool->threads = malloc(nthreads * sizeof(pthread_t))) == NULL) {
+    free(pool);
+    return NULL;
+  }
+  pool->ctx = ctx;
+  pthread_mutex_init(&pool->apply_lock, NULL);
+  pthread_mutex_init(&pool->lock, NULL);
+  pthread_cond_init(&pool->work_cond, NULL);
+  pthread_cond_init(&pool->done_cond, NULL);
+  for (i = 0; i < nthreads; i++) {
+    if ((ret = pthread_create(&pool->threads[i], NULL, pool_thread, pool))) {
+      errno = ret;
+      PERROR(ERROR, "cpufreq_bindings_pool_init: pthread_create");
+      pool_stop(pool, i);
+      pool_free(pool);
+      errno = ret;
+      return NULL;
+    }
+  }
+  pool->nthreads = nthreads;
+  return pool;
+}
+
+int cpufreq_bindings_pool_destroy(cpufreq_bindings_pool* pool) {
+  pool_stop(pool, pool->nthreads);
+  pool_free(pool);
+  return 0;
+}
+
+static int cmp_item(const void* a, const void* b) {
+  const pool_item* x = a;
+  const pool_item* y = b;
+  // keep writes in their original order within a task
+  if (x->key != y->key) {
+    return x->key < y->key ? -1 : 1;
+  }
+  return x->idx < y->idx ? -1 : x->idx > y->idx ? 1 : 0;
+}
+
+static int pool_reserve(cpufreq_bindings_pool* pool, uint32_t nwrites) {
+  pool_item* items;
+  pool_task* tasks;
+  if (nwrites <= pool->capacity) {
+    return 0;
+  }
+  if ((items = realloc(pool->items, nwrites * sizeof(pool_item))) == NULL) {
+    return -1;
+  }
+  pool->items = items;
+  if ((tasks = realloc(pool->tasks, nwrites * sizeof(pool_task))) == NULL) {
+    return -1;
+  }
+  pool->tasks = tasks;
+  pool->capacity = nwrites;
+  return 0;
+}
+
+// sort valid writes into tasks, setting the status of invalid writes
+static void plan(cpufreq_bindings_pool* pool, const cpufreq_bindings_write* writes, uint32_t nwrites,
+                 int* status) {
+  const cpufreq_bindings_policies* p = cpufreq_bindings_ctx_policies(pool->ctx);
+  uint32_t ncores = cpufreq_bindings_ctx_get_ncores(pool->ctx);
+  uint32_t nitems = 0;
+  uint32_t core;
+  uint32_t i;
+  for (i = 0; i < nwrites; i++) {
+    core = writes[i].core;
+    if (core >= ncores) {
+      status[i] = EINVAL;
+      continue;
+    }
+    // policies sort before cores with unknown policies
+    pool->items[nitems].key = (p != NULL && p->core_idx[core] != UINT32_MAX) ? p->core_idx[core] : ncores + core;
+    pool->items[nitems].idx = i;
+    nitems++;
+  }
+  qsort(pool->items, nitems, sizeof(pool_item), cmp_item);
+  pool->ntasks = 0;
+  for (i = 0; i < nitems; i++) {
+    if (i == 0 || pool->items[i].key != pool->items[i - 1].key) {
+      core = pool->items[i].key >= ncores ? pool->items[i].key - ncores : p->reps[pool->items[i].key];
+      pool->tasks[pool->ntasks].core = core;
+      pool->tasks[pool->ntasks].first = i;
+      pool->tasks[pool->ntasks].count = 0;
+      pool->ntasks++;
+    }
+    pool->tasks[pool->ntasks - 1].count++;
+  }
+  if (p != NULL) {
+    cpufreq_bindings_ctx_policies_release(pool->ctx);
+  }
+}
+
+uint32_t cpufreq_bindings_pool_apply(cpufreq_bindings_pool* pool, const cpufreq_bindings_write* writes,
+                                     uint32_t nwrites, int* status) {
+  uint32_t n = 0;
+  uint32_t i;
+  int err_save = errno;
+  int wake;
+  pthread_mutex_lock(&pool->apply_lock);
+  if (pool_reserve(pool, nwrites)) {
+    pthread_mutex_unlock(&pool->apply_lock);
+    for (i = 0; i < nwrites; i++) {
+      status[i] = ENOMEM;
+    }
+    return 0;
+  }
+  plan(pool, writes, nwrites, status);
+  pool->writes = writes;
+  pool->status = status;
+  pool->next_task = 0;
+  // a single task is faster to run here than to hand off
+  wake = pool->nthreads > 0 && pool->ntasks > 1;
+  if (wake) {
+    pthread_mutex_lock(&pool->lock);
+    pool->busy = pool->nthreads;
+    pool->generation++;
+    pthread_cond_broadcast(&pool->work_cond);
+    pthread_mutex_unlock(&pool->lock);
+  }
+  run_tasks(pool);
+  if (wake) {
+    pthread_mutex_lock(&pool->lock);
+    while (pool->busy > 0) {
+      pthread_cond_wait(&pool->done_cond, &pool->lock);
+    }
+    pthread_mutex_unlock(&pool->lock);
+  }
+  pthread_mutex_unlock(&pool->apply_lock);
+  for (i = 0; i < nwrites; i++) {
+    if (status[i] == 0) {
+      n++;
+    }
+  }
+  // discovering policies may have failed harmlessly
+  errno = err_save;
+  return n;
+}
@@ -0,0 +1,172 @@
+/**
+ * Frequency residency snapshots and deltas.
+ *
+ * @author Connor Imes
+ * @date 2026-10-15
+ */
+// for clock_gettime
+#define _POSIX_C_SOURCE 200809L
+#include <errno.h>
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "cpufreq-bindings.h"
+#include "cpufreq-bindings-common.h"
+#include "cpufreq-bindings-ctx.h"
+#include "cpufreq-bindings-residency.h"
+
+cpufreq_bindings_residency* cpufreq_bindings_residency_alloc(uint32_t ncores, uint32_t nstates_max) {
+  cpufreq_bindings_residency* r;
+  size_t nstates = (size_t) ncores * nstates_max;
+  if (ncores == 0 || nstates_max == 0) {
+    errno = EINVAL;
+    return NULL;
+  }
+  if ((r = calloc(1, sizeof(cpufreq_bindings_residency))) == NULL) {
+    return NULL;
+  }
+  r->ncores = ncores;
+  r->nstates_max = nstates_max;
+  r->nstates = calloc(ncores, sizeof(uint32_t));
+  r->freqs = calloc(nstates, sizeof(uint32_t));
+  r->times = calloc(nstates, sizeof(uint64_t));
+  r->total_trans = calloc(ncores, sizeof(uint32_t));
+  r->status = calloc(ncores, sizeof(int));
+  if (r->nstates == NULL || r->freqs == NULL || r->times == NULL || r->total_trans == NULL || r->status == NULL) {
+    cpufreq_bindings_residency_free(r);
+    errno = ENOMEM;
+    return NULL;
+  }
+  return r;
+}
+
+void cpufreq_bindings_residency_free(cpufreq_bindings_residency* r) {
+  if (r != NULL) {
+    free(r->nstates);
+    free(r->freqs);
+    free(r->times);
+    free(r->total_trans);
+    free(r->status);
+    free(r);
+  }
+}
+
+// returns 0 or an errno value
+static int read_core(cpufreq_bindings_ctx* ctx, cpufreq_bindings_residency* r, uint32_t core) {
+  size_t off = (size_t) core * r->nstates_max;
+  errno = 0;
+  r->nstates[core] = cpufreq_bindings_ctx_get_stats_time_in_state(ctx, core, &r->freqs[off], &r->times[off],
+                                                                  r->nstates_max);
+  if (r->nstates[core] == 0) {
+    return errno ? errno : ENODATA;
+  }
+  return cpufreq_bindings_ctx_u32_read(ctx, core, CPUFREQ_BINDINGS_FILE_STATS_TOTAL_TRANS, &r->total_trans[core]);
+}
+
+static void copy_core(cpufreq_bindings_residency* r, uint32_t dst, uint32_t src) {
+  r->nstates[dst] = r->nstates[src];
+  memcpy(&r->freqs[(size_t) dst * r->nstates_max], &r->freqs[(size_t) src * r->nstates_max],
+         r->nstates[src] * sizeof(uint32_t));
+  memcpy(&r->times[(size_t) dst * r->nstates_max], &r->times[(size_t) src * r->nstates_max],
+         r->nstates[src] * sizeof(uint64_t));
+  r->total_trans[dst] = r->total_trans[src];
+  r->status[dst] = r->status[src];
+}
+
+// the core whose files are read for "core" - itself if its policy is unknown or the representative is out of range
+static uint32_t core_rep(const cpufreq_bindings_policies* p, uint32_t core, uint32_t ncores) {
+  uint32_t rep;
+  if (p == NULL || p->core_idx[core] == UINT32_MAX) {
+    return core;
+  }
+  rep = p->reps[p->core_idx[core]];
+  return rep < ncores ? rep : core;
+}
+
+uint32_t cpufreq_bindings_ctx_get_residency(cpufreq_bindings_ctx* ctx, cpufreq_bindings_residency* r) {
+  const cpufreq_bindings_policies* p;
+  uint32_t ncores = cpufreq_bindings_ctx_get_ncores(ctx);
+  uint32_t n = 0;
+  uint32_t rep;
+  uint32_t i;
+  if (ncores > r->ncores) {
+    ncores = r->ncores;
+  }
+  // without policies, every core is read
+  if ((p = cpufreq_bindings_ctx_policies(ctx)) == NULL) {
+    PERROR(WARN, "cpufreq_bindings_ctx_get_residency: cpufreq_bindings_ctx_policies");
+  }
+  r->timestamp_ns = now_ns();
+  // a representative isn't necessarily its policy's lowest core (offline cores are passed over), so read them all first
+  for (i = 0; i < ncores; i++) {
+    if (core_rep(p, i, ncores) == i) {
+      r->status[i] = read_core(ctx, r, i);
+    }
+  }
+  for (i = 0; i < ncores; i++) {
+    if ((rep = core_rep(p, i, ncores)) != i) {
+      copy_core(r, i, rep);
+    }
+    if (r->status[i] == 0) {
+      n++;
+    }
+  }
+  if (p != NULL) {
+    cpufreq_bindings_ctx_policies_release(ctx);
+  }
+  return n;
+}
+
+// returns the index of "freq" in "freqs", checking "hint" first, or UINT32_MAX if not found
+static uint32_t find_freq(const uint32_t* freqs, uint32_t len, uint32_t freq, uint32_t hint) {
+  uint32_t i;
+  if (hint < len && freqs[hint] == freq) {
+    return hint;
+  }
+  for (i = 0; i < len; i++) {
+    if (freqs[i] == freq) {
+      return i;
+    }
+  }
+  return UINT32_MAX;
+}
+
+int cpufreq_bindings_residency_delta(const cpufreq_bindings_residency* before, const cpufreq_bindings_residency* after,
+                                     cpufreq_bindings_residency* delta) {
+  const uint32_t* bfreqs;
+  const uint64_t* btimes;
+  size_t off;
+  uint64_t t;
+  uint32_t b;
+  uint32_t i;
+  uint32_t j;
+  if (before->ncores != after->ncores || before->ncores != delta->ncores ||
+      before->nstates_max != after->nstates_max || before->nstates_max != delta->nstates_max) {
+    errno = EINVAL;
+    return -1;
+  }
+  for (i = 0; i < after->ncores; i++) {
+    if ((delta->status[i] = after->status[i] ? after->status[i] : before->status[i]) != 0) {
+      delta->nstates[i] = 0;
+      continue;
+    }
+    off = (size_t) i * after->nstates_max;
+    bfreqs = &before->freqs[off];
+    btimes = &before->times[off];
+    for (j = 0; j < after->nstates[i]; j++) {
+      t = after->times[off + j];
+      // a frequency that wasn't in "before" has been counting since 0
+      if ((b = find_freq(bfreqs, before->nstates[i], after->freqs[off + j], j)) != UINT32_MAX && btimes[b] <= t) {
+        t -= btimes[b];
+      }
+      delta->freqs[off + j] = after->freqs[off + j];
+      delta->times[off + j] = t;
+    }
+    delta->nstates[i] = after->nstates[i];
+    delta->total_trans[i] = after->total_trans[i] >= before->total_trans[i] ?
+                            after->total_trans[i] - before->total_trans[i] : after->total_trans[i];
+  }
+  delta->timestamp_ns = after->timestamp_ns - before->timestamp_ns;
+  return 0;
+}
@@ -0,0 +1,271 @@
+/**
+ * Background sampling of core frequencies into a single-producer/multi-consumer ring buffer.
+ *
+ * Each ring slot is protected by its own sequence number (a per-slot seqlock): the producer makes it odd while
+ * writing and sets it to twice the sample number when done.
+ * Consumers copy a slot and then verify the sequence number is unchanged, counting the sample as lost if the producer
+ * lapped them.
+ *
+ * @author Connor Imes
+ * @date 2026-10-15
+ */
+// for clock_gettime, clock_nanosleep
+#define _POSIX_C_SOURCE 200809L
+#include <errno.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "cpufreq-bindings.h"
+#include "cpufreq-bindings-common.h"
+#include "cpufreq-bindings-sampler.h"
+
+#define CACHE_LINE_SIZE 64
+
+typedef struct sampler_slot {
+  uint64_t seq;
+  uint64_t timestamp_ns;
+  uint32_t vals[];
+} sampler_slot;
+
+struct cpufreq_bindings_sampler {
+  cpufreq_bindings_ctx* ctx;
+  uint32_t* cores;
+  uint32_t ncores;
+  uint32_t nfiles;
+  uint64_t period_ns;
+  // ring
+  char* slots;
+  size_t slot_size;
+  uint64_t capacity;
+  // the last published sample number
+  uint64_t head;
+  // producer scratch
+  uint32_t* scratch_vals;
+  int* scratch_status;
+  // thread
+  pthread_t thread;
+  int running;
+  int started;
+  cpufreq_bindings_sampler_stats stats;
+};
+
+static const cpufreq_bindings_file SAMPLER_FILES[] = {
+  CPUFREQ_BINDINGS_FILE_SCALING_CUR_FREQ,
+  CPUFREQ_BINDINGS_FILE_CPUINFO_CUR_FREQ
+};
+
+static sampler_slot* get_slot(const cpufreq_bindings_sampler* s, uint64_t seq) {
+  return (sampler_slot*) (void*) &s->slots[(seq & (s->capacity - 1)) * s->slot_size];
+}
+
+cpufreq_bindings_sampler* cpufreq_bindings_sampler_init(cpufreq_bindings_ctx* ctx, const uint32_t* cores,
+                                                        uint32_t ncores, uint64_t period_ns, uint32_t capacity,
+                                                        int flags) {
+  cpufreq_bindings_sampler* s;
+  uint64_t cap = 1;
+  uint32_t nvals;
+  if (ncores == 0 || period_ns == 0 || capacity == 0 || (flags & ~CPUFREQ_BINDINGS_SAMPLER_CPUINFO_CUR_FREQ)) {
+    errno = EINVAL;
+    return NULL;
+  }
+  while (cap < capacity) {
+    cap <<= 1;
+  }
+  if ((s = calloc(1, sizeof(cpufreq_bindings_sampler))) == NULL) {
+    return NULL;
+  }
+  s->ctx = ctx;
+  s->ncores = ncores;
+  s->nfiles = (flags & CPUFREQ_BINDINGS_SAMPLER_CPUINFO_CUR_FREQ) ? 2 : 1;
+  s->period_ns = period_ns;
+  s->capacity = cap;
+  nvals = ncores * s->nfiles;
+  // keep slots on separate cache lines so consumers don't false-share with the slot being written
+  s->slot_size = sizeof(sampler_slot) + nvals * sizeof(uint32_t);
+  s->slot_size = (s->slot_size + CACHE_LINE_SIZE - 1) & ~(size_t) (CACHE_LINE_SIZE - 1);
+  s->cores = malloc(ncores * sizeof(uint32_t));
+  s->scratch_vals = malloc(nvals * sizeof(uint32_t));
+  s->scratch_status = malloc(nvals * sizeof(int));
+  if (posix_memalign((void**) &s->slots, CACHE_LINE_SIZE, s->slot_size * cap)) {
+    s->slots = NULL;
+  }
+  if (s->cores == NULL || s->scratch_vals == NULL || s->scratch_status == NULL || s->slots == NULL) {
+    cpufreq_bindings_sampler_destroy(s);
+    errno = ENOMEM;
+    return NULL;
+  }
+  memcpy(s->cores, cores, ncores * sizeof(uint32_t));
+  memset(s->slots, 0, s->slot_size * cap);
+  return s;
+}
+
+void cpufreq_bindings_sampler_destroy(cpufreq_bindings_sampler* sampler) {
+  if (sampler->started) {
+    cpufreq_bindings_sampler_stop(sampler);
+  }
+  free(sampler->cores);
+  free(sampler->scratch_vals);
+  free(sampler->scratch_status);
+  free(sampler->slots);
+  free(sampler);
+}
+
+static void stat_add(uint64_t* stat, uint64_t val) {
+  __atomic_fetch_add(stat, val, __ATOMIC_RELAXED);
+}
+
+static void publish(cpufreq_bindings_sampler* s, uint64_t timestamp_ns) {
+  sampler_slot* slot;
+  uint64_t seq = s->head + 1;
+  uint32_t nvals = s->ncores * s->nfiles;
+  uint32_t ok;
+  uint32_t i;
+  uint32_t j;
+  ok = cpufreq_bindings_ctx_get_u32_batch_multi(s->ctx, SAMPLER_FILES, s->nfiles, s->cores, s->ncores,
+                                                s->scratch_vals, s->scratch_status);
+  stat_add(&s->stats.errors, nvals - ok);
+  slot = get_slot(s, seq);
+  // mark the slot as being written before touching its contents
+  __atomic_store_n(&slot->seq, 2 * seq - 1, __ATOMIC_RELAXED);
+  __atomic_thread_fence(__ATOMIC_RELEASE);
+  slot->timestamp_ns = timestamp_ns;
+  // batch values are ordered by core, then file; samples are ordered by file, then core
+  for (i = 0; i < s->ncores; i++) {
+    for (j = 0; j < s->nfiles; j++) {
+      slot->vals[j * s->ncores + i] = s->scratch_vals[i * s->nfiles + j];
+    }
+  }
+  __atomic_store_n(&slot->seq, 2 * seq, __ATOMIC_RELEASE);
+  __atomic_store_n(&s->head, seq, __ATOMIC_RELEASE);
+  stat_add(&s->stats.samples, 1);
+}
+
+static void* sampler_thread(void* arg) {
+  cpufreq_bindings_sampler* s = arg;
+  struct timespec ts;
+  uint64_t deadline = now_ns();
+  uint64_t now;
+  uint64_t lateness;
+  uint64_t missed;
+  while (__atomic_load_n(&s->running, __ATOMIC_ACQUIRE)) {
+    now = now_ns();
+    lateness = now - deadline;
+    if (lateness >= s->period_ns) {
+      // skip the periods we slept through rather than bursting to catch up
+      missed = lateness / s->period_ns;
+      stat_add(&s->stats.dropped, missed);
+      deadline += missed * s->period_ns;
+      lateness -= missed * s->period_ns;
+    }
+    if (lateness * 10 > s->period_ns) {
+      stat_add(&s->stats.late, 1);
+    }
+    stat_add(&s->stats.lateness_ns_total, lateness);
+    if (lateness > __atomic_load_n(&s->stats.lateness_ns_max, __ATOMIC_RELAXED)) {
+      __atomic_store_n(&s->stats.lateness_ns_max, lateness, __ATOMIC_RELAXED);
+    }
+    publish(s, now);
+    deadline += s->period_ns;
+    ts.tv_sec = (time_t) (deadline / 1000000000ULL);
+    ts.tv_nsec = (long) (deadline % 1000000000ULL);
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR);
+  }
+  return NULL;
+}
+
+int cpufreq_bindings_sampler_start(cpufreq_bindings_sampler* sampler) {
+  int ret;
+  if (sampler->started) {
+    errno = EBUSY;
+    return -1;
+  }
+  __atomic_store_n(&sampler->running, 1, __ATOMIC_RELEASE);
+  if ((ret = pthread_create(&sampler->thread, NULL, sampler_thread, sampler))) {
+    __atomic_store_n(&sampler->running, 0, __ATOMIC_RELEASE);
+    errno = ret;
+    PERROR(ERROR, "cpufreq_bindings_sampler_start: pthread_create");
+    return -1;
+  }
+  sampler->started = 1;
+  return 0;
+}
+
+int cpufreq_bindings_sampler_stop(cpufreq_bindings_sampler* sampler) {
+  int ret;
+  if (!sampler->started) {
+    errno = EINVAL;
+    return -1;
+  }
+  __atomic_store_n(&sampler->running, 0, __ATOMIC_RELEASE);
+  if ((ret = pthread_join(sampler->thread, NULL))) {
+    errno = ret;
+    PERROR(ERROR, "cpufreq_bindings_sampler_stop: pthread_join");
+    return -1;
+  }
+  sampler->started = 0;
+  return 0;
+}
+
+void cpufreq_bindings_sampler_get_stats(const cpufreq_bindings_sampler* sampler,
+                                        cpufreq_bindings_sampler_stats* stats) {
+  stats->samples = __atomic_load_n(&sampler->stats.samples, __ATOMIC_RELAXED);
+  stats->late = __atomic_load_n(&sampler->stats.late, __ATOMIC_RELAXED);
+  stats->dropped = __atomic_load_n(&sampler->stats.dropped, __ATOMIC_RELAXED);
+  stats->errors = __atomic_load_n(&sampler->stats.errors, __ATOMIC_RELAXED);
+  stats->lateness_ns_total = __atomic_load_n(&sampler->stats.lateness_ns_total, __ATOMIC_RELAXED);
+  stats->lateness_ns_max = __atomic_load_n(&sampler->stats.lateness_ns_max, __ATOMIC_RELAXED);
+}
+
+uint32_t cpufreq_bindings_sampler_get_nvals(const cpufreq_bindings_sampler* sampler) {
+  return sampler->ncores * sampler->nfiles;
+}
+
+void cpufreq_bindings_sampler_cursor_init(const cpufreq_bindings_sampler* sampler,
+                                          cpufreq_bindings_sampler_cursor* cursor, int latest) {
+  uint64_t head = __atomic_load_n(&sampler->head, __ATOMIC_ACQUIRE);
+  cursor->lost = 0;
+  if (latest) {
+    cursor->next = head > 0 ? head : 1;
+  } else {
+    cursor->next = head >= sampler->capacity ? head - sampler->capacity + 1 : 1;
+  }
+}
+
+int cpufreq_bindings_sampler_read(const cpufreq_bindings_sampler* sampler, cpufreq_bindings_sampler_cursor* cursor,
+                                  uint64_t* timestamp_ns, uint32_t* vals) {
+  const sampler_slot* slot;
+  uint64_t head;
+  uint64_t seq;
+  uint64_t oldest;
+  for (;;) {
+    head = __atomic_load_n(&sampler->head, __ATOMIC_ACQUIRE);
+    if (cursor->next > head) {
+      return 0;
+    }
+    oldest = head >= sampler->capacity ? head - sampler->capacity + 1 : 1;
+    if (cursor->next < oldest) {
+      // overwritten before we got to it
+      cursor->lost += oldest - cursor->next;
+      cursor->next = oldest;
+    }
+    slot = get_slot(sampler, cursor->next);
+    if ((seq = __atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE)) != 2 * cursor->next) {
+      // the producer has lapped us and is rewriting this slot - don't wait for it
+      cursor->lost++;
+      cursor->next++;
+      continue;
+    }
+    *timestamp_ns = slot->timestamp_ns;
+    memcpy(vals, slot->vals, sampler->ncores * sampler->nfiles * sizeof(uint32_t));
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    if (__atomic_load_n(&slot->seq, __ATOMIC_RELAXED) == seq) {
+      cursor->next++;
+      return 1;
+    }
+    // overwritten while copying
+    cursor->lost++;
+    cursor->next++;
+  }
+}
@@ -0,0 +1,333 @@
+/**
+ * Share per-core cpufreq state between processes through POSIX shared memory, protected by a sequence lock.
+ *
+ * @author Connor Imes
+ * @date 2026-10-15
+ */
+// for shm_open, clock_gettime, ftruncate
+#define _POSIX_C_SOURCE 200809L
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#include "cpufreq-bindings.h"
+#include "cpufreq-bindings-common.h"
+#include "cpufreq-bindings-ctx.h"
+#include "cpufreq-bindings-shm.h"
+
+// "CFBS"
+#define SHM_MAGIC 0x43464253
+#define SHM_VERSION 1
+
+// give up rather than spin forever if the publisher died mid-update
+#define SNAPSHOT_RETRIES 4096
+
+// one cache line
+typedef struct shm_header {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t ncores;
+  uint32_t entry_size;
+  // odd while an update is in progress
+  uint64_t seq;
+  uint64_t update_ns;
+  uint64_t reserved[4];
+} shm_header;
+
+static const cpufreq_bindings_file SHM_FILES[] = {
+  CPUFREQ_BINDINGS_FILE_SCALING_CUR_FREQ,
+  CPUFREQ_BINDINGS_FILE_SCALING_MIN_FREQ,
+  CPUFREQ_BINDINGS_FILE_SCALING_MAX_FREQ
+};
+#define SHM_FILE_COUNT (sizeof(SHM_FILES) / sizeof(SHM_FILES[0]))
+
+struct cpufreq_bindings_shm_publisher {
+  cpufreq_bindings_ctx* ctx;
+  char* name;
+  shm_header* hdr;
+  cpufreq_bindings_shm_entry* entries;
+  size_t size;
+  uint32_t ncores;
+  // the cores actually read (one per policy if possible), and which of them each core maps to
+  uint32_t* srcs;
+  uint32_t nsrcs;
+  uint32_t* core_src;
+  // scratch
+  uint32_t* vals;
+  int* status;
+  char* governors;
+  int* governor_ok;
+};
+
+struct cpufreq_bindings_shm_reader {
+  const shm_header* hdr;
+  const cpufreq_bindings_shm_entry* entries;
+  size_t size;
+  // validated against the mapping's size when opened - the live header is never trusted for bounds
+  uint32_t ncores;
+};
+
+static size_t table_size(uint32_t ncores) {
+  return sizeof(shm_header) + ncores * sizeof(cpufreq_bindings_shm_entry);
+}
+
+static void publisher_free(cpufreq_bindings_shm_publisher* pub) {
+  if (pub->hdr != NULL) {
+    munmap(pub->hdr, pub->size);
+  }
+  free(pub->name);
+  free(pub->srcs);
+  free(pub->core_src);
+  free(pub->vals);
+  free(pub->status);
+  free(pub->governors);
+  free(pub->governor_ok);
+  free(pub);
+}
+
+// read each policy once if possible, since all of a policy's cores share the same files
+static void map_sources(cpufreq_bindings_shm_publisher* pub) {
+  const cpufreq_bindings_policies* p = cpufreq_bindings_ctx_policies(pub->ctx);
+  uint32_t* policy_src = NULL;
+  uint32_t core;
+  uint32_t idx;
+  if (p != NULL && (policy_src = malloc(p->npolicies * sizeof(uint32_t))) != NULL) {
+    for (idx = 0; idx < p->npolicies; idx++) {
+      policy_src[idx] = UINT32_MAX;
+    }
+  }
+  for (core = 0; core < pub->ncores; core++) {
+    if (policy_src != NULL && (idx = p->core_idx[core]) != UINT32_MAX) {
+      if (policy_src[idx] == UINT32_MAX) {
+        policy_src[idx] = pub->nsrcs;
+        // the policy's representative may be beyond this table's cores, which is fine
+        pub->srcs[pub->nsrcs++] = p->reps[idx];
+      }
+      pub->core_src[core] = policy_src[idx];
+    } else {
+      pub->core_src[core] = pub->nsrcs;
+      pub->srcs[pub->nsrcs++] = core;
+    }
+  }
+  if (p != NULL) {
+    cpufreq_bindings_ctx_policies_release(pub->ctx);
+  }
+  free(policy_src);
+}
+
+// readers may still have an existing table mapped, so it's marked stale and unlinked rather than resized in place
+static void retire_existing(const char* name) {
+  shm_header* hdr;
+  struct stat st;
+  int fd;
+  if ((fd = shm_open(name, O_RDWR, 0)) < 0) {
+    return;
+  }
+  if (!fstat(fd, &st) && (size_t) st.st_size >= sizeof(shm_header) &&
+      (hdr = mmap(NULL, sizeof(shm_header), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0)) != MAP_FAILED) {
+    __atomic_store_n(&hdr->magic, 0, __ATOMIC_RELEASE);
+    munmap(hdr, sizeof(shm_header));
+  }
+  close(fd);
+  if (shm_unlink(name) && errno != ENOENT) {
+    PERROR(WARN, "cpufreq_bindings_shm_publisher_init: shm_unlink");
+  }
+}
+
+cpufreq_bindings_shm_publisher* cpufreq_bindings_shm_publisher_init(const char* name, cpufreq_bindings_ctx* ctx,
+                                                                    uint32_t ncores) {
+  cpufreq_bindings_shm_publisher* pub;
+  void* addr;
+  int err_save;
+  int fd;
+  if (ncores == 0 || ncores > cpufreq_bindings_ctx_get_ncores(ctx)) {
+    errno = EINVAL;
+    return NULL;
+  }
+  if ((pub = calloc(1, sizeof(cpufreq_bindings_shm_publisher))) == NULL) {
+    return NULL;
+  }
+  pub->ctx = ctx;
+  pub->ncores = ncores;
+  pub->size = table_size(ncores);
+  pub->name = malloc(strlen(name) + 1);
+  pub->srcs = malloc(ncores * sizeof(uint32_t));
+  pub->core_src = malloc(ncores * sizeof(uint32_t));
+  pub->vals = malloc(ncores * SHM_FILE_COUNT * sizeof(uint32_t));
+  pub->status = malloc(ncores * SHM_FILE_COUNT * sizeof(int));
+  pub->governors = malloc(ncores * CPUFREQ_BINDINGS_SHM_GOVERNOR_LEN);
+  pub->governor_ok = malloc(ncores * sizeof(int));
+  if (pub->name == NULL || pub->srcs == NULL || pub->core_src == NULL || pub->vals == NULL || pub->status == NULL ||
+      pub->governors == NULL || pub->governor_ok == NULL) {
+    publisher_free(pub);
+    errno = ENOMEM;
+    return NULL;
+  }
+  strcpy(pub->name, name);
+  map_sources(pub);
+  retire_existing(name);
+  if ((fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0644)) < 0) {
+    PERROR(ERROR, "cpufreq_bindings_shm_publisher_init: shm_open");
+    publisher_free(pub);
+    return NULL;
+  }
+  if (ftruncate(fd, (off_t) pub->size)) {
+    PERROR(ERROR, "cpufreq_bindings_shm_publisher_init: ftruncate");
+    addr = MAP_FAILED;
+  } else if ((addr = mmap(NULL, pub->size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0)) == MAP_FAILED) {
+    PERROR(ERROR, "cpufreq_bindings_shm_publisher_init: mmap");
+  }
+  err_save = errno;
+  close(fd);
+  if (addr == MAP_FAILED) {
+    publisher_free(pub);
+    errno = err_save;
+    return NULL;
+  }
+  pub->hdr = addr;
+  pub->entries = (cpufreq_bindings_shm_entry*) (void*) &pub->hdr[1];
+  memset(addr, 0, pub->size);
+  pub->hdr->version = SHM_VERSION;
+  pub->hdr->ncores = ncores;
+  pub->hdr->entry_size = sizeof(cpufreq_bindings_shm_entry);
+  // readers check the magic last
+  __atomic_store_n(&pub->hdr->magic, SHM_MAGIC, __ATOMIC_RELEASE);
+  return pub;
+}
+
+uint32_t cpufreq_bindings_shm_publisher_update(cpufreq_bindings_shm_publisher* pub) {
+  cpufreq_bindings_shm_entry* e;
+  char* gov;
+  uint64_t seq;
+  uint32_t core;
+  uint32_t src;
+  uint32_t i;
+  uint32_t n = 0;
+  // read everything before entering the write section so readers are blocked as briefly as possible
+  cpufreq_bindings_ctx_get_u32_batch_multi(pub->ctx, SHM_FILES, SHM_FILE_COUNT, pub->srcs, pub->nsrcs, pub->vals,
+                                           pub->status);
+  for (i = 0; i < pub->nsrcs; i++) {
+    gov = &pub->governors[i * CPUFREQ_BINDINGS_SHM_GOVERNOR_LEN];
+    memset(gov, 0, CPUFREQ_BINDINGS_SHM_GOVERNOR_LEN);
+    pub->governor_ok[i] = cpufreq_bindings_ctx_get_scaling_governor(pub->ctx, pub->srcs[i], gov,
+                                                                    CPUFREQ_BINDINGS_SHM_GOVERNOR_LEN - 1) > 0;
+  }
+  seq = pub->hdr->seq;
+  __atomic_store_n(&pub->hdr->seq, seq + 1, __ATOMIC_RELAXED);
+  __atomic_thread_fence(__ATOMIC_RELEASE);
+  for (core = 0; core < pub->ncores; core++) {
+    e = &pub->entries[core];
+    src = pub->core_src[core];
+    e->scaling_cur_freq = pub->vals[src * SHM_FILE_COUNT];
+    e->scaling_min_freq = pub->vals[src * SHM_FILE_COUNT + 1];
+    e->scaling_max_freq = pub->vals[src * SHM_FILE_COUNT + 2];
+    memcpy(e->scaling_governor, &pub->governors[src * CPUFREQ_BINDINGS_SHM_GOVERNOR_LEN],
+           CPUFREQ_BINDINGS_SHM_GOVERNOR_LEN);
+    if (pub->governor_ok[src] && !pub->status[src * SHM_FILE_COUNT] && !pub->status[src * SHM_FILE_COUNT + 1] &&
+        !pub->status[src * SHM_FILE_COUNT + 2]) {
+      n++;
+    }
+  }
+  pub->hdr->update_ns = now_ns();
+  __atomic_store_n(&pub->hdr->seq, seq + 2, __ATOMIC_RELEASE);
+  if (n == 0) {
+    errno = EIO;
+  }
+  return n;
+}
+
+int cpufreq_bindings_shm_publisher_destroy(cpufreq_bindings_shm_publisher* pub, int unlink) {
+  int ret = 0;
+  if (unlink && (ret = shm_unlink(pub->name))) {
+    PERROR(WARN, "cpufreq_bindings_shm_publisher_destroy: shm_unlink");
+  }
+  publisher_free(pub);
+  return ret;
+}
+
+cpufreq_bindings_shm_reader* cpufreq_bindings_shm_reader_open(const char* name) {
+  cpufreq_bindings_shm_reader* reader;
+  const shm_header* hdr;
+  struct stat st;
+  void* addr;
+  int err_save;
+  int fd;
+  if ((fd = shm_open(name, O_RDONLY, 0)) < 0) {
+    return NULL;
+  }
+  if (fstat(fd, &st) || (size_t) st.st_size < sizeof(shm_header)) {
+    err_save = errno;
+    close(fd);
+    errno = err_save ? err_save : EINVAL;
+    return NULL;
+  }
+  addr = mmap(NULL, (size_t) st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  err_save = errno;
+  close(fd);
+  if (addr == MAP_FAILED) {
+    errno = err_save;
+    return NULL;
+  }
+  hdr = addr;
+  if (__atomic_load_n(&hdr->magic, __ATOMIC_ACQUIRE) != SHM_MAGIC || hdr->version != SHM_VERSION ||
+      hdr->entry_size != sizeof(cpufreq_bindings_shm_entry) || table_size(hdr->ncores) > (size_t) st.st_size) {
+    munmap(addr, (size_t) st.st_size);
+    errno = EPROTO;
+    return NULL;
+  }
+  if ((reader = malloc(sizeof(cpufreq_bindings_shm_reader))) == NULL) {
+    munmap(addr, (size_t) st.st_size);
+    return NULL;
+  }
+  reader->hdr = hdr;
+  reader->entries = (const cpufreq_bindings_shm_entry*) (const void*) &hdr[1];
+  reader->size = (size_t) st.st_size;
+  reader->ncores = hdr->ncores;
+  return reader;
+}
+
+int cpufreq_bindings_shm_reader_close(cpufreq_bindings_shm_reader* reader) {
+  int ret = munmap((void*) (uintptr_t) reader->hdr, reader->size);
+  free(reader);
+  return ret;
+}
+
+uint32_t cpufreq_bindings_shm_reader_get_ncores(const cpufreq_bindings_shm_reader* reader) {
+  return reader->ncores;
+}
+
+uint32_t cpufreq_bindings_shm_reader_snapshot(const cpufreq_bindings_shm_reader* reader,
+                                              cpufreq_bindings_shm_entry* entries, uint32_t len,
+                                              uint64_t* update_ns) {
+  uint64_t seq;
+  uint32_t ncores = reader->ncores;
+  uint32_t i;
+  if (len < ncores) {
+    errno = ERANGE;
+    return 0;
+  }
+  // the table was replaced by a new publisher
+  if (__atomic_load_n(&reader->hdr->magic, __ATOMIC_ACQUIRE) != SHM_MAGIC ||
+      __atomic_load_n(&reader->hdr->ncores, __ATOMIC_RELAXED) != ncores) {
+    errno = ESTALE;
+    return 0;
+  }
+  for (i = 0; i < SNAPSHOT_RETRIES; i++) {
+    if ((seq = __atomic_load_n(&reader->hdr->seq, __ATOMIC_ACQUIRE)) & 1) {
+      continue;
+    }
+    memcpy(entries, reader->entries, ncores * sizeof(cpufreq_bindings_shm_entry));
+    *update_ns = reader->hdr->update_ns;
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    if (__atomic_load_n(&reader->hdr->seq, __ATOMIC_RELAXED) == seq) {
+      return ncores;
+    }
+  }
+  errno = EAGAIN;
+  return 0;
+}
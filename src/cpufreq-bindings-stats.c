@@ -0,0 +1,121 @@
+/**
+ * Process-wide instrumentation counters.
+ * All counters are 64-bit and updated with relaxed atomics, so the struct is treated as an array of counters.
+ *
+ * @author Connor Imes
+ * @date 2026-10-15
+ */
+// for clock_gettime
+#define _POSIX_C_SOURCE 200809L
+#include <errno.h>
+#include <inttypes.h>
+#include <time.h>
+#include "cpufreq-bindings.h"
+#include "cpufreq-bindings-common.h"
+#include "cpufreq-bindings-instrument.h"
+#include "cpufreq-bindings-stats.h"
+
+#ifdef CPUFREQ_BINDINGS_STATS
+
+#define STATS_NCOUNTERS (sizeof(cpufreq_bindings_stats) / sizeof(uint64_t))
+
+static cpufreq_bindings_stats stats;
+
+static uint64_t* counter_ptr(cpufreq_bindings_counter counter) {
+  switch (counter) {
+    case COUNTER_OPEN:
+      return &stats.opens;
+    case COUNTER_PREAD:
+      return &stats.preads;
+    case COUNTER_PWRITE:
+      return &stats.pwrites;
+    case COUNTER_CLOSE:
+      return &stats.closes;
+    case COUNTER_OPEN_PER_CALL:
+      return &stats.opens_per_call;
+    case COUNTER_URING_SUBMIT:
+      return &stats.uring_submits;
+    case COUNTER_PARSE_ERROR:
+      return &stats.parse_errors;
+    case COUNTER_WRITE_ELIDED:
+      return &stats.writes_elided;
+    case COUNTER_WRITE_DEFERRED:
+    default:
+      return &stats.writes_deferred;
+  }
+}
+
+void cpufreq_bindings_stats_count(cpufreq_bindings_counter counter) {
+  __atomic_fetch_add(counter_ptr(counter), 1, __ATOMIC_RELAXED);
+}
+
+uint64_t cpufreq_bindings_stats_start(void) {
+  return now_ns();
+}
+
+static uint32_t hist_bucket(uint64_t ns) {
+  uint32_t b = 0;
+  while (ns > 1 && b < CPUFREQ_BINDINGS_STATS_HIST_BUCKETS - 1) {
+    ns >>= 1;
+    b++;
+  }
+  return b;
+}
+
+void cpufreq_bindings_stats_io(cpufreq_bindings_file file, int write, int failed, uint64_t start_ns) {
+  cpufreq_bindings_file_stats* fs;
+  uint64_t ns;
+  if ((int) file < 0 || (int) file >= CPUFREQ_BINDINGS_STATS_MAX_FILES) {
+    return;
+  }
+  fs = &stats.files[file];
+  // only I/O batched through io_uring has no start time
+  if (start_ns > 0) {
+    __atomic_fetch_add(write ? &stats.pwrites : &stats.preads, 1, __ATOMIC_RELAXED);
+  } else {
+    __atomic_fetch_add(write ? &stats.uring_writes : &stats.uring_reads, 1, __ATOMIC_RELAXED);
+  }
+  __atomic_fetch_add(write ? &fs->writes : &fs->reads, 1, __ATOMIC_RELAXED);
+  if (failed) {
+    __atomic_fetch_add(&fs->errors, 1, __ATOMIC_RELAXED);
+  }
+  if (start_ns > 0) {
+    ns = cpufreq_bindings_stats_start() - start_ns;
+    __atomic_fetch_add(&fs->latency_ns, ns, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&fs->hist[hist_bucket(ns)], 1, __ATOMIC_RELAXED);
+  }
+}
+
+int cpufreq_bindings_stats_get(cpufreq_bindings_stats* out) {
+  const uint64_t* src = (const uint64_t*) &stats;
+  uint64_t* dst = (uint64_t*) out;
+  size_t i;
+  for (i = 0; i < STATS_NCOUNTERS; i++) {
+    dst[i] = __atomic_load_n(&src[i], __ATOMIC_RELAXED);
+  }
+  return 0;
+}
+
+int cpufreq_bindings_stats_reset(void) {
+  uint64_t* dst = (uint64_t*) &stats;
+  size_t i;
+  for (i = 0; i < STATS_NCOUNTERS; i++) {
+    __atomic_store_n(&dst[i], 0, __ATOMIC_RELAXED);
+  }
+  return 0;
+}
+
+#else
+
+int cpufreq_bindings_stats_get(cpufreq_bindings_stats* out) {
+  (void) out;
+  errno = ENOTSUP;
+  return -1;
+}
+
+int cpufreq_bindings_stats_reset(void) {
+  errno = ENOTSUP;
+  return -1;
+}
+
+#endif
@@ -0,0 +1,694 @@
+/**
+ * Topology-aware grouping of cores: an index from (core, level) to group, and from group to the policies to write.
+ *
+ * @author Connor Imes
+ * @date 2026-10-15
+ */
+// for opendir, readdir
+#define _POSIX_C_SOURCE 200809L
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "cpufreq-bindings.h"
+#include "cpufreq-bindings-common.h"
+#include "cpufreq-bindings-ctx.h"
+#include "cpufreq-bindings-parse.h"
+#include "cpufreq-bindings-topology.h"
+
+#define CPU_DIR "/devices/system/cpu"
+#define NODE_DIR "/devices/system/node"
+// hybrid Intel systems have a PMU per core type, listing its cores
+#define ATOM_CPUS "/devices/cpu_atom/cpus"
+
+#define LEVELS CPUFREQ_BINDINGS_TOPOLOGY_LEVEL_COUNT
+
+// the largest CONFIG_NR_CPUS supported by the kernel
+#define CPULIST_MAX 8192
+
+#define NO_POLICY UINT32_MAX
+#define NO_GROUP UINT32_MAX
+
+typedef enum core_type_source {
+  CORE_TYPE_NONE,
+  CORE_TYPE_HYBRID,
+  CORE_TYPE_CAPACITY
+} core_type_source;
+
+typedef struct topo_level {
+  uint32_t ngroups;
+  // sorted group keys, length ngroups - core type keys sort from the highest capacity, and the group ID is the index
+  uint32_t* keys;
+  // group g's policies are at [off[g], off[g + 1]), length ngroups + 1
+  uint32_t* off;
+  // kernel policy numbers, and the core to write each one through
+  uint32_t* policies;
+  uint32_t* reps;
+} topo_level;
+
+struct cpufreq_bindings_topology {
+  cpufreq_bindings_ctx* ctx;
+  uint32_t ncores;
+  core_type_source core_type_src;
+  // nonzero if the core was online when the index was built, length ncores
+  uint8_t* online;
+  // group keys read from sysfs, indexed by (core * LEVELS + level) - only valid for cores that have been online
+  uint32_t* core_keys;
+  // index into each level's groups, or NO_GROUP if offline, indexed by (core * LEVELS + level)
+  uint32_t* core_groups;
+  topo_level levels[LEVELS];
+  // scratch for reading cpulists, length CPULIST_MAX
+  uint32_t* cpus;
+};
+
+static int cmp_u32(const void* a, const void* b) {
+  uint32_t x = *(const uint32_t*) a;
+  uint32_t y = *(const uint32_t*) b;
+  return x < y ? -1 : x > y ? 1 : 0;
+}
+
+static int cmp_u64(const void* a, const void* b) {
+  uint64_t x = *(const uint64_t*) a;
+  uint64_t y = *(const uint64_t*) b;
+  return x < y ? -1 : x > y ? 1 : 0;
+}
+
+// read a list (e.g., "0-3,8-11") - returns the number of values, or 0 on failure (errno will be set)
+static uint32_t read_cpulist(const char* path, uint32_t* cpus, uint32_t len) {
+  cpufreq_bindings_u32arr_parser p;
+  char buf[PARSE_CHUNK_LEN];
+  off_t off = 0;
+  ssize_t ret;
+  int err_save;
+  int fd;
+  if ((fd = open(path, O_RDONLY)) < 0) {
+    return 0;
+  }
+  cpufreq_bindings_u32arr_parser_init(&p, cpus, len);
+  while ((ret = pread(fd, buf, sizeof(buf), off)) > 0) {
+    off += ret;
+    // a short read reached the end, like in read_file_parse
+    if (cpufreq_bindings_u32arr_parse(&p, buf, (size_t) ret) || (size_t) ret < sizeof(buf)) {
+      break;
+    }
+  }
+  err_save = errno;
+  close(fd);
+  if (ret < 0) {
+    errno = err_save;
+    return 0;
+  }
+  return cpufreq_bindings_u32arr_parser_finish(&p);
+}
+
+// negative values, e.g., a "cluster_id" of -1, are unknown and fail with EINVAL
+static int read_u32(const char* path, uint32_t* val) {
+  char buf[U32_MAX_LEN];
+  ssize_t ret;
+  int err;
+  int fd;
+  if ((fd = open(path, O_RDONLY)) < 0) {
+    return -1;
+  }
+  ret = pread(fd, buf, sizeof(buf), 0);
+  err = ret < 0 ? errno : cpufreq_bindings_parse_u32(buf, (size_t) ret, val);
+  close(fd);
+  if (err) {
+    errno = err;
+    return -1;
+  }
+  return 0;
+}
+
+static uint32_t read_core_cpulist(cpufreq_bindings_topology* topo, uint32_t core, const char* name) {
+  char path[SYSFS_PATH_MAX_LEN];
+  if (cpufreq_bindings_sysfs_path(path, sizeof(path), CPU_DIR "/cpu%"PRIu32"/topology/%s", core, name)) {
+    return 0;
+  }
+  return read_cpulist(path, topo->cpus, CPULIST_MAX);
+}
+
+static void set_key(cpufreq_bindings_topology* topo, uint32_t core, cpufreq_bindings_topology_level level,
+                    uint32_t key) {
+  topo->core_keys[core * LEVELS + level] = key;
+}
+
+static uint32_t get_key(const cpufreq_bindings_topology* topo, uint32_t core, cpufreq_bindings_topology_level level) {
+  return topo->core_keys[core * LEVELS + level];
+}
+
+/*
+ * Read a per-core ID (e.g., "physical_package_id") and assign it to all pending cores in the same list (e.g.,
+ * "package_cpus_list"), so each group is read once rather than each core.
+ * Cores without the ID get the key at the "fallback" level, or 0.
+ */
+static void read_shared_ids(cpufreq_bindings_topology* topo, const uint8_t* pending, uint8_t* todo,
+                            cpufreq_bindings_topology_level level, const char* id_name, const char* list_name,
+                            const char* list_name_old, int fallback) {
+  char path[SYSFS_PATH_MAX_LEN];
+  uint32_t core;
+  uint32_t key;
+  uint32_t n;
+  uint32_t i;
+  memcpy(todo, pending, topo->ncores);
+  for (core = 0; core < topo->ncores; core++) {
+    if (!todo[core]) {
+      continue;
+    }
+    if (cpufreq_bindings_sysfs_path(path, sizeof(path), CPU_DIR "/cpu%"PRIu32"/topology/%s", core, id_name) ||
+        read_u32(path, &key)) {
+      key = fallback < 0 ? 0 : get_key(topo, core, (cpufreq_bindings_topology_level) fallback);
+    }
+    set_key(topo, core, level, key);
+    todo[core] = 0;
+    if ((n = read_core_cpulist(topo, core, list_name)) == 0 && list_name_old != NULL) {
+      n = read_core_cpulist(topo, core, list_name_old);
+    }
+    for (i = 0; i < n; i++) {
+      if (topo->cpus[i] < topo->ncores && todo[topo->cpus[i]]) {
+        set_key(topo, topo->cpus[i], level, key);
+        todo[topo->cpus[i]] = 0;
+      }
+    }
+  }
+}
+
+static int parse_node_name(const char* name, uint32_t* id) {
+  char* end;
+  unsigned long val;
+  if (strncmp(name, "node", 4) || name[4] < '0' || name[4] > '9') {
+    return -1;
+  }
+  val = strtoul(&name[4], &end, 10);
+  if (*end != '\0' || val > UINT32_MAX) {
+    return -1;
+  }
+  *id = (uint32_t) val;
+  return 0;
+}
+
+static void read_nodes(cpufreq_bindings_topology* topo, const uint8_t* pending) {
+  char path[SYSFS_PATH_MAX_LEN];
+  struct dirent* ent;
+  DIR* dir;
+  uint32_t core;
+  uint32_t id;
+  uint32_t n;
+  uint32_t i;
+  for (core = 0; core < topo->ncores; core++) {
+    if (pending[core]) {
+      set_key(topo, core, CPUFREQ_BINDINGS_TOPOLOGY_NODE, 0);
+    }
+  }
+  if (cpufreq_bindings_sysfs_path(path, sizeof(path), NODE_DIR) || (dir = opendir(path)) == NULL) {
+    LOG(DEBUG, "read_nodes: %s not available, using node 0\n", NODE_DIR);
+    return;
+  }
+  while ((ent = readdir(dir)) != NULL) {
+    if (parse_node_name(ent->d_name, &id) ||
+        cpufreq_bindings_sysfs_path(path, sizeof(path), NODE_DIR "/node%"PRIu32"/cpulist", id)) {
+      continue;
+    }
+    // memory-only nodes have an empty list
+    n = read_cpulist(path, topo->cpus, CPULIST_MAX);
+    for (i = 0; i < n; i++) {
+      if (topo->cpus[i] < topo->ncores && pending[topo->cpus[i]]) {
+        set_key(topo, topo->cpus[i], CPUFREQ_BINDINGS_TOPOLOGY_NODE, id);
+      }
+    }
+  }
+  closedir(dir);
+}
+
+static int read_capacity(uint32_t core, uint32_t* capacity) {
+  char path[SYSFS_PATH_MAX_LEN];
+  if (cpufreq_bindings_sysfs_path(path, sizeof(path), CPU_DIR "/cpu%"PRIu32"/cpu_capacity", core)) {
+    return -1;
+  }
+  return read_u32(path, capacity);
+}
+
+static void detect_core_types(cpufreq_bindings_topology* topo, const uint8_t* pending) {
+  char path[SYSFS_PATH_MAX_LEN];
+  uint32_t capacity;
+  uint32_t core;
+  topo->core_type_src = CORE_TYPE_NONE;
+  if (!cpufreq_bindings_sysfs_path(path, sizeof(path), ATOM_CPUS) && read_cpulist(path, topo->cpus, CPULIST_MAX) > 0) {
+    topo->core_type_src = CORE_TYPE_HYBRID;
+    return;
+  }
+  for (core = 0; core < topo->ncores; core++) {
+    if (pending[core]) {
+      if (!read_capacity(core, &capacity)) {
+        topo->core_type_src = CORE_TYPE_CAPACITY;
+      }
+      return;
+    }
+  }
+}
+
+// keys sort from the highest capacity, so that type 0 is the fastest
+static void read_core_types(cpufreq_bindings_topology* topo, const uint8_t* pending) {
+  char path[SYSFS_PATH_MAX_LEN];
+  uint32_t capacity;
+  uint32_t core;
+  uint32_t n = 0;
+  uint32_t i;
+  for (core = 0; core < topo->ncores; core++) {
+    if (!pending[core]) {
+      continue;
+    }
+    if (topo->core_type_src == CORE_TYPE_CAPACITY && read_capacity(core, &capacity)) {
+      // unknown is the lowest
+      capacity = 0;
+    }
+    set_key(topo, core, CPUFREQ_BINDINGS_TOPOLOGY_CORE_TYPE,
+            topo->core_type_src == CORE_TYPE_CAPACITY ? UINT32_MAX - capacity : 0);
+  }
+  if (topo->core_type_src == CORE_TYPE_HYBRID) {
+    if (!cpufreq_bindings_sysfs_path(path, sizeof(path), ATOM_CPUS)) {
+      n = read_cpulist(path, topo->cpus, CPULIST_MAX);
+    }
+    for (i = 0; i < n; i++) {
+      if (topo->cpus[i] < topo->ncores && pending[topo->cpus[i]]) {
+        set_key(topo, topo->cpus[i], CPUFREQ_BINDINGS_TOPOLOGY_CORE_TYPE, 1);
+      }
+    }
+  }
+}
+
+static void read_online(cpufreq_bindings_topology* topo, uint8_t* online) {
+  char path[SYSFS_PATH_MAX_LEN];
+  uint32_t n;
+  uint32_t i;
+  if (cpufreq_bindings_sysfs_path(path, sizeof(path), CPU_DIR "/online") ||
+      (n = read_cpulist(path, topo->cpus, CPULIST_MAX)) == 0) {
+    LOG(DEBUG, "read_online: %s/online not available, assuming all cores are online\n", CPU_DIR);
+    memset(online, 1, topo->ncores);
+    return;
+  }
+  memset(online, 0, topo->ncores);
+  for (i = 0; i < n; i++) {
+    if (topo->cpus[i] < topo->ncores) {
+      online[topo->cpus[i]] = 1;
+    }
+  }
+}
+
+static void level_free(topo_level* level) {
+  // all arrays share the key array's allocation
+  free(level->keys);
+  memset(level, 0, sizeof(*level));
+}
+
+// group the online cores at a level, and collect each group's policies
+static int build_level(cpufreq_bindings_topology* topo, const uint8_t* online, const cpufreq_bindings_policies* p,
+                       cpufreq_bindings_topology_level lvl, topo_level* level, uint32_t* core_groups,
+                       uint32_t* keys, uint64_t* pairs) {
+  const uint32_t* found;
+  uint32_t nkeys = 0;
+  uint32_t npairs = 0;
+  uint32_t core;
+  uint32_t g;
+  uint32_t i;
+  uint32_t n;
+  for (core = 0; core < topo->ncores; core++) {
+    if (online[core]) {
+      keys[nkeys++] = get_key(topo, core, lvl);
+    }
+  }
+  qsort(keys, nkeys, sizeof(uint32_t), cmp_u32);
+  for (i = 1, n = nkeys > 0; i < nkeys; i++) {
+    if (keys[i] != keys[n - 1]) {
+      keys[n++] = keys[i];
+    }
+  }
+  // (group, policy index) pairs, deduplicated
+  for (core = 0; core < topo->ncores; core++) {
+    if (!online[core]) {
+      core_groups[core * LEVELS + lvl] = NO_GROUP;
+      continue;
+    }
+    found = bsearch(&topo->core_keys[core * LEVELS + lvl], keys, n, sizeof(uint32_t), cmp_u32);
+    core_groups[core * LEVELS + lvl] = g = (uint32_t) (found - keys);
+    if (p->core_idx[core] != NO_POLICY) {
+      pairs[npairs++] = ((uint64_t) g << 32) | p->core_idx[core];
+    }
+  }
+  qsort(pairs, npairs, sizeof(uint64_t), cmp_u64);
+  for (i = 1, nkeys = npairs > 0; i < npairs; i++) {
+    if (pairs[i] != pairs[nkeys - 1]) {
+      pairs[nkeys++] = pairs[i];
+    }
+  }
+  npairs = nkeys;
+  if ((level->keys = malloc((2 * n + 1 + 2 * npairs) * sizeof(uint32_t))) == NULL) {
+    return -1;
+  }
+  level->ngroups = n;
+  level->off = &level->keys[n];
+  level->policies = &level->off[n + 1];
+  level->reps = &level->policies[npairs];
+  memcpy(level->keys, keys, n * sizeof(uint32_t));
+  for (g = 0, i = 0; g < n; g++) {
+    level->off[g] = i;
+    for (; i < npairs && (uint32_t) (pairs[i] >> 32) == g; i++) {
+      level->policies[i] = p->ids[(uint32_t) pairs[i]];
+      level->reps[i] = p->reps[(uint32_t) pairs[i]];
+    }
+  }
+  level->off[n] = npairs;
+  return 0;
+}
+
+// replaces the index only if the whole rebuild succeeds
+static int rebuild(cpufreq_bindings_topology* topo, const uint8_t* online, const cpufreq_bindings_policies* p) {
+  topo_level levels[LEVELS] = { { 0 } };
+  uint32_t* core_groups = malloc(topo->ncores * LEVELS * sizeof(uint32_t));
+  uint32_t* keys = malloc(topo->ncores * sizeof(uint32_t));
+  uint64_t* pairs = malloc(topo->ncores * sizeof(uint64_t));
+  int err_save;
+  int ret = -1;
+  int l;
+  if (core_groups != NULL && keys != NULL && pairs != NULL) {
+    for (l = 0; l < LEVELS; l++) {
+      if (build_level(topo, online, p, (cpufreq_bindings_topology_level) l, &levels[l], core_groups, keys, pairs)) {
+        break;
+      }
+    }
+    ret = l == LEVELS ? 0 : -1;
+  }
+  err_save = errno;
+  if (ret == 0) {
+    for (l = 0; l < LEVELS; l++) {
+      level_free(&topo->levels[l]);
+      topo->levels[l] = levels[l];
+    }
+    free(topo->core_groups);
+    topo->core_groups = core_groups;
+    memcpy(topo->online, online, topo->ncores);
+  } else {
+    for (l = 0; l < LEVELS; l++) {
+      level_free(&levels[l]);
+    }
+    free(core_groups);
+  }
+  free(keys);
+  free(pairs);
+  errno = err_save;
+  return ret;
+}
+
+static int update(cpufreq_bindings_topology* topo, int refresh_policies) {
+  const cpufreq_bindings_policies* p;
+  uint8_t* online = malloc(3 * topo->ncores);
+  uint8_t* pending;
+  uint8_t* todo;
+  uint32_t npending = 0;
+  uint32_t core;
+  int ret = -1;
+  if (online == NULL) {
+    return -1;
+  }
+  pending = &online[topo->ncores];
+  todo = &pending[topo->ncores];
+  read_online(topo, online);
+  // only cores that came online need to be read - cores that went offline just drop out of their groups
+  for (core = 0; core < topo->ncores; core++) {
+    pending[core] = online[core] && !topo->online[core];
+    npending += pending[core];
+  }
+  if (npending > 0) {
+    if (topo->core_groups == NULL) {
+      detect_core_types(topo, pending);
+    }
+    read_shared_ids(topo, pending, todo, CPUFREQ_BINDINGS_TOPOLOGY_PACKAGE, "physical_package_id", "package_cpus_list",
+                    "core_siblings_list", -1);
+    read_shared_ids(topo, pending, todo, CPUFREQ_BINDINGS_TOPOLOGY_CLUSTER, "cluster_id", "cluster_cpus_list", NULL,
+                    CPUFREQ_BINDINGS_TOPOLOGY_PACKAGE);
+    read_nodes(topo, pending);
+    read_core_types(topo, pending);
+  }
+  // other threads may still be using the context - the refresh retires the old policy table rather than freeing it
+  if ((!refresh_policies || !cpufreq_bindings_ctx_refresh_policies(topo->ctx)) &&
+      (p = cpufreq_bindings_ctx_policies(topo->ctx)) != NULL) {
+    ret = rebuild(topo, online, p);
+    cpufreq_bindings_ctx_policies_release(topo->ctx);
+  }
+  free(online);
+  return ret;
+}
+
+cpufreq_bindings_topology* cpufreq_bindings_topology_init(cpufreq_bindings_ctx* ctx) {
+  cpufreq_bindings_topology* topo;
+  int err_save;
+  if (ctx == NULL) {
+    errno = EINVAL;
+    return NULL;
+  }
+  if ((topo = calloc(1, sizeof(cpufreq_bindings_topology))) == NULL) {
+    return NULL;
+  }
+  topo->ctx = ctx;
+  topo->ncores = ctx->ncores;
+  topo->online = calloc(topo->ncores, sizeof(uint8_t));
+  topo->core_keys = malloc(topo->ncores * LEVELS * sizeof(uint32_t));
+  topo->cpus = malloc(CPULIST_MAX * sizeof(uint32_t));
+  if (topo->online == NULL || topo->core_keys == NULL || topo->cpus == NULL || update(topo, 0)) {
+    err_save = errno;
+    cpufreq_bindings_topology_destroy(topo);
+    errno = err_save;
+    return NULL;
+  }
+  return topo;
+}
+
+void cpufreq_bindings_topology_destroy(cpufreq_bindings_topology* topo) {
+  int l;
+  for (l = 0; l < LEVELS; l++) {
+    level_free(&topo->levels[l]);
+  }
+  free(topo->online);
+  free(topo->core_keys);
+  free(topo->core_groups);
+  free(topo->cpus);
+  free(topo);
+}
+
+int cpufreq_bindings_topology_refresh(cpufreq_bindings_topology* topo) {
+  return update(topo, 1);
+}
+
+static uint32_t group_id(cpufreq_bindings_topology_level level, const topo_level* l, uint32_t idx) {
+  return level == CPUFREQ_BINDINGS_TOPOLOGY_CORE_TYPE ? idx : l->keys[idx];
+}
+
+// returns the level, or NULL if "level" or "group" is invalid (errno will be set)
+static const topo_level* find_group(const cpufreq_bindings_topology* topo, cpufreq_bindings_topology_level level,
+                                    uint32_t group, uint32_t* idx) {
+  const topo_level* l;
+  const uint32_t* found;
+  if ((unsigned int) level >= LEVELS) {
+    errno = EINVAL;
+    return NULL;
+  }
+  l = &topo->levels[level];
+  if (level == CPUFREQ_BINDINGS_TOPOLOGY_CORE_TYPE) {
+    *idx = group;
+  } else {
+    found = bsearch(&group, l->keys, l->ngroups, sizeof(uint32_t), cmp_u32);
+    *idx = found == NULL ? NO_GROUP : (uint32_t) (found - l->keys);
+  }
+  if (*idx >= l->ngroups) {
+    errno = EINVAL;
+    return NULL;
+  }
+  return l;
+}
+
+uint32_t cpufreq_bindings_topology_get_groups(const cpufreq_bindings_topology* topo,
+                                              cpufreq_bindings_topology_level level, uint32_t* groups, uint32_t len) {
+  const topo_level* l;
+  uint32_t i;
+  if ((unsigned int) level >= LEVELS) {
+    errno = EINVAL;
+    return 0;
+  }
+  l = &topo->levels[level];
+  if (l->ngroups > len) {
+    errno = ERANGE;
+    return 0;
+  }
+  for (i = 0; i < l->ngroups; i++) {
+    groups[i] = group_id(level, l, i);
+  }
+  return l->ngroups;
+}
+
+int cpufreq_bindings_topology_get_core_group(const cpufreq_bindings_topology* topo, uint32_t core,
+                                             cpufreq_bindings_topology_level level, uint32_t* group) {
+  uint32_t idx;
+  if (core >= topo->ncores || (unsigned int) level >= LEVELS ||
+      (idx = topo->core_groups[core * LEVELS + level]) == NO_GROUP) {
+    errno = EINVAL;
+    return -1;
+  }
+  *group = group_id(level, &topo->levels[level], idx);
+  return 0;
+}
+
+uint32_t cpufreq_bindings_topology_get_group_cpus(const cpufreq_bindings_topology* topo,
+                                                  cpufreq_bindings_topology_level level, uint32_t group,
+                                                  uint32_t* cpus, uint32_t len) {
+  uint32_t idx;
+  uint32_t core;
+  uint32_t n = 0;
+  if (find_group(topo, level, group, &idx) == NULL) {
+    return 0;
+  }
+  for (core = 0; core < topo->ncores; core++) {
+    if (topo->core_groups[core * LEVELS + level] == idx) {
+      if (n == len) {
+        // the array wasn't big enough
+        errno = ERANGE;
+        return 0;
+      }
+      cpus[n++] = core;
+    }
+  }
+  return n;
+}
+
+uint32_t cpufreq_bindings_topology_get_group_policies(const cpufreq_bindings_topology* topo,
+                                                      cpufreq_bindings_topology_level level, uint32_t group,
+                                                      uint32_t* policies, uint32_t len) {
+  const topo_level* l;
+  uint32_t idx;
+  uint32_t n;
+  if ((l = find_group(topo, level, group, &idx)) == NULL) {
+    return 0;
+  }
+  if ((n = l->off[idx + 1] - l->off[idx]) == 0) {
+    errno = ENODEV;
+    return 0;
+  }
+  if (n > len) {
+    errno = ERANGE;
+    return 0;
+  }
+  memcpy(policies, &l->policies[l->off[idx]], n * sizeof(uint32_t));
+  return n;
+}
+
+// returns the representative cores of a group's policies, or NULL on failure (errno will be set)
+static const uint32_t* group_reps(const cpufreq_bindings_topology* topo, cpufreq_bindings_topology_level level,
+                                  uint32_t group, uint32_t* n) {
+  const topo_level* l;
+  uint32_t idx;
+  if ((l = find_group(topo, level, group, &idx)) == NULL) {
+    return NULL;
+  }
+  if ((*n = l->off[idx + 1] - l->off[idx]) == 0) {
+    // none of the group's cores have cpufreq
+    errno = ENODEV;
+    return NULL;
+  }
+  return &l->reps[l->off[idx]];
+}
+
+// returns the number of successes, setting errno to the first failure
+static uint32_t count_status(const int* status, uint32_t n) {
+  uint32_t ok = 0;
+  uint32_t i;
+  int err = 0;
+  for (i = 0; i < n; i++) {
+    if (status[i] == 0) {
+      ok++;
+    } else if (err == 0) {
+      err = status[i];
+    }
+  }
+  if (err) {
+    errno = err;
+  }
+  return ok;
+}
+
+uint32_t cpufreq_bindings_topology_get_u32(cpufreq_bindings_topology* topo, cpufreq_bindings_topology_level level,
+                                           uint32_t group, cpufreq_bindings_file file, uint32_t* vals, int* status,
+                                           uint32_t len) {
+  const uint32_t* reps;
+  uint32_t n;
+  if ((reps = group_reps(topo, level, group, &n)) == NULL) {
+    return 0;
+  }
+  if (n > len) {
+    errno = ERANGE;
+    return 0;
+  }
+  return cpufreq_bindings_ctx_u32_batch(topo->ctx, &file, 1, reps, n, NULL, vals, status);
+}
+
+uint32_t cpufreq_bindings_topology_set_u32(cpufreq_bindings_topology* topo, cpufreq_bindings_topology_level level,
+                                           uint32_t group, cpufreq_bindings_file file, uint32_t val) {
+  const uint32_t* reps;
+  uint32_t* vals;
+  int* status;
+  uint32_t n;
+  uint32_t i;
+  if (file != CPUFREQ_BINDINGS_FILE_SCALING_MAX_FREQ && file != CPUFREQ_BINDINGS_FILE_SCALING_MIN_FREQ &&
+      file != CPUFREQ_BINDINGS_FILE_SCALING_SETSPEED) {
+    errno = EINVAL;
+    return 0;
+  }
+  if ((reps = group_reps(topo, level, group, &n)) == NULL) {
+    return 0;
+  }
+  if ((vals = malloc(n * (sizeof(uint32_t) + sizeof(int)))) == NULL) {
+    return 0;
+  }
+  status = (int*) (void*) &vals[n];
+  for (i = 0; i < n; i++) {
+    vals[i] = val;
+  }
+  cpufreq_bindings_ctx_u32_batch(topo->ctx, &file, 1, reps, n, vals, NULL, status);
+  n = count_status(status, n);
+  free(vals);
+  return n;
+}
+
+uint32_t cpufreq_bindings_topology_set_str(cpufreq_bindings_topology* topo, cpufreq_bindings_topology_level level,
+                                           uint32_t group, cpufreq_bindings_file file, const char* str) {
+  const uint32_t* reps;
+  int* status;
+  uint32_t n;
+  uint32_t i;
+  if (str == NULL || (file != CPUFREQ_BINDINGS_FILE_SCALING_GOVERNOR &&
+                      file != CPUFREQ_BINDINGS_FILE_ENERGY_PERFORMANCE_PREFERENCE)) {
+    errno = EINVAL;
+    return 0;
+  }
+  if ((reps = group_reps(topo, level, group, &n)) == NULL) {
+    return 0;
+  }
+  if ((status = malloc(n * sizeof(int))) == NULL) {
+    return 0;
+  }
+  if (file == CPUFREQ_BINDINGS_FILE_ENERGY_PERFORMANCE_PREFERENCE) {
+    // left as is if the preference is too long to write at all
+    for (i = 0; i < n; i++) {
+      status[i] = EINVAL;
+    }
+    cpufreq_bindings_ctx_set_energy_performance_preference_batch(topo->ctx, reps, n, str, status);
+  } else {
+    for (i = 0; i < n; i++) {
+      status[i] = cpufreq_bindings_ctx_set_scaling_governor(topo->ctx, reps[i], str, strlen(str)) < 0 ? errno : 0;
+    }
+  }
+  n = count_status(status, n);
+  free(status);
+  return n;
+}
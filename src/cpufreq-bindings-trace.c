@@ -0,0 +1,244 @@
+/**
+ * Binary trace recording of writes, and trace readers.
+ *
+ * @author Connor Imes
+ * @date 2026-10-15
+ */
+// for clock_gettime, ftruncate
+#define _POSIX_C_SOURCE 200809L
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#include "cpufreq-bindings.h"
+#include "cpufreq-bindings-common.h"
+#include "cpufreq-bindings-instrument.h"
+#include "cpufreq-bindings-trace.h"
+
+typedef struct trace_state {
+  int fd;
+  cpufreq_bindings_trace_header* hdr;
+  cpufreq_bindings_trace_record* records;
+  size_t size;
+  // writers currently appending, which stop waits for
+  uint32_t writers;
+} trace_state;
+
+struct cpufreq_bindings_trace_reader {
+  const cpufreq_bindings_trace_header* hdr;
+  const cpufreq_bindings_trace_record* records;
+  uint64_t count;
+  size_t size;
+};
+
+int cpufreq_bindings_trace_enabled = 0;
+
+static trace_state trace = { -1, NULL, NULL, 0, 0 };
+
+static uint64_t clock_ns(clockid_t clk) {
+  struct timespec ts;
+  clock_gettime(clk, &ts);
+  return (uint64_t) ts.tv_sec * 1000000000ULL + (uint64_t) ts.tv_nsec;
+}
+
+uint64_t cpufreq_bindings_trace_now(void) {
+  return clock_ns(CLOCK_MONOTONIC);
+}
+
+int cpufreq_bindings_trace_start(const char* path, uint64_t capacity) {
+  cpufreq_bindings_trace_header* hdr;
+  size_t size = sizeof(cpufreq_bindings_trace_header) + capacity * sizeof(cpufreq_bindings_trace_record);
+  void* addr;
+  int err_save;
+  int fd;
+  if (capacity == 0 || capacity > (SIZE_MAX - sizeof(cpufreq_bindings_trace_header)) /
+                                  sizeof(cpufreq_bindings_trace_record)) {
+    errno = EINVAL;
+    return -1;
+  }
+  if (trace.hdr != NULL) {
+    errno = EBUSY;
+    return -1;
+  }
+  if ((fd = open(path, O_CREAT | O_RDWR | O_TRUNC, 0644)) < 0) {
+    PERROR(ERROR, "cpufreq_bindings_trace_start: open");
+    return -1;
+  }
+  if (ftruncate(fd, (off_t) size)) {
+    PERROR(ERROR, "cpufreq_bindings_trace_start: ftruncate");
+    addr = MAP_FAILED;
+  } else if ((addr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0)) == MAP_FAILED) {
+    PERROR(ERROR, "cpufreq_bindings_trace_start: mmap");
+  }
+  if (addr == MAP_FAILED) {
+    err_save = errno;
+    close(fd);
+    errno = err_save;
+    return -1;
+  }
+  // the file is zero-filled, so every record starts out unused
+  hdr = addr;
+  hdr->version = CPUFREQ_BINDINGS_TRACE_VERSION;
+  hdr->record_size = sizeof(cpufreq_bindings_trace_record);
+  hdr->start_ns = clock_ns(CLOCK_MONOTONIC);
+  hdr->start_realtime_ns = clock_ns(CLOCK_REALTIME);
+  hdr->capacity = capacity;
+  hdr->magic = CPUFREQ_BINDINGS_TRACE_MAGIC;
+  trace.fd = fd;
+  trace.hdr = hdr;
+  trace.records = (cpufreq_bindings_trace_record*) (void*) &hdr[1];
+  trace.size = size;
+  __atomic_store_n(&cpufreq_bindings_trace_enabled, 1, __ATOMIC_SEQ_CST);
+  return 0;
+}
+
+int cpufreq_bindings_trace_stop(uint64_t* dropped) {
+  uint64_t count;
+  size_t size;
+  int ret = 0;
+  if (trace.hdr == NULL) {
+    errno = EINVAL;
+    return -1;
+  }
+  // writers check the flag again after registering, so once there are none, none can start
+  __atomic_store_n(&cpufreq_bindings_trace_enabled, 0, __ATOMIC_SEQ_CST);
+  while (__atomic_load_n(&trace.writers, __ATOMIC_SEQ_CST) > 0) {
+    sched_yield();
+  }
+  count = trace.hdr->count;
+  if (dropped != NULL) {
+    *dropped = count > trace.hdr->capacity ? count - trace.hdr->capacity : 0;
+  }
+  if (count < trace.hdr->capacity) {
+    trace.hdr->capacity = count;
+  }
+  size = sizeof(cpufreq_bindings_trace_header) + trace.hdr->capacity * sizeof(cpufreq_bindings_trace_record);
+  if (msync(trace.hdr, trace.size, MS_SYNC)) {
+    PERROR(WARN, "cpufreq_bindings_trace_stop: msync");
+    ret = -1;
+  }
+  munmap(trace.hdr, trace.size);
+  if (ftruncate(trace.fd, (off_t) size)) {
+    PERROR(WARN, "cpufreq_bindings_trace_stop: ftruncate");
+    ret = -1;
+  }
+  if (close(trace.fd)) {
+    PERROR(WARN, "cpufreq_bindings_trace_stop: close");
+    ret = -1;
+  }
+  trace.fd = -1;
+  trace.hdr = NULL;
+  trace.records = NULL;
+  trace.size = 0;
+  return ret;
+}
+
+// returns the reserved record, or NULL if not recording or full - if not NULL, trace_commit must be called
+static cpufreq_bindings_trace_record* trace_reserve(uint64_t start_ns, uint32_t core, cpufreq_bindings_file file) {
+  cpufreq_bindings_trace_record* r;
+  uint64_t idx;
+  __atomic_fetch_add(&trace.writers, 1, __ATOMIC_SEQ_CST);
+  if (!__atomic_load_n(&cpufreq_bindings_trace_enabled, __ATOMIC_SEQ_CST) ||
+      (idx = __atomic_fetch_add(&trace.hdr->count, 1, __ATOMIC_RELAXED)) >= trace.hdr->capacity) {
+    __atomic_fetch_sub(&trace.writers, 1, __ATOMIC_RELEASE);
+    return NULL;
+  }
+  r = &trace.records[idx];
+  // a write may have been issued just before recording started
+  r->timestamp_ns = start_ns > trace.hdr->start_ns ? start_ns - trace.hdr->start_ns : 0;
+  r->core = core;
+  r->file = (uint16_t) file;
+  return r;
+}
+
+static void trace_commit(cpufreq_bindings_trace_record* r, cpufreq_bindings_trace_type type) {
+  __atomic_store_n(&r->type, (uint8_t) type, __ATOMIC_RELEASE);
+  __atomic_fetch_sub(&trace.writers, 1, __ATOMIC_RELEASE);
+}
+
+void cpufreq_bindings_trace_u32(uint64_t start_ns, uint32_t core, cpufreq_bindings_file file, uint32_t val) {
+  cpufreq_bindings_trace_record* r = trace_reserve(start_ns, core, file);
+  if (r != NULL) {
+    r->len = 0;
+    r->value.u32 = val;
+    trace_commit(r, CPUFREQ_BINDINGS_TRACE_U32);
+  }
+}
+
+void cpufreq_bindings_trace_str(uint64_t start_ns, uint32_t core, cpufreq_bindings_file file, const char* str,
+                                size_t len) {
+  cpufreq_bindings_trace_record* r = trace_reserve(start_ns, core, file);
+  if (r != NULL) {
+    r->len = len > UINT8_MAX ? UINT8_MAX : (uint8_t) len;
+    memcpy(r->value.str, str, len < CPUFREQ_BINDINGS_TRACE_STR_LEN ? len : CPUFREQ_BINDINGS_TRACE_STR_LEN);
+    trace_commit(r, CPUFREQ_BINDINGS_TRACE_STR);
+  }
+}
+
+cpufreq_bindings_trace_reader* cpufreq_bindings_trace_reader_open(const char* path) {
+  cpufreq_bindings_trace_reader* reader;
+  const cpufreq_bindings_trace_header* hdr;
+  struct stat st;
+  uint64_t count;
+  void* addr;
+  int err_save;
+  int fd;
+  if ((fd = open(path, O_RDONLY)) < 0) {
+    return NULL;
+  }
+  if (fstat(fd, &st) || (size_t) st.st_size < sizeof(cpufreq_bindings_trace_header)) {
+    err_save = errno;
+    close(fd);
+    errno = err_save ? err_save : EPROTO;
+    return NULL;
+  }
+  addr = mmap(NULL, (size_t) st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  err_save = errno;
+  close(fd);
+  if (addr == MAP_FAILED) {
+    errno = err_save;
+    return NULL;
+  }
+  hdr = addr;
+  if (hdr->magic != CPUFREQ_BINDINGS_TRACE_MAGIC || hdr->version != CPUFREQ_BINDINGS_TRACE_VERSION ||
+      hdr->record_size != sizeof(cpufreq_bindings_trace_record)) {
+    munmap(addr, (size_t) st.st_size);
+    errno = EPROTO;
+    return NULL;
+  }
+  if ((reader = malloc(sizeof(cpufreq_bindings_trace_reader))) == NULL) {
+    munmap(addr, (size_t) st.st_size);
+    return NULL;
+  }
+  // a trace that wasn't stopped may have reserved more records than it has room for
+  count = ((size_t) st.st_size - sizeof(cpufreq_bindings_trace_header)) / sizeof(cpufreq_bindings_trace_record);
+  if (hdr->count < count) {
+    count = hdr->count;
+  }
+  reader->hdr = hdr;
+  reader->records = (const cpufreq_bindings_trace_record*) (const void*) &hdr[1];
+  reader->count = count;
+  reader->size = (size_t) st.st_size;
+  return reader;
+}
+
+const cpufreq_bindings_trace_header* cpufreq_bindings_trace_reader_header(const cpufreq_bindings_trace_reader* reader) {
+  return reader->hdr;
+}
+
+const cpufreq_bindings_trace_record* cpufreq_bindings_trace_reader_records(const cpufreq_bindings_trace_reader* reader,
+                                                                           uint64_t* count) {
+  *count = reader->count;
+  return reader->records;
+}
+
+void cpufreq_bindings_trace_reader_close(cpufreq_bindings_trace_reader* reader) {
+  munmap((void*) (uintptr_t) reader->hdr, reader->size);
+  free(reader);
+}
@@ -0,0 +1,290 @@
+/**
+ * Measure frequency transition latency by writing a target and spin-polling until it is reported.
+ *
+ * @author Connor Imes
+ * @date 2026-10-15
+ */
+// for clock_gettime
+#define _POSIX_C_SOURCE 200809L
+#include <errno.h>
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "cpufreq-bindings.h"
+#include "cpufreq-bindings-common.h"
+#include "cpufreq-bindings-ctx.h"
+#include "cpufreq-bindings-transition.h"
+
+// "cur_max" is the current "scaling_max_freq"; returns 0 or an errno value
+static int clamp_set(cpufreq_bindings_ctx* ctx, uint32_t core, uint32_t freq, uint32_t cur_max) {
+  int err;
+  if (freq > cur_max) {
+    // raise the max first so min never exceeds it
+    if (!(err = cpufreq_bindings_ctx_u32_write(ctx, core, CPUFREQ_BINDINGS_FILE_SCALING_MAX_FREQ, freq))) {
+      err = cpufreq_bindings_ctx_u32_write(ctx, core, CPUFREQ_BINDINGS_FILE_SCALING_MIN_FREQ, freq);
+    }
+  } else {
+    if (!(err = cpufreq_bindings_ctx_u32_write(ctx, core, CPUFREQ_BINDINGS_FILE_SCALING_MIN_FREQ, freq))) {
+      err = cpufreq_bindings_ctx_u32_write(ctx, core, CPUFREQ_BINDINGS_FILE_SCALING_MAX_FREQ, freq);
+    }
+  }
+  return err;
+}
+
+int cpufreq_bindings_ctx_transition_set(cpufreq_bindings_ctx* ctx, uint32_t core, uint32_t freq,
+                                        cpufreq_bindings_transition_method method) {
+  uint32_t cur_max;
+  int err;
+  switch (method) {
+    case CPUFREQ_BINDINGS_TRANSITION_SETSPEED:
+      err = cpufreq_bindings_ctx_u32_write(ctx, core, CPUFREQ_BINDINGS_FILE_SCALING_SETSPEED, freq);
+      break;
+    case CPUFREQ_BINDINGS_TRANSITION_CLAMP:
+      if (!(err = cpufreq_bindings_ctx_u32_read(ctx, core, CPUFREQ_BINDINGS_FILE_SCALING_MAX_FREQ, &cur_max))) {
+        err = clamp_set(ctx, core, freq, cur_max);
+      }
+      break;
+    default:
+      err = EINVAL;
+      break;
+  }
+  if (err) {
+    errno = err;
+    return -1;
+  }
+  return 0;
+}
+
+// spin until the reported frequency is within tolerance of "freq"; returns 0 or an errno value
+static int wait_for(cpufreq_bindings_ctx* ctx, uint32_t core, uint32_t freq,
+                    const cpufreq_bindings_transition_opts* opts, uint64_t start, uint64_t* end) {
+  uint32_t cur;
+  int err;
+  for (;;) {
+    // read errors may be transient (e.g., EBUSY while the driver changes frequency), so retry until the timeout
+    err = cpufreq_bindings_ctx_u32_read(ctx, core, opts->poll_file, &cur);
+    *end = now_ns();
+    if (!err && (cur > freq ? cur - freq : freq - cur) <= opts->tolerance) {
+      return 0;
+    }
+    if (*end - start > opts->timeout_ns) {
+      // an error that persisted until the timeout is reported instead of the timeout
+      return err ? err : ETIMEDOUT;
+    }
+  }
+}
+
+static int measure(cpufreq_bindings_ctx* ctx, uint32_t core, uint32_t from, uint32_t to,
+                   const cpufreq_bindings_transition_opts* opts, uint64_t* latency_ns) {
+  uint64_t start;
+  uint64_t end;
+  int err;
+  if (opts->poll_file != CPUFREQ_BINDINGS_FILE_CPUINFO_CUR_FREQ &&
+      opts->poll_file != CPUFREQ_BINDINGS_FILE_SCALING_CUR_FREQ) {
+    return EINVAL;
+  }
+  if (cpufreq_bindings_ctx_transition_set(ctx, core, from, opts->method)) {
+    return errno;
+  }
+  if ((err = wait_for(ctx, core, from, opts, now_ns(), &end))) {
+    return err;
+  }
+  start = now_ns();
+  // after settling, min == max == from for CLAMP, so skip reading the max again
+  err = opts->method == CPUFREQ_BINDINGS_TRANSITION_CLAMP ? clamp_set(ctx, core, to, from) :
+        cpufreq_bindings_ctx_transition_set(ctx, core, to, opts->method) ? errno : 0;
+  if (err || (err = wait_for(ctx, core, to, opts, start, &end))) {
+    return err;
+  }
+  *latency_ns = end - start;
+  return 0;
+}
+
+int cpufreq_bindings_ctx_measure_transition(cpufreq_bindings_ctx* ctx, uint32_t core, uint32_t from, uint32_t to,
+                                            const cpufreq_bindings_transition_opts* opts, uint64_t* latency_ns) {
+  int err;
+  if ((err = measure(ctx, core, from, to, opts, latency_ns))) {
+    errno = err;
+    return -1;
+  }
+  return 0;
+}
+
+static int cmp_u64(const void* a, const void* b) {
+  uint64_t x = *(const uint64_t*) a;
+  uint64_t y = *(const uint64_t*) b;
+  return x < y ? -1 : x > y ? 1 : 0;
+}
+
+static uint32_t hist_bucket(uint64_t ns) {
+  uint64_t us = ns / 1000;
+  uint32_t b = 0;
+  while (us > 0 && b < CPUFREQ_BINDINGS_TRANSITION_HIST_BUCKETS - 1) {
+    us >>= 1;
+    b++;
+  }
+  return b;
+}
+
+static void summarize(cpufreq_bindings_transition_stats* st, uint64_t* lat_ns) {
+  uint64_t total = 0;
+  uint32_t i;
+  if (st->samples == 0) {
+    return;
+  }
+  qsort(lat_ns, st->samples, sizeof(uint64_t), cmp_u64);
+  for (i = 0; i < st->samples; i++) {
+    total += lat_ns[i];
+    st->hist[hist_bucket(lat_ns[i])]++;
+  }
+  st->min_ns = lat_ns[0];
+  st->p50_ns = lat_ns[st->samples / 2];
+  st->p99_ns = lat_ns[(uint64_t) st->samples * 99 / 100];
+  st->max_ns = lat_ns[st->samples - 1];
+  st->mean_ns = (double) total / st->samples;
+}
+
+#define GOVERNOR_LEN 32
+
+typedef struct transition_saved {
+  uint32_t min;
+  uint32_t max;
+  uint32_t setspeed;
+  // for SETSPEED, the governor to restore if it wasn't "userspace"
+  char governor[GOVERNOR_LEN];
+  int switched;
+  int ok;
+} transition_saved;
+
+// SETSPEED switches to the "userspace" governor if necessary; returns 0 or an errno value
+static int save(cpufreq_bindings_ctx* ctx, uint32_t core, cpufreq_bindings_transition_method method,
+                transition_saved* saved) {
+  static const char userspace[] = "userspace";
+  memset(saved, 0, sizeof(*saved));
+  if (method == CPUFREQ_BINDINGS_TRANSITION_CLAMP) {
+    saved->ok = !cpufreq_bindings_ctx_u32_read(ctx, core, CPUFREQ_BINDINGS_FILE_SCALING_MIN_FREQ, &saved->min) &&
+                !cpufreq_bindings_ctx_u32_read(ctx, core, CPUFREQ_BINDINGS_FILE_SCALING_MAX_FREQ, &saved->max);
+    return 0;
+  }
+  if (cpufreq_bindings_ctx_get_scaling_governor(ctx, core, saved->governor, sizeof(saved->governor) - 1) <= 0) {
+    return errno;
+  }
+  if (strcmp(saved->governor, userspace)) {
+    // "scaling_setspeed" reads "<unsupported>" under other governors, so restore the governor instead
+    if (cpufreq_bindings_ctx_set_scaling_governor(ctx, core, userspace, sizeof(userspace) - 1) < 0) {
+      return errno;
+    }
+    saved->switched = 1;
+    saved->ok = 1;
+  } else {
+    saved->ok = !cpufreq_bindings_ctx_u32_read(ctx, core, CPUFREQ_BINDINGS_FILE_SCALING_SETSPEED, &saved->setspeed);
+  }
+  return 0;
+}
+
+static void restore(cpufreq_bindings_ctx* ctx, uint32_t core, cpufreq_bindings_transition_method method,
+                    const transition_saved* saved) {
+  uint32_t cur_max = 0;
+  int err;
+  if (!saved->ok) {
+    return;
+  }
+  if (method == CPUFREQ_BINDINGS_TRANSITION_CLAMP) {
+    // min == max, so write whichever keeps min <= max
+    cpufreq_bindings_ctx_u32_read(ctx, core, CPUFREQ_BINDINGS_FILE_SCALING_MAX_FREQ, &cur_max);
+    if (saved->max >= cur_max) {
+      if (!(err = cpufreq_bindings_ctx_u32_write(ctx, core, CPUFREQ_BINDINGS_FILE_SCALING_MAX_FREQ, saved->max))) {
+        err = cpufreq_bindings_ctx_u32_write(ctx, core, CPUFREQ_BINDINGS_FILE_SCALING_MIN_FREQ, saved->min);
+      }
+    } else {
+      if (!(err = cpufreq_bindings_ctx_u32_write(ctx, core, CPUFREQ_BINDINGS_FILE_SCALING_MIN_FREQ, saved->min))) {
+        err = cpufreq_bindings_ctx_u32_write(ctx, core, CPUFREQ_BINDINGS_FILE_SCALING_MAX_FREQ, saved->max);
+      }
+    }
+  } else if (saved->switched) {
+    err = cpufreq_bindings_ctx_set_scaling_governor(ctx, core, saved->governor, strlen(saved->governor)) < 0 ?
+          errno : 0;
+  } else {
+    err = cpufreq_bindings_ctx_u32_write(ctx, core, CPUFREQ_BINDINGS_FILE_SCALING_SETSPEED, saved->setspeed);
+  }
+  if (err) {
+    errno = err;
+    PERROR(WARN, "cpufreq_bindings_ctx_measure_transitions: failed to restore settings");
+  }
+}
+
+uint32_t cpufreq_bindings_ctx_measure_transitions(cpufreq_bindings_ctx* ctx, uint32_t core, const uint32_t* freqs,
+                                                  uint32_t nfreqs, uint32_t reps,
+                                                  const cpufreq_bindings_transition_opts* opts,
+                                                  cpufreq_bindings_transition_stats* stats, uint32_t len) {
+  transition_saved saved;
+  cpufreq_bindings_transition_stats* st;
+  uint64_t* lat_ns;
+  uint64_t latency;
+  uint32_t npairs;
+  uint32_t n = 0;
+  uint32_t r;
+  uint32_t i;
+  uint32_t j;
+  uint32_t k;
+  int err = 0;
+  if (nfreqs < 2 || reps == 0) {
+    errno = EINVAL;
+    return 0;
+  }
+  npairs = nfreqs * (nfreqs - 1);
+  if (len < npairs) {
+    errno = ERANGE;
+    return 0;
+  }
+  if ((lat_ns = malloc((size_t) npairs * reps * sizeof(uint64_t))) == NULL) {
+    return 0;
+  }
+  memset(stats, 0, npairs * sizeof(cpufreq_bindings_transition_stats));
+  if ((err = save(ctx, core, opts->method, &saved))) {
+    free(lat_ns);
+    errno = err;
+    return 0;
+  }
+  // interleave pairs so slow drift (e.g., thermal) affects them all equally
+  for (r = 0; r < reps; r++) {
+    for (i = 0, k = 0; i < nfreqs; i++) {
+      for (j = 0; j < nfreqs; j++) {
+        if (i == j) {
+          continue;
+        }
+        st = &stats[k];
+        st->from = freqs[i];
+        st->to = freqs[j];
+        if (!(err = measure(ctx, core, freqs[i], freqs[j], opts, &latency))) {
+          lat_ns[(size_t) k * reps + st->samples++] = latency;
+        } else if (err == ETIMEDOUT) {
+          st->timeouts++;
+          err = 0;
+        } else {
+          goto done;
+        }
+        k++;
+      }
+    }
+  }
+
+done:
+  restore(ctx, core, opts->method, &saved);
+  for (k = 0; k < npairs; k++) {
+    summarize(&stats[k], &lat_ns[(size_t) k * reps]);
+    if (stats[k].samples > 0) {
+      n++;
+    }
+  }
+  free(lat_ns);
+  if (err) {
+    errno = err;
+    return 0;
+  }
+  if (n == 0) {
+    errno = ETIMEDOUT;
+  }
+  return n;
+}
@@ -0,0 +1,218 @@
+/**
+ * Minimal io_uring backend using raw system calls (no liburing dependency).
+ *
+ * @author Connor Imes
+ * @date 2026-10-15
+ */
+// for syscall
+#define _GNU_SOURCE
+#include <errno.h>
+#include <linux/io_uring.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include "cpufreq-bindings-uring.h"
+#include "cpufreq-bindings-common.h"
+
+struct cpufreq_bindings_uring {
+  int fd;
+  unsigned int entries;
+  // submission queue
+  unsigned int* sq_tail;
+  unsigned int* sq_mask;
+  unsigned int* sq_array;
+  struct io_uring_sqe* sqes;
+  // completion queue
+  unsigned int* cq_head;
+  unsigned int* cq_tail;
+  unsigned int* cq_mask;
+  struct io_uring_cqe* cqes;
+  // mappings
+  void* sq_ptr;
+  size_t sq_sz;
+  void* cq_ptr;
+  size_t cq_sz;
+  size_t sqes_sz;
+};
+
+static int sys_io_uring_setup(unsigned int entries, struct io_uring_params* p) {
+  return (int) syscall(__NR_io_uring_setup, entries, p);
+}
+
+static int sys_io_uring_enter(int fd, unsigned int to_submit, unsigned int min_complete, unsigned int flags) {
+  return (int) syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, NULL, 0);
+}
+
+static int sys_io_uring_register(int fd, unsigned int opcode, void* arg, unsigned int nr_args) {
+  return (int) syscall(__NR_io_uring_register, fd, opcode, arg, nr_args);
+}
+
+static int probe_ops(int fd) {
+  struct io_uring_probe* probe;
+  size_t sz = sizeof(struct io_uring_probe) + 256 * sizeof(struct io_uring_probe_op);
+  int ret = -1;
+  if ((probe = calloc(1, sz)) == NULL) {
+    return -1;
+  }
+  if (sys_io_uring_register(fd, IORING_REGISTER_PROBE, probe, 256) == 0) {
+    if (probe->last_op >= IORING_OP_WRITE &&
+        (probe->ops[IORING_OP_READ].flags & IO_URING_OP_SUPPORTED) &&
+        (probe->ops[IORING_OP_WRITE].flags & IO_URING_OP_SUPPORTED)) {
+      ret = 0;
+    } else {
+      errno = ENOTSUP;
+    }
+  }
+  free(probe);
+  return ret;
+}
+
+static void unmap_ring(cpufreq_bindings_uring* ring) {
+  if (ring->sqes != NULL && ring->sqes != MAP_FAILED) {
+    munmap(ring->sqes, ring->sqes_sz);
+  }
+  if (ring->cq_ptr != NULL && ring->cq_ptr != MAP_FAILED && ring->cq_ptr != ring->sq_ptr) {
+    munmap(ring->cq_ptr, ring->cq_sz);
+  }
+  if (ring->sq_ptr != NULL && ring->sq_ptr != MAP_FAILED) {
+    munmap(ring->sq_ptr, ring->sq_sz);
+  }
+}
+
+static int map_ring(cpufreq_bindings_uring* ring, const struct io_uring_params* p) {
+  char* sq;
+  char* cq;
+  ring->sq_sz = p->sq_off.array + p->sq_entries * sizeof(unsigned int);
+  ring->cq_sz = p->cq_off.cqes + p->cq_entries * sizeof(struct io_uring_cqe);
+  if (p->features & IORING_FEAT_SINGLE_MMAP) {
+    if (ring->cq_sz > ring->sq_sz) {
+      ring->sq_sz = ring->cq_sz;
+    }
+    ring->cq_sz = ring->sq_sz;
+  }
+  ring->sq_ptr = mmap(NULL, ring->sq_sz, PROT_READ | PROT_WRITE, MAP_SHARED, ring->fd, IORING_OFF_SQ_RING);
+  if (ring->sq_ptr == MAP_FAILED) {
+    return -1;
+  }
+  if (p->features & IORING_FEAT_SINGLE_MMAP) {
+    ring->cq_ptr = ring->sq_ptr;
+  } else {
+    ring->cq_ptr = mmap(NULL, ring->cq_sz, PROT_READ | PROT_WRITE, MAP_SHARED, ring->fd, IORING_OFF_CQ_RING);
+    if (ring->cq_ptr == MAP_FAILED) {
+      return -1;
+    }
+  }
+  ring->sqes_sz = p->sq_entries * sizeof(struct io_uring_sqe);
+  ring->sqes = mmap(NULL, ring->sqes_sz, PROT_READ | PROT_WRITE, MAP_SHARED, ring->fd, IORING_OFF_SQES);
+  if (ring->sqes == MAP_FAILED) {
+    return -1;
+  }
+  sq = ring->sq_ptr;
+  cq = ring->cq_ptr;
+  ring->sq_tail = (unsigned int*) (void*) (sq + p->sq_off.tail);
+  ring->sq_mask = (unsigned int*) (void*) (sq + p->sq_off.ring_mask);
+  ring->sq_array = (unsigned int*) (void*) (sq + p->sq_off.array);
+  ring->cq_head = (unsigned int*) (void*) (cq + p->cq_off.head);
+  ring->cq_tail = (unsigned int*) (void*) (cq + p->cq_off.tail);
+  ring->cq_mask = (unsigned int*) (void*) (cq + p->cq_off.ring_mask);
+  ring->cqes = (struct io_uring_cqe*) (void*) (cq + p->cq_off.cqes);
+  return 0;
+}
+
+cpufreq_bindings_uring* cpufreq_bindings_uring_init(unsigned int entries) {
+  struct io_uring_params p;
+  cpufreq_bindings_uring* ring;
+  int err_save;
+  if ((ring = calloc(1, sizeof(cpufreq_bindings_uring))) == NULL) {
+    return NULL;
+  }
+  memset(&p, 0, sizeof(p));
+  if ((ring->fd = sys_io_uring_setup(entries, &p)) < 0) {
+    PERROR(DEBUG, "cpufreq_bindings_uring_init: io_uring_setup");
+    free(ring);
+    return NULL;
+  }
+  ring->entries = p.sq_entries;
+  if (probe_ops(ring->fd) || map_ring(ring, &p)) {
+    err_save = errno;
+    PERROR(DEBUG, "cpufreq_bindings_uring_init");
+    unmap_ring(ring);
+    close(ring->fd);
+    free(ring);
+    errno = err_save;
+    return NULL;
+  }
+  return ring;
+}
+
+void cpufreq_bindings_uring_destroy(cpufreq_bindings_uring* ring) {
+  unmap_ring(ring);
+  close(ring->fd);
+  free(ring);
+}
+
+unsigned int cpufreq_bindings_uring_get_entries(const cpufreq_bindings_uring* ring) {
+  return ring->entries;
+}
+
+static unsigned int reap(cpufreq_bindings_uring* ring, cpufreq_bindings_io* ios) {
+  struct io_uring_cqe* cqe;
+  unsigned int n = 0;
+  unsigned int head = *ring->cq_head;
+  unsigned int tail = __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE);
+  for (; head != tail; head++, n++) {
+    cqe = &ring->cqes[head & *ring->cq_mask];
+    ios[cqe->user_data].res = cqe->res;
+  }
+  __atomic_store_n(ring->cq_head, head, __ATOMIC_RELEASE);
+  return n;
+}
+
+int cpufreq_bindings_uring_submit(cpufreq_bindings_uring* ring, cpufreq_bindings_io* ios, unsigned int n) {
+  struct io_uring_sqe* sqe;
+  unsigned int tail_start = *ring->sq_tail;
+  unsigned int tail = tail_start;
+  unsigned int submitted = 0;
+  unsigned int completed = 0;
+  unsigned int idx;
+  unsigned int i;
+  int ret;
+  if (n > ring->entries) {
+    errno = EINVAL;
+    return -1;
+  }
+  for (i = 0; i < n; i++, tail++) {
+    idx = tail & *ring->sq_mask;
+    sqe = &ring->sqes[idx];
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = ios[i].write ? IORING_OP_WRITE : IORING_OP_READ;
+    sqe->fd = ios[i].fd;
+    sqe->addr = (uint64_t) (uintptr_t) ios[i].buf;
+    sqe->len = (uint32_t) ios[i].len;
+    sqe->off = 0;
+    sqe->user_data = i;
+    ring->sq_array[idx] = idx;
+  }
+  __atomic_store_n(ring->sq_tail, tail, __ATOMIC_RELEASE);
+  while (completed < n) {
+    // submit anything not yet consumed and wait for everything outstanding
+    ret = sys_io_uring_enter(ring->fd, n - submitted, n - completed, IORING_ENTER_GETEVENTS);
+    if (ret < 0) {
+      if (errno == EINTR || ((errno == EAGAIN || errno == EBUSY) && completed < submitted)) {
+        continue;
+      }
+      if (submitted == 0) {
+        // nothing was consumed by the kernel - rewind so the ring remains usable
+        __atomic_store_n(ring->sq_tail, tail_start, __ATOMIC_RELEASE);
+      }
+      PERROR(WARN, "cpufreq_bindings_uring_submit: io_uring_enter");
+      return -1;
+    }
+    submitted += (unsigned int) ret;
+    completed += reap(ring, ios);
+  }
+  return 0;
+}
@@ -0,0 +1,63 @@
+/**
+ * Minimal io_uring backend for submitting batches of reads/writes with a single system call.
+ * Only compiled when CPUFREQ_BINDINGS_IO_URING is defined.
+ *
+ * @author Connor Imes
+ * @date 2026-10-15
+ */
+#ifndef _CPUFREQ_BINDINGS_URING_H_
+#define _CPUFREQ_BINDINGS_URING_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <unistd.h>
+
+typedef struct cpufreq_bindings_io {
+  int fd;
+  int write;
+  char* buf;
+  size_t len;
+  // bytes read/written, or -errno on failure
+  ssize_t res;
+  // for the caller's use
+  size_t tag;
+} cpufreq_bindings_io;
+
+typedef struct cpufreq_bindings_uring cpufreq_bindings_uring;
+
+/**
+ * Create a ring, failing if the kernel doesn't support the required operations.
+ *
+ * @param entries
+ * @return the ring, or NULL on failure (errno will be set)
+ */
+cpufreq_bindings_uring* cpufreq_bindings_uring_init(unsigned int entries);
+
+void cpufreq_bindings_uring_destroy(cpufreq_bindings_uring* ring);
+
+/**
+ * Get the maximum number of operations that may be submitted at once.
+ */
+unsigned int cpufreq_bindings_uring_get_entries(const cpufreq_bindings_uring* ring);
+
+/**
+ * Submit operations and wait for all of them to complete.
+ * Not thread-safe - callers must serialize use of a ring.
+ *
+ * @param ring
+ * @param ios
+ * @param n
+ *  Must be <= cpufreq_bindings_uring_get_entries(ring)
+ * @return 0 on success (per-operation results are in ios[i].res), or -1 if the ring is unusable and the operations
+ *  were not completed (errno will be set)
+ */
+int cpufreq_bindings_uring_submit(cpufreq_bindings_uring* ring, cpufreq_bindings_io* ios, unsigned int n);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
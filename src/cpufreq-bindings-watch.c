@@ -0,0 +1,331 @@
+/**
+ * Change notification using sysfs_notify (POLLPRI) where available, and an adaptive poller otherwise.
+ *
+ * Notifiable files and a timerfd for the poller share an epoll set, whose file descriptor is exposed to callers.
+ *
+ * @author Connor Imes
+ * @date 2026-10-15
+ */
+// for pread
+#define _POSIX_C_SOURCE 200809L
+#include <errno.h>
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+#include "cpufreq-bindings.h"
+#include "cpufreq-bindings-common.h"
+#include "cpufreq-bindings-ctx.h"
+#include "cpufreq-bindings-instrument.h"
+#include "cpufreq-bindings-watch.h"
+
+// longer than any u32 or governor name
+#define WATCH_VALUE_LEN 64
+#define WATCH_MIN_INTERVAL_NS_DEFAULT 10000000ULL
+#define WATCH_MAX_INTERVAL_NS_DEFAULT 1000000000ULL
+#define WATCH_MAX_EVENTS 64
+
+typedef struct watch_entry {
+  uint32_t core;
+  cpufreq_bindings_file file;
+  int fd;
+  // 1 if the watch opened "fd" and must close it
+  int owned;
+  // 1 if "fd" is in the epoll set
+  int in_epoll;
+  // 1 once a notification has been seen, after which the file is no longer polled
+  int notified;
+  char val[WATCH_VALUE_LEN];
+} watch_entry;
+
+struct cpufreq_bindings_watch {
+  cpufreq_bindings_watch_cb cb;
+  void* arg;
+  int epfd;
+  int timerfd;
+  watch_entry** entries;
+  uint32_t nentries;
+  uint32_t capacity;
+  // entries that are not yet notified
+  uint32_t npolled;
+  uint64_t min_interval_ns;
+  uint64_t max_interval_ns;
+  uint64_t interval_ns;
+  int timer_armed;
+};
+
+// returns 0 or an errno value
+static int read_value(const watch_entry* e, char* buf) {
+  uint64_t start = STATS_START();
+  ssize_t ret = pread(e->fd, buf, WATCH_VALUE_LEN - 1, 0);
+  STATS_IO(e->file, 0, ret <= 0, start);
+  if (ret < 0) {
+    return errno;
+  }
+  buf[ret] = '\0';
+  buf[strcspn(buf, "\n")] = '\0';
+  return 0;
+}
+
+// returns 1 if the value changed, 0 otherwise
+static int check_entry(cpufreq_bindings_watch* watch, watch_entry* e) {
+  char buf[WATCH_VALUE_LEN];
+  if (read_value(e, buf)) {
+    // e.g., the core went offline - keep the last known value
+    return 0;
+  }
+  if (!strcmp(buf, e->val)) {
+    return 0;
+  }
+  memcpy(e->val, buf, sizeof(e->val));
+  watch->cb(e->core, e->file, e->val, watch->arg);
+  return 1;
+}
+
+static int arm_timer(cpufreq_bindings_watch* watch) {
+  struct itimerspec its;
+  memset(&its, 0, sizeof(its));
+  if (watch->npolled > 0) {
+    its.it_value.tv_sec = (time_t) (watch->interval_ns / 1000000000ULL);
+    its.it_value.tv_nsec = (long) (watch->interval_ns % 1000000000ULL);
+  } else if (!watch->timer_armed) {
+    return 0;
+  }
+  if (timerfd_settime(watch->timerfd, 0, &its, NULL)) {
+    PERROR(ERROR, "cpufreq_bindings_watch: timerfd_settime");
+    return -1;
+  }
+  watch->timer_armed = watch->npolled > 0;
+  return 0;
+}
+
+cpufreq_bindings_watch* cpufreq_bindings_watch_init(cpufreq_bindings_watch_cb cb, void* arg, uint64_t min_interval_ns,
+                                                    uint64_t max_interval_ns) {
+  struct epoll_event ev;
+  cpufreq_bindings_watch* watch;
+  int err_save;
+  if (cb == NULL) {
+    errno = EINVAL;
+    return NULL;
+  }
+  if ((watch = calloc(1, sizeof(cpufreq_bindings_watch))) == NULL) {
+    return NULL;
+  }
+  watch->cb = cb;
+  watch->arg = arg;
+  watch->min_interval_ns = min_interval_ns > 0 ? min_interval_ns : WATCH_MIN_INTERVAL_NS_DEFAULT;
+  watch->max_interval_ns = max_interval_ns > 0 ? max_interval_ns : WATCH_MAX_INTERVAL_NS_DEFAULT;
+  if (watch->max_interval_ns < watch->min_interval_ns) {
+    watch->max_interval_ns = watch->min_interval_ns;
+  }
+  watch->interval_ns = watch->min_interval_ns;
+  watch->timerfd = -1;
+  if ((watch->epfd = epoll_create1(EPOLL_CLOEXEC)) < 0 ||
+      (watch->timerfd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC)) < 0) {
+    goto fail;
+  }
+  memset(&ev, 0, sizeof(ev));
+  ev.events = EPOLLIN;
+  // NULL identifies the timer
+  ev.data.ptr = NULL;
+  if (epoll_ctl(watch->epfd, EPOLL_CTL_ADD, watch->timerfd, &ev)) {
+    goto fail;
+  }
+  return watch;
+
+fail:
+  err_save = errno;
+  PERROR(ERROR, "cpufreq_bindings_watch_init");
+  if (watch->timerfd >= 0) {
+    close(watch->timerfd);
+  }
+  if (watch->epfd >= 0) {
+    close(watch->epfd);
+  }
+  free(watch);
+  errno = err_save;
+  return NULL;
+}
+
+static void entry_free(watch_entry* e) {
+  if (e->owned) {
+    cpufreq_bindings_file_close(e->fd);
+  }
+  free(e);
+}
+
+int cpufreq_bindings_watch_destroy(cpufreq_bindings_watch* watch) {
+  uint32_t i;
+  for (i = 0; i < watch->nentries; i++) {
+    entry_free(watch->entries[i]);
+  }
+  close(watch->timerfd);
+  close(watch->epfd);
+  free(watch->entries);
+  free(watch);
+  return 0;
+}
+
+static watch_entry** find_entry(const cpufreq_bindings_watch* watch, uint32_t core, cpufreq_bindings_file file) {
+  uint32_t i;
+  for (i = 0; i < watch->nentries; i++) {
+    if (watch->entries[i]->core == core && watch->entries[i]->file == file) {
+      return &watch->entries[i];
+    }
+  }
+  return NULL;
+}
+
+static int watch_add(cpufreq_bindings_watch* watch, int fd, int owned, uint32_t core, cpufreq_bindings_file file) {
+  struct epoll_event ev;
+  watch_entry** entries;
+  watch_entry* e;
+  uint32_t capacity;
+  int err;
+  if (watch->nentries == watch->capacity) {
+    capacity = watch->capacity == 0 ? 16 : watch->capacity * 2;
+    if ((entries = realloc(watch->entries, capacity * sizeof(watch_entry*))) == NULL) {
+      return -1;
+    }
+    watch->entries = entries;
+    watch->capacity = capacity;
+  }
+  if ((e = calloc(1, sizeof(watch_entry))) == NULL) {
+    return -1;
+  }
+  e->core = core;
+  e->file = file;
+  e->fd = fd;
+  e->owned = owned;
+  // the initial read also arms sysfs notification for this file descriptor
+  if ((err = read_value(e, e->val))) {
+    free(e);
+    errno = err;
+    return -1;
+  }
+  memset(&ev, 0, sizeof(ev));
+  ev.events = EPOLLPRI;
+  ev.data.ptr = e;
+  // regular files (EPERM) and other file systems without poll support are only polled
+  e->in_epoll = !epoll_ctl(watch->epfd, EPOLL_CTL_ADD, fd, &ev);
+  watch->entries[watch->nentries++] = e;
+  watch->npolled++;
+  if (!watch->timer_armed) {
+    watch->interval_ns = watch->min_interval_ns;
+    arm_timer(watch);
+  }
+  return 0;
+}
+
+int cpufreq_bindings_watch_add(cpufreq_bindings_watch* watch, uint32_t core, cpufreq_bindings_file file) {
+  int err_save;
+  int fd;
+  if (find_entry(watch, core, file) != NULL) {
+    errno = EEXIST;
+    return -1;
+  }
+  if ((fd = cpufreq_bindings_file_open(core, file, -1)) < 0) {
+    return -1;
+  }
+  if (watch_add(watch, fd, 1, core, file)) {
+    err_save = errno;
+    cpufreq_bindings_file_close(fd);
+    errno = err_save;
+    return -1;
+  }
+  return 0;
+}
+
+int cpufreq_bindings_watch_add_fd(cpufreq_bindings_watch* watch, int fd, uint32_t core, cpufreq_bindings_file file) {
+  if (fd < 0 || (int) file < 0 || (int) file >= BINDINGS_FILE_COUNT) {
+    errno = EINVAL;
+    return -1;
+  }
+  if (find_entry(watch, core, file) != NULL) {
+    errno = EEXIST;
+    return -1;
+  }
+  return watch_add(watch, fd, 0, core, file);
+}
+
+int cpufreq_bindings_watch_remove(cpufreq_bindings_watch* watch, uint32_t core, cpufreq_bindings_file file) {
+  watch_entry** slot = find_entry(watch, core, file);
+  watch_entry* e;
+  if (slot == NULL) {
+    errno = ENOENT;
+    return -1;
+  }
+  e = *slot;
+  if (e->in_epoll) {
+    epoll_ctl(watch->epfd, EPOLL_CTL_DEL, e->fd, NULL);
+  }
+  if (!e->notified) {
+    watch->npolled--;
+  }
+  *slot = watch->entries[--watch->nentries];
+  entry_free(e);
+  return arm_timer(watch);
+}
+
+int cpufreq_bindings_watch_get_fd(const cpufreq_bindings_watch* watch) {
+  return watch->epfd;
+}
+
+uint32_t cpufreq_bindings_watch_get_npolled(const cpufreq_bindings_watch* watch) {
+  return watch->npolled;
+}
+
+// check every file that isn't notified, then adapt the interval
+static int poll_round(cpufreq_bindings_watch* watch) {
+  uint64_t expirations;
+  uint32_t i;
+  int changes = 0;
+  // drain the timer
+  if (read(watch->timerfd, &expirations, sizeof(expirations)) < 0 && errno != EAGAIN) {
+    PERROR(WARN, "cpufreq_bindings_watch_dispatch: read timerfd");
+  }
+  for (i = 0; i < watch->nentries; i++) {
+    if (!watch->entries[i]->notified) {
+      changes += check_entry(watch, watch->entries[i]);
+    }
+  }
+  if (changes > 0) {
+    watch->interval_ns = watch->min_interval_ns;
+  } else if (watch->interval_ns < watch->max_interval_ns) {
+    watch->interval_ns = watch->interval_ns * 2 > watch->max_interval_ns ? watch->max_interval_ns :
+                         watch->interval_ns * 2;
+  }
+  watch->timer_armed = 0;
+  arm_timer(watch);
+  return changes;
+}
+
+int cpufreq_bindings_watch_dispatch(cpufreq_bindings_watch* watch, int timeout_ms) {
+  struct epoll_event events[WATCH_MAX_EVENTS];
+  watch_entry* e;
+  int changes = 0;
+  int timer = 0;
+  int n;
+  int i;
+  if ((n = epoll_wait(watch->epfd, events, WATCH_MAX_EVENTS, timeout_ms)) < 0) {
+    return -1;
+  }
+  for (i = 0; i < n; i++) {
+    if ((e = events[i].data.ptr) == NULL) {
+      timer = 1;
+      continue;
+    }
+    if (!e->notified) {
+      // the kernel notifies for this file, so stop polling it
+      e->notified = 1;
+      watch->npolled--;
+    }
+    changes += check_entry(watch, e);
+  }
+  if (timer) {
+    changes += poll_round(watch);
+  }
+  return changes;
+}
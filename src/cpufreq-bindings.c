@@ -4,19 +4,23 @@
  * @author Connor Imes
  * @date 2017-03-16
  */
-// for pread, pwrite, strtok_r
+// for pread, pwrite, vsnprintf
 #define _POSIX_C_SOURCE 200809L
 #include <errno.h>
 #include <inttypes.h>
 #include <fcntl.h>
+#include <stdarg.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
 #include "cpufreq-bindings.h"
 #include "cpufreq-bindings-common.h"
+#include "cpufreq-bindings-ctx.h"
+#include "cpufreq-bindings-instrument.h"
+#include "cpufreq-bindings-parse.h"
 
-static const char* BINDINGS_FILE[CPUFREQ_BINDINGS_FILE_SCALING_SETSPEED + 1] = {
+static const char* BINDINGS_FILE[] = {
   "affected_cpus",
   "bios_limit",
   "cpuinfo_cur_freq",
@@ -31,47 +35,123 @@ static const char* BINDINGS_FILE[CPUFREQ_BINDINGS_FILE_SCALING_SETSPEED + 1] = {
   "scaling_governor",
   "scaling_max_freq",
   "scaling_min_freq",
-  "scaling_setspeed"
+  "scaling_setspeed",
+  "stats/time_in_state",
+  "stats/total_trans",
+  "stats/trans_table",
+  "base_frequency",
+  "energy_performance_available_preferences",
+  "energy_performance_preference",
+  // global files, relative to "/devices/system/cpu"
+  "cpufreq/boost",
+  "intel_pstate/max_perf_pct",
+  "intel_pstate/min_perf_pct",
+  "intel_pstate/no_turbo"
 };
 
-#define U32_MAX_LEN 12
+#define SYSFS_ROOT_DEFAULT "/sys"
 
-// (hopefully) conservative length estimate without being absurd
-#define GOVERNOR_NAME_MAX_LEN 128
+static char sysfs_root[SYSFS_ROOT_MAX_LEN] = SYSFS_ROOT_DEFAULT;
+
+int cpufreq_bindings_set_sysfs_root(const char* root) {
+  size_t len;
+  if (root == NULL) {
+    root = SYSFS_ROOT_DEFAULT;
+  }
+  len = strlen(root);
+  // paths are built as root + "/devices/...", so drop trailing slashes
+  while (len > 0 && root[len - 1] == '/') {
+    len--;
+  }
+  if (len >= sizeof(sysfs_root)) {
+    errno = ENAMETOOLONG;
+    return -1;
+  }
+  memcpy(sysfs_root, root, len);
+  sysfs_root[len] = '\0';
+  return 0;
+}
+
+const char* cpufreq_bindings_get_sysfs_root(void) {
+  return sysfs_root[0] == '\0' ? "/" : sysfs_root;
+}
+
+int cpufreq_bindings_sysfs_path(char* buf, size_t len, const char* fmt, ...) {
+  va_list ap;
+  size_t root_len = strlen(sysfs_root);
+  int n;
+  if (root_len >= len) {
+    errno = ENAMETOOLONG;
+    return -1;
+  }
+  memcpy(buf, sysfs_root, root_len);
+  va_start(ap, fmt);
+  n = vsnprintf(&buf[root_len], len - root_len, fmt, ap);
+  va_end(ap);
+  if (n < 0 || (size_t) n >= len - root_len) {
+    errno = ENAMETOOLONG;
+    return -1;
+  }
+  return 0;
+}
+
+static int is_global_file(cpufreq_bindings_file file) {
+  return file >= CPUFREQ_BINDINGS_FILE_BOOST;
+}
+
+static int cpufreq_bindings_file_path(char* buf, size_t len, cpufreq_bindings_file file, uint32_t core) {
+  if (is_global_file(file) ?
+      cpufreq_bindings_sysfs_path(buf, len, "/devices/system/cpu/%s", BINDINGS_FILE[file]) :
+      cpufreq_bindings_sysfs_path(buf, len, "/devices/system/cpu/cpu%"PRIu32"/cpufreq/%s", core, BINDINGS_FILE[file])) {
+    PERROR(ERROR, "cpufreq_bindings_file_path");
+    return -1;
+  }
+  return 0;
+}
 
 static int cpufreq_bindings_open_file(cpufreq_bindings_file file, uint32_t core, int flags) {
-  char buf[128];
+  char buf[SYSFS_PATH_MAX_LEN];
   int fd;
-  snprintf(buf, sizeof(buf), "/sys/devices/system/cpu/cpu%"PRIu32"/cpufreq/%s", core, BINDINGS_FILE[file]);
+  if (cpufreq_bindings_file_path(buf, sizeof(buf), file, core)) {
+    return -1;
+  }
   fd = open(buf, flags);
+  STATS_COUNT(COUNTER_OPEN);
   if (fd < 0) {
-    PERROR(ERROR, buf);
+    PERROR_AT(ERROR, core, file, buf);
   }
   return fd;
 }
 
 static void conditional_close(int cond, int fd) {
   int err_save = errno;
-  if (cond && close(fd)) {
-    PERROR(WARN, "conditional_close: close");
+  if (cond) {
+    STATS_COUNT(COUNTER_CLOSE);
+    if (close(fd)) {
+      PERROR(WARN, "conditional_close: close");
+    }
   }
   errno = err_save;
 }
 
 static ssize_t read_file_by_fd_or_name(int fd, uint32_t core, char* buf, size_t len, cpufreq_bindings_file file, int trim) {
+  uint64_t start;
   ssize_t ret;
   int local_fd = fd <= 0;
   if (local_fd) {
+    STATS_COUNT(COUNTER_OPEN_PER_CALL);
     if ((fd = cpufreq_bindings_open_file(file, core, O_RDONLY)) <= 0) {
       return -1;
     }
   }
+  start = STATS_START();
   ret = pread(fd, buf, len, 0);
+  STATS_IO(file, 0, ret <= 0, start);
   if (ret <= 0) {
     if (ret == 0) {
       errno = ENODATA;
     }
-    PERROR(ERROR, "read_file_by_fd_or_name: pread");
+    PERROR_AT(ERROR, core, file, "read_file_by_fd_or_name: pread");
   } else if (trim) {
     // strip newline character
     buf[strcspn(buf, "\n")] = '\0';
@@ -81,48 +161,82 @@ static ssize_t read_file_by_fd_or_name(int fd, uint32_t core, char* buf, size_t
 }
 
 static ssize_t write_file_by_fd_or_name(int fd, uint32_t core, const char* buf, size_t len, cpufreq_bindings_file file) {
+  uint64_t start;
   ssize_t ret;
   int local_fd = fd <= 0;
   if (local_fd) {
+    STATS_COUNT(COUNTER_OPEN_PER_CALL);
     if ((fd = cpufreq_bindings_open_file(file, core, O_RDWR)) <= 0) {
       return -1;
     }
   }
-  if ((ret = pwrite(fd, buf, len, 0)) < 0) {
-    PERROR(ERROR, "write_file_by_fd_or_name: pwrite");
+  start = STATS_START();
+  ret = pwrite(fd, buf, len, 0);
+  STATS_IO(file, 1, ret < 0, start);
+  if (ret < 0) {
+    PERROR_AT(ERROR, core, file, "write_file_by_fd_or_name: pwrite");
   }
   conditional_close(local_fd, fd);
   return ret;
 }
 
-static uint32_t read_file_u32arr(int fd, uint32_t core, uint32_t* arr, uint32_t len, cpufreq_bindings_file file) {
-  char* tok;
-  char* ptr = NULL;
-  uint32_t i = 0;
-  // support string values for every core + a whitespace char + a terminating NULL char
-  size_t buflen = len * (U32_MAX_LEN + 1) + 1;
-  char* buf = calloc(1, buflen);
-  if (buf != NULL && read_file_by_fd_or_name(fd, core, buf, buflen, file, 0) > 0) {
-    // tokenize and write to the array
-    tok = strtok_r(buf, " ", &ptr);
-    for (; tok != NULL && i < len; tok = strtok_r(NULL, " ", &ptr), i++) {
-      errno = 0;
-      arr[i] = strtoul(tok, NULL, 0);
-      if (errno) {
-        PERROR(ERROR, "read_file_u32arr: strtoul");
-        i = 0;
-        tok = NULL;
-        break;
-      }
+// read a file in chunks and parse each with either a u32 or string array parser - usually a single read
+static int read_file_parse(int fd, uint32_t core, cpufreq_bindings_file file, cpufreq_bindings_u32arr_parser* u32p,
+                           cpufreq_bindings_strarr_parser* strp) {
+  char buf[PARSE_CHUNK_LEN];
+  off_t off = 0;
+  uint64_t start;
+  ssize_t ret;
+  int local_fd = fd <= 0;
+  if (local_fd) {
+    STATS_COUNT(COUNTER_OPEN_PER_CALL);
+    if ((fd = cpufreq_bindings_open_file(file, core, O_RDONLY)) <= 0) {
+      return -1;
     }
-    if (tok != NULL) {
-      // the array wasn't big enough
-      i = 0;
-      errno = ERANGE;
+  }
+  // parse errors are retained by the parser
+  start = STATS_START();
+  while ((ret = pread(fd, buf, sizeof(buf), off)) > 0) {
+    STATS_IO(file, 0, 0, start);
+    off += ret;
+    if (u32p != NULL ? cpufreq_bindings_u32arr_parse(u32p, buf, (size_t) ret) :
+                       cpufreq_bindings_strarr_parse(strp, buf, (size_t) ret)) {
+      break;
+    }
+    if ((size_t) ret < sizeof(buf)) {
+      // sysfs returns a whole attribute in one read, so a short read reached the end - don't spend a read to confirm
+      break;
     }
+    start = STATS_START();
   }
-  free(buf);
-  return i;
+  if (ret <= 0) {
+    // the final read, which reached the end of the file or failed
+    STATS_IO(file, 0, ret < 0, start);
+  }
+  if (ret == 0 && off == 0) {
+    errno = ENODATA;
+    ret = -1;
+  }
+  if (ret < 0) {
+    PERROR_AT(ERROR, core, file, "read_file_parse: pread");
+  }
+  conditional_close(local_fd, fd);
+  return ret < 0 ? -1 : 0;
+}
+
+static uint32_t read_file_u32arr(int fd, uint32_t core, uint32_t* arr, uint32_t len, cpufreq_bindings_file file) {
+  cpufreq_bindings_u32arr_parser p;
+  uint32_t n;
+  cpufreq_bindings_u32arr_parser_init(&p, arr, len);
+  if (read_file_parse(fd, core, file, &p, NULL)) {
+    return 0;
+  }
+  n = cpufreq_bindings_u32arr_parser_finish(&p);
+  // ERANGE can also mean that "arr" is too short, which is not the file's fault
+  if (p.err == EINVAL) {
+    STATS_COUNT(COUNTER_PARSE_ERROR);
+  }
+  return n;
 }
 
 static uint32_t read_file_u32(int fd, uint32_t core, cpufreq_bindings_file file) {
@@ -132,7 +246,8 @@ static uint32_t read_file_u32(int fd, uint32_t core, cpufreq_bindings_file file)
     errno = 0;
     ret = strtoul(buf, NULL, 0);
     if (errno) {
-      PERROR(ERROR, "read_file_u32: strtoul");
+      STATS_COUNT(COUNTER_PARSE_ERROR);
+      PERROR_AT(ERROR, core, file, "read_file_u32: strtoul");
     }
   }
   return ret;
@@ -140,8 +255,22 @@ static uint32_t read_file_u32(int fd, uint32_t core, cpufreq_bindings_file file)
 
 static ssize_t write_file_u32(int fd, uint32_t core, uint32_t val, cpufreq_bindings_file file) {
   char buf[U32_MAX_LEN];
-  snprintf(buf, sizeof(buf), "%"PRIu32, val);
-  return write_file_by_fd_or_name(fd, core, buf, sizeof(buf), file);
+  uint64_t trace_ns = TRACE_START();
+  int len = snprintf(buf, sizeof(buf), "%"PRIu32, val);
+  ssize_t ret = write_file_by_fd_or_name(fd, core, buf, (size_t) len, file);
+  if (ret >= 0) {
+    TRACE_U32(trace_ns, core, file, val);
+  }
+  return ret;
+}
+
+static ssize_t write_file_str(int fd, uint32_t core, const char* buf, size_t len, cpufreq_bindings_file file) {
+  uint64_t trace_ns = TRACE_START();
+  ssize_t ret = write_file_by_fd_or_name(fd, core, buf, len, file);
+  if (ret >= 0) {
+    TRACE_STR(trace_ns, core, file, buf, len);
+  }
+  return ret;
 }
 
 static int cpufreq_bindings_file_to_flags(cpufreq_bindings_file file) {
@@ -150,6 +279,11 @@ static int cpufreq_bindings_file_to_flags(cpufreq_bindings_file file) {
     case CPUFREQ_BINDINGS_FILE_SCALING_MAX_FREQ:
     case CPUFREQ_BINDINGS_FILE_SCALING_MIN_FREQ:
     case CPUFREQ_BINDINGS_FILE_SCALING_SETSPEED:
+    case CPUFREQ_BINDINGS_FILE_ENERGY_PERFORMANCE_PREFERENCE:
+    case CPUFREQ_BINDINGS_FILE_BOOST:
+    case CPUFREQ_BINDINGS_FILE_INTEL_PSTATE_MAX_PERF_PCT:
+    case CPUFREQ_BINDINGS_FILE_INTEL_PSTATE_MIN_PERF_PCT:
+    case CPUFREQ_BINDINGS_FILE_INTEL_PSTATE_NO_TURBO:
       return O_RDWR;
     default:
       break;
@@ -158,7 +292,7 @@ static int cpufreq_bindings_file_to_flags(cpufreq_bindings_file file) {
 }
 
 int cpufreq_bindings_file_open(uint32_t core, cpufreq_bindings_file file, int flags) {
-  if ((int) file < 0 || (int) file > CPUFREQ_BINDINGS_FILE_SCALING_SETSPEED) {
+  if ((int) file < 0 || (int) file >= BINDINGS_FILE_COUNT) {
     errno = EINVAL;
     return -1;
   }
@@ -168,7 +302,32 @@ int cpufreq_bindings_file_open(uint32_t core, cpufreq_bindings_file file, int fl
   return cpufreq_bindings_open_file(file, core, flags);
 }
 
+int cpufreq_bindings_policy_file_open(uint32_t policy, cpufreq_bindings_file file, int flags) {
+  char buf[SYSFS_PATH_MAX_LEN];
+  int fd;
+  if ((int) file < 0 || (int) file >= BINDINGS_FILE_COUNT) {
+    errno = EINVAL;
+    return -1;
+  }
+  if (flags < 0) {
+    flags = cpufreq_bindings_file_to_flags(file);
+  }
+  if (is_global_file(file) ? cpufreq_bindings_file_path(buf, sizeof(buf), file, 0) :
+      cpufreq_bindings_sysfs_path(buf, sizeof(buf), "/devices/system/cpu/cpufreq/policy%"PRIu32"/%s", policy,
+                                  BINDINGS_FILE[file])) {
+    PERROR(ERROR, "cpufreq_bindings_policy_file_open");
+    return -1;
+  }
+  fd = open(buf, flags);
+  STATS_COUNT(COUNTER_OPEN);
+  if (fd < 0) {
+    PERROR_AT(ERROR, LOG_NO_CORE, file, buf);
+  }
+  return fd;
+}
+
 int cpufreq_bindings_file_close(int fd) {
+  STATS_COUNT(COUNTER_CLOSE);
   return close(fd);
 }
 
@@ -205,25 +364,12 @@ uint32_t cpufreq_bindings_get_scaling_available_frequencies(int fd, uint32_t cor
 }
 
 uint32_t cpufreq_bindings_get_scaling_available_governors(int fd, uint32_t core, char* governors, size_t len, size_t width) {
-  char* ptr;
-  char* tok;
-  uint32_t i = 0;
-  // support string values for every governor + a whitespace char + a terminating NULL char
-  size_t buflen = len * (GOVERNOR_NAME_MAX_LEN + 1) + 1;
-  char* buf = calloc(1, buflen);
-  if (buf != NULL && read_file_by_fd_or_name(fd, core, buf, buflen, CPUFREQ_BINDINGS_FILE_SCALING_AVAILABLE_GOVERNORS, 1) > 0) {
-    tok = strtok_r(buf, " ", &ptr);
-    for (; tok != NULL && i < len; tok = strtok_r(NULL, " ", &ptr), i++) {
-      strncpy(&governors[i * width], tok, width);
-    }
-    if (tok != NULL) {
-      // the array wasn't big enough
-      i = 0;
-      errno = ERANGE;
-    }
+  cpufreq_bindings_strarr_parser p;
+  cpufreq_bindings_strarr_parser_init(&p, governors, len, width);
+  if (read_file_parse(fd, core, CPUFREQ_BINDINGS_FILE_SCALING_AVAILABLE_GOVERNORS, NULL, &p)) {
+    return 0;
   }
-  free(buf);
-  return i;
+  return cpufreq_bindings_strarr_parser_finish(&p);
 }
 
 uint32_t cpufreq_bindings_get_scaling_cur_freq(int fd, uint32_t core) {
@@ -239,7 +385,7 @@ ssize_t cpufreq_bindings_get_scaling_governor(int fd, uint32_t core, char* gover
 }
 
 ssize_t cpufreq_bindings_set_scaling_governor(int fd, uint32_t core, const char* governor, size_t len) {
-  return write_file_by_fd_or_name(fd, core, governor, len, CPUFREQ_BINDINGS_FILE_SCALING_GOVERNOR);
+  return write_file_str(fd, core, governor, len, CPUFREQ_BINDINGS_FILE_SCALING_GOVERNOR);
 }
 
 uint32_t cpufreq_bindings_get_scaling_max_freq(int fd, uint32_t core) {
@@ -261,3 +407,816 @@ ssize_t cpufreq_bindings_set_scaling_min_freq(int fd, uint32_t core, uint32_t fr
 ssize_t cpufreq_bindings_set_scaling_setspeed(int fd, uint32_t core, uint32_t freq) {
   return write_file_u32(fd, core, freq, CPUFREQ_BINDINGS_FILE_SCALING_SETSPEED);
 }
+
+// read a file that must be parsed whole with a single pread - "buf" is NULL-terminated
+static ssize_t read_file_whole(int fd, uint32_t core, char* buf, size_t len, cpufreq_bindings_file file) {
+  ssize_t ret = read_file_by_fd_or_name(fd, core, buf, len - 1, file, 0);
+  if (ret == (ssize_t) (len - 1)) {
+    // the file may be longer
+    errno = EFBIG;
+    PERROR_AT(ERROR, core, file, "read_file_whole");
+    return -1;
+  }
+  if (ret > 0) {
+    buf[ret] = '\0';
+  }
+  return ret;
+}
+
+static uint32_t stats_table_result(int err, uint32_t n) {
+  // ERANGE can also mean that the arrays are too short, which is not the file's fault
+  if (err == EINVAL) {
+    STATS_COUNT(COUNTER_PARSE_ERROR);
+  } else if (!err && n == 0) {
+    err = ENODATA;
+  }
+  if (err) {
+    errno = err;
+    return 0;
+  }
+  return n;
+}
+
+uint32_t cpufreq_bindings_get_stats_time_in_state(int fd, uint32_t core, uint32_t* freqs, uint64_t* times,
+                                                  uint32_t len) {
+  char buf[PARSE_CHUNK_LEN + 1];
+  uint32_t n;
+  int err;
+  ssize_t ret = read_file_whole(fd, core, buf, sizeof(buf), CPUFREQ_BINDINGS_FILE_STATS_TIME_IN_STATE);
+  if (ret <= 0) {
+    return 0;
+  }
+  err = cpufreq_bindings_parse_time_in_state(buf, (size_t) ret, freqs, times, len, &n);
+  return stats_table_result(err, n);
+}
+
+uint32_t cpufreq_bindings_get_stats_total_trans(int fd, uint32_t core) {
+  return read_file_u32(fd, core, CPUFREQ_BINDINGS_FILE_STATS_TOTAL_TRANS);
+}
+
+uint32_t cpufreq_bindings_get_stats_trans_table(int fd, uint32_t core, uint32_t* freqs, uint32_t* counts,
+                                                uint32_t len) {
+  char buf[PARSE_CHUNK_LEN + 1];
+  uint32_t n;
+  int err;
+  ssize_t ret = read_file_whole(fd, core, buf, sizeof(buf), CPUFREQ_BINDINGS_FILE_STATS_TRANS_TABLE);
+  if (ret <= 0) {
+    return 0;
+  }
+  err = cpufreq_bindings_parse_trans_table(buf, (size_t) ret, freqs, counts, len, &n);
+  return stats_table_result(err, n);
+}
+
+uint32_t cpufreq_bindings_get_base_frequency(int fd, uint32_t core) {
+  return read_file_u32(fd, core, CPUFREQ_BINDINGS_FILE_BASE_FREQUENCY);
+}
+
+uint32_t cpufreq_bindings_get_energy_performance_available_preferences(int fd, uint32_t core, char* prefs, size_t len,
+                                                                       size_t width) {
+  cpufreq_bindings_strarr_parser p;
+  cpufreq_bindings_strarr_parser_init(&p, prefs, len, width);
+  if (read_file_parse(fd, core, CPUFREQ_BINDINGS_FILE_ENERGY_PERFORMANCE_AVAILABLE_PREFERENCES, NULL, &p)) {
+    return 0;
+  }
+  return cpufreq_bindings_strarr_parser_finish(&p);
+}
+
+ssize_t cpufreq_bindings_get_energy_performance_preference(int fd, uint32_t core, char* pref, size_t len) {
+  return read_file_by_fd_or_name(fd, core, pref, len, CPUFREQ_BINDINGS_FILE_ENERGY_PERFORMANCE_PREFERENCE, 1);
+}
+
+ssize_t cpufreq_bindings_set_energy_performance_preference(int fd, uint32_t core, const char* pref, size_t len) {
+  return write_file_str(fd, core, pref, len, CPUFREQ_BINDINGS_FILE_ENERGY_PERFORMANCE_PREFERENCE);
+}
+
+uint32_t cpufreq_bindings_get_boost(int fd) {
+  return read_file_u32(fd, 0, CPUFREQ_BINDINGS_FILE_BOOST);
+}
+
+ssize_t cpufreq_bindings_set_boost(int fd, uint32_t enable) {
+  return write_file_u32(fd, 0, enable, CPUFREQ_BINDINGS_FILE_BOOST);
+}
+
+uint32_t cpufreq_bindings_get_intel_pstate_max_perf_pct(int fd) {
+  return read_file_u32(fd, 0, CPUFREQ_BINDINGS_FILE_INTEL_PSTATE_MAX_PERF_PCT);
+}
+
+ssize_t cpufreq_bindings_set_intel_pstate_max_perf_pct(int fd, uint32_t pct) {
+  return write_file_u32(fd, 0, pct, CPUFREQ_BINDINGS_FILE_INTEL_PSTATE_MAX_PERF_PCT);
+}
+
+uint32_t cpufreq_bindings_get_intel_pstate_min_perf_pct(int fd) {
+  return read_file_u32(fd, 0, CPUFREQ_BINDINGS_FILE_INTEL_PSTATE_MIN_PERF_PCT);
+}
+
+ssize_t cpufreq_bindings_set_intel_pstate_min_perf_pct(int fd, uint32_t pct) {
+  return write_file_u32(fd, 0, pct, CPUFREQ_BINDINGS_FILE_INTEL_PSTATE_MIN_PERF_PCT);
+}
+
+uint32_t cpufreq_bindings_get_intel_pstate_no_turbo(int fd) {
+  return read_file_u32(fd, 0, CPUFREQ_BINDINGS_FILE_INTEL_PSTATE_NO_TURBO);
+}
+
+ssize_t cpufreq_bindings_set_intel_pstate_no_turbo(int fd, uint32_t disable) {
+  return write_file_u32(fd, 0, disable, CPUFREQ_BINDINGS_FILE_INTEL_PSTATE_NO_TURBO);
+}
+
+/*
+ * Context API
+ */
+
+cpufreq_bindings_ctx* cpufreq_bindings_ctx_init(uint32_t ncores) {
+  cpufreq_bindings_ctx* ctx;
+  if (ncores == 0) {
+    errno = EINVAL;
+    return NULL;
+  }
+  if ((ctx = calloc(1, sizeof(cpufreq_bindings_ctx))) == NULL) {
+    return NULL;
+  }
+  if ((ctx->fds = calloc((size_t) ncores * BINDINGS_FILE_COUNT, sizeof(int))) == NULL) {
+    free(ctx);
+    return NULL;
+  }
+  pthread_mutex_init(&ctx->policy_lock, NULL);
+  ctx->ncores = ncores;
+  return ctx;
+}
+
+int cpufreq_bindings_ctx_destroy(cpufreq_bindings_ctx* ctx) {
+  int ret = 0;
+  int err_save = 0;
+  size_t i;
+  for (i = 0; i < (size_t) ctx->ncores * BINDINGS_FILE_COUNT; i++) {
+    if (ctx->fds[i] <= 0) {
+      continue;
+    }
+    STATS_COUNT(COUNTER_CLOSE);
+    if (close(ctx->fds[i])) {
+      err_save = errno;
+      PERROR(WARN, "cpufreq_bindings_ctx_destroy: close");
+      ret = -1;
+    }
+  }
+  cpufreq_bindings_ctx_policies_free(ctx);
+  if (ctx->coalesce != NULL) {
+    cpufreq_bindings_coalesce_free(ctx->coalesce);
+  }
+  if (ctx->attr_cache != NULL) {
+    cpufreq_bindings_attr_cache_free(ctx->attr_cache);
+  }
+#ifdef CPUFREQ_BINDINGS_IO_URING
+  if (ctx->ring != NULL) {
+    cpufreq_bindings_uring_destroy(ctx->ring);
+  }
+  free(ctx->ios);
+  free(ctx->io_bufs);
+#endif
+  free(ctx->fds);
+  pthread_mutex_destroy(&ctx->policy_lock);
+  free(ctx);
+  if (ret) {
+    errno = err_save;
+  }
+  return ret;
+}
+
+uint32_t cpufreq_bindings_ctx_get_ncores(const cpufreq_bindings_ctx* ctx) {
+  return ctx->ncores;
+}
+
+static int ctx_open_file(cpufreq_bindings_file file, uint32_t core) {
+  char buf[SYSFS_PATH_MAX_LEN];
+  int fd;
+  if (cpufreq_bindings_file_to_flags(file) == O_RDWR) {
+    if (cpufreq_bindings_file_path(buf, sizeof(buf), file, core)) {
+      return -1;
+    }
+    fd = open(buf, O_RDWR);
+    STATS_COUNT(COUNTER_OPEN);
+    if (fd >= 0) {
+      return fd;
+    }
+    if (errno != EACCES && errno != EPERM && errno != EROFS) {
+      PERROR_AT(ERROR, core, file, buf);
+      return -1;
+    }
+    // don't require privileges just to read writable files
+  }
+  return cpufreq_bindings_open_file(file, core, O_RDONLY);
+}
+
+int cpufreq_bindings_ctx_get_fd(cpufreq_bindings_ctx* ctx, uint32_t core, cpufreq_bindings_file file) {
+  int* slot;
+  int fd;
+  int expected = 0;
+  if (core >= ctx->ncores || (int) file < 0 || (int) file >= BINDINGS_FILE_COUNT) {
+    errno = EINVAL;
+    return -1;
+  }
+  if (is_global_file(file)) {
+    // shared by all cores
+    core = 0;
+  }
+  slot = &ctx->fds[(size_t) core * BINDINGS_FILE_COUNT + file];
+  if ((fd = __atomic_load_n(slot, __ATOMIC_ACQUIRE)) > 0) {
+    return fd;
+  }
+  if ((fd = ctx_open_file(file, core)) <= 0) {
+    return -1;
+  }
+  if (!__atomic_compare_exchange_n(slot, &expected, fd, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+    // another thread won the race
+    conditional_close(1, fd);
+    fd = expected;
+  }
+  return fd;
+}
+
+uint32_t cpufreq_bindings_ctx_get_affected_cpus(cpufreq_bindings_ctx* ctx, uint32_t core, uint32_t* affected,
+                                                uint32_t len) {
+  int fd = cpufreq_bindings_ctx_get_fd(ctx, core, CPUFREQ_BINDINGS_FILE_AFFECTED_CPUS);
+  return fd < 0 ? 0 : cpufreq_bindings_get_affected_cpus(fd, core, affected, len);
+}
+
+uint32_t cpufreq_bindings_ctx_get_bios_limit(cpufreq_bindings_ctx* ctx, uint32_t core) {
+  int fd = cpufreq_bindings_ctx_get_fd(ctx, core, CPUFREQ_BINDINGS_FILE_BIOS_LIMIT);
+  return fd < 0 ? 0 : cpufreq_bindings_get_bios_limit(fd, core);
+}
+
+uint32_t cpufreq_bindings_ctx_get_cpuinfo_cur_freq(cpufreq_bindings_ctx* ctx, uint32_t core) {
+  int fd = cpufreq_bindings_ctx_get_fd(ctx, core, CPUFREQ_BINDINGS_FILE_CPUINFO_CUR_FREQ);
+  return fd < 0 ? 0 : cpufreq_bindings_get_cpuinfo_cur_freq(fd, core);
+}
+
+uint32_t cpufreq_bindings_ctx_get_cpuinfo_max_freq(cpufreq_bindings_ctx* ctx, uint32_t core) {
+  int fd;
+  if (ctx->attr_cache != NULL) {
+    return cpufreq_bindings_attr_cache_get_u32(ctx, core, CPUFREQ_BINDINGS_FILE_CPUINFO_MAX_FREQ);
+  }
+  fd = cpufreq_bindings_ctx_get_fd(ctx, core, CPUFREQ_BINDINGS_FILE_CPUINFO_MAX_FREQ);
+  return fd < 0 ? 0 : cpufreq_bindings_get_cpuinfo_max_freq(fd, core);
+}
+
+uint32_t cpufreq_bindings_ctx_get_cpuinfo_min_freq(cpufreq_bindings_ctx* ctx, uint32_t core) {
+  int fd;
+  if (ctx->attr_cache != NULL) {
+    return cpufreq_bindings_attr_cache_get_u32(ctx, core, CPUFREQ_BINDINGS_FILE_CPUINFO_MIN_FREQ);
+  }
+  fd = cpufreq_bindings_ctx_get_fd(ctx, core, CPUFREQ_BINDINGS_FILE_CPUINFO_MIN_FREQ);
+  return fd < 0 ? 0 : cpufreq_bindings_get_cpuinfo_min_freq(fd, core);
+}
+
+uint32_t cpufreq_bindings_ctx_get_cpuinfo_transition_latency(cpufreq_bindings_ctx* ctx, uint32_t core) {
+  int fd;
+  if (ctx->attr_cache != NULL) {
+    return cpufreq_bindings_attr_cache_get_u32(ctx, core, CPUFREQ_BINDINGS_FILE_CPUINFO_TRANSITION_LATENCY);
+  }
+  fd = cpufreq_bindings_ctx_get_fd(ctx, core, CPUFREQ_BINDINGS_FILE_CPUINFO_TRANSITION_LATENCY);
+  return fd < 0 ? 0 : cpufreq_bindings_get_cpuinfo_transition_latency(fd, core);
+}
+
+uint32_t cpufreq_bindings_ctx_get_related_cpus(cpufreq_bindings_ctx* ctx, uint32_t core, uint32_t* related,
+                                               uint32_t len) {
+  int fd;
+  if (ctx->attr_cache != NULL) {
+    return cpufreq_bindings_attr_cache_get_u32arr(ctx, core, CPUFREQ_BINDINGS_FILE_RELATED_CPUS, related, len);
+  }
+  fd = cpufreq_bindings_ctx_get_fd(ctx, core, CPUFREQ_BINDINGS_FILE_RELATED_CPUS);
+  return fd < 0 ? 0 : cpufreq_bindings_get_related_cpus(fd, core, related, len);
+}
+
+uint32_t cpufreq_bindings_ctx_get_scaling_available_frequencies(cpufreq_bindings_ctx* ctx, uint32_t core,
+                                                                uint32_t* freqs, uint32_t len) {
+  int fd;
+  if (ctx->attr_cache != NULL) {
+    return cpufreq_bindings_attr_cache_get_u32arr(ctx, core, CPUFREQ_BINDINGS_FILE_SCALING_AVAILABLE_FREQUENCIES,
+                                                  freqs, len);
+  }
+  fd = cpufreq_bindings_ctx_get_fd(ctx, core, CPUFREQ_BINDINGS_FILE_SCALING_AVAILABLE_FREQUENCIES);
+  return fd < 0 ? 0 : cpufreq_bindings_get_scaling_available_frequencies(fd, core, freqs, len);
+}
+
+uint32_t cpufreq_bindings_ctx_get_scaling_available_governors(cpufreq_bindings_ctx* ctx, uint32_t core,
+                                                              char* governors, size_t len, size_t width) {
+  int fd;
+  if (ctx->attr_cache != NULL) {
+    return cpufreq_bindings_attr_cache_get_governors(ctx, core, governors, len, width);
+  }
+  fd = cpufreq_bindings_ctx_get_fd(ctx, core, CPUFREQ_BINDINGS_FILE_SCALING_AVAILABLE_GOVERNORS);
+  return fd < 0 ? 0 : cpufreq_bindings_get_scaling_available_governors(fd, core, governors, len, width);
+}
+
+uint32_t cpufreq_bindings_ctx_get_scaling_cur_freq(cpufreq_bindings_ctx* ctx, uint32_t core) {
+  int fd = cpufreq_bindings_ctx_get_fd(ctx, core, CPUFREQ_BINDINGS_FILE_SCALING_CUR_FREQ);
+  return fd < 0 ? 0 : cpufreq_bindings_get_scaling_cur_freq(fd, core);
+}
+
+ssize_t cpufreq_bindings_ctx_get_scaling_driver(cpufreq_bindings_ctx* ctx, uint32_t core, char* driver, size_t len) {
+  int fd;
+  if (ctx->attr_cache != NULL) {
+    return cpufreq_bindings_attr_cache_get_driver(ctx, core, driver, len);
+  }
+  fd = cpufreq_bindings_ctx_get_fd(ctx, core, CPUFREQ_BINDINGS_FILE_SCALING_DRIVER);
+  return fd < 0 ? -1 : cpufreq_bindings_get_scaling_driver(fd, core, driver, len);
+}
+
+ssize_t cpufreq_bindings_ctx_get_scaling_governor(cpufreq_bindings_ctx* ctx, uint32_t core, char* governor,
+                                                  size_t len) {
+  int fd = cpufreq_bindings_ctx_get_fd(ctx, core, CPUFREQ_BINDINGS_FILE_SCALING_GOVERNOR);
+  return fd < 0 ? -1 : cpufreq_bindings_get_scaling_governor(fd, core, governor, len);
+}
+
+ssize_t cpufreq_bindings_ctx_set_scaling_governor(cpufreq_bindings_ctx* ctx, uint32_t core, const char* governor,
+                                                  size_t len) {
+  int fd = cpufreq_bindings_ctx_get_fd(ctx, core, CPUFREQ_BINDINGS_FILE_SCALING_GOVERNOR);
+  ssize_t ret = fd < 0 ? -1 : cpufreq_bindings_set_scaling_governor(fd, core, governor, len);
+  if (ctx->coalesce != NULL) {
+    // a governor change may reset "scaling_setspeed"
+    cpufreq_bindings_coalesce_update(ctx, core, CPUFREQ_BINDINGS_FILE_SCALING_SETSPEED, NULL);
+  }
+  return ret;
+}
+
+uint32_t cpufreq_bindings_ctx_get_scaling_max_freq(cpufreq_bindings_ctx* ctx, uint32_t core) {
+  int fd = cpufreq_bindings_ctx_get_fd(ctx, core, CPUFREQ_BINDINGS_FILE_SCALING_MAX_FREQ);
+  return fd < 0 ? 0 : cpufreq_bindings_get_scaling_max_freq(fd, core);
+}
+
+ssize_t cpufreq_bindings_ctx_set_scaling_max_freq(cpufreq_bindings_ctx* ctx, uint32_t core, uint32_t freq) {
+  int fd;
+  if (ctx->coalesce != NULL) {
+    return cpufreq_bindings_coalesce_write(ctx, core, CPUFREQ_BINDINGS_FILE_SCALING_MAX_FREQ, freq);
+  }
+  fd = cpufreq_bindings_ctx_get_fd(ctx, core, CPUFREQ_BINDINGS_FILE_SCALING_MAX_FREQ);
+  return fd < 0 ? -1 : cpufreq_bindings_set_scaling_max_freq(fd, core, freq);
+}
+
+uint32_t cpufreq_bindings_ctx_get_scaling_min_freq(cpufreq_bindings_ctx* ctx, uint32_t core) {
+  int fd = cpufreq_bindings_ctx_get_fd(ctx, core, CPUFREQ_BINDINGS_FILE_SCALING_MIN_FREQ);
+  return fd < 0 ? 0 : cpufreq_bindings_get_scaling_min_freq(fd, core);
+}
+
+ssize_t cpufreq_bindings_ctx_set_scaling_min_freq(cpufreq_bindings_ctx* ctx, uint32_t core, uint32_t freq) {
+  int fd;
+  if (ctx->coalesce != NULL) {
+    return cpufreq_bindings_coalesce_write(ctx, core, CPUFREQ_BINDINGS_FILE_SCALING_MIN_FREQ, freq);
+  }
+  fd = cpufreq_bindings_ctx_get_fd(ctx, core, CPUFREQ_BINDINGS_FILE_SCALING_MIN_FREQ);
+  return fd < 0 ? -1 : cpufreq_bindings_set_scaling_min_freq(fd, core, freq);
+}
+
+ssize_t cpufreq_bindings_ctx_set_scaling_setspeed(cpufreq_bindings_ctx* ctx, uint32_t core, uint32_t freq) {
+  int fd;
+  if (ctx->coalesce != NULL) {
+    return cpufreq_bindings_coalesce_write(ctx, core, CPUFREQ_BINDINGS_FILE_SCALING_SETSPEED, freq);
+  }
+  fd = cpufreq_bindings_ctx_get_fd(ctx, core, CPUFREQ_BINDINGS_FILE_SCALING_SETSPEED);
+  return fd < 0 ? -1 : cpufreq_bindings_set_scaling_setspeed(fd, core, freq);
+}
+
+uint32_t cpufreq_bindings_ctx_get_stats_time_in_state(cpufreq_bindings_ctx* ctx, uint32_t core, uint32_t* freqs,
+                                                      uint64_t* times, uint32_t len) {
+  int fd = cpufreq_bindings_ctx_get_fd(ctx, core, CPUFREQ_BINDINGS_FILE_STATS_TIME_IN_STATE);
+  return fd < 0 ? 0 : cpufreq_bindings_get_stats_time_in_state(fd, core, freqs, times, len);
+}
+
+uint32_t cpufreq_bindings_ctx_get_stats_total_trans(cpufreq_bindings_ctx* ctx, uint32_t core) {
+  int fd = cpufreq_bindings_ctx_get_fd(ctx, core, CPUFREQ_BINDINGS_FILE_STATS_TOTAL_TRANS);
+  return fd < 0 ? 0 : cpufreq_bindings_get_stats_total_trans(fd, core);
+}
+
+uint32_t cpufreq_bindings_ctx_get_stats_trans_table(cpufreq_bindings_ctx* ctx, uint32_t core, uint32_t* freqs,
+                                                    uint32_t* counts, uint32_t len) {
+  int fd = cpufreq_bindings_ctx_get_fd(ctx, core, CPUFREQ_BINDINGS_FILE_STATS_TRANS_TABLE);
+  return fd < 0 ? 0 : cpufreq_bindings_get_stats_trans_table(fd, core, freqs, counts, len);
+}
+
+uint32_t cpufreq_bindings_ctx_get_base_frequency(cpufreq_bindings_ctx* ctx, uint32_t core) {
+  int fd = cpufreq_bindings_ctx_get_fd(ctx, core, CPUFREQ_BINDINGS_FILE_BASE_FREQUENCY);
+  return fd < 0 ? 0 : cpufreq_bindings_get_base_frequency(fd, core);
+}
+
+uint32_t cpufreq_bindings_ctx_get_energy_performance_available_preferences(cpufreq_bindings_ctx* ctx, uint32_t core,
+                                                                           char* prefs, size_t len, size_t width) {
+  int fd = cpufreq_bindings_ctx_get_fd(ctx, core, CPUFREQ_BINDINGS_FILE_ENERGY_PERFORMANCE_AVAILABLE_PREFERENCES);
+  return fd < 0 ? 0 : cpufreq_bindings_get_energy_performance_available_preferences(fd, core, prefs, len, width);
+}
+
+ssize_t cpufreq_bindings_ctx_get_energy_performance_preference(cpufreq_bindings_ctx* ctx, uint32_t core, char* pref,
+                                                               size_t len) {
+  int fd = cpufreq_bindings_ctx_get_fd(ctx, core, CPUFREQ_BINDINGS_FILE_ENERGY_PERFORMANCE_PREFERENCE);
+  return fd < 0 ? -1 : cpufreq_bindings_get_energy_performance_preference(fd, core, pref, len);
+}
+
+ssize_t cpufreq_bindings_ctx_set_energy_performance_preference(cpufreq_bindings_ctx* ctx, uint32_t core,
+                                                               const char* pref, size_t len) {
+  int fd = cpufreq_bindings_ctx_get_fd(ctx, core, CPUFREQ_BINDINGS_FILE_ENERGY_PERFORMANCE_PREFERENCE);
+  return fd < 0 ? -1 : cpufreq_bindings_set_energy_performance_preference(fd, core, pref, len);
+}
+
+uint32_t cpufreq_bindings_ctx_get_boost(cpufreq_bindings_ctx* ctx) {
+  int fd = cpufreq_bindings_ctx_get_fd(ctx, 0, CPUFREQ_BINDINGS_FILE_BOOST);
+  return fd < 0 ? 0 : cpufreq_bindings_get_boost(fd);
+}
+
+ssize_t cpufreq_bindings_ctx_set_boost(cpufreq_bindings_ctx* ctx, uint32_t enable) {
+  int fd = cpufreq_bindings_ctx_get_fd(ctx, 0, CPUFREQ_BINDINGS_FILE_BOOST);
+  return fd < 0 ? -1 : cpufreq_bindings_set_boost(fd, enable);
+}
+
+uint32_t cpufreq_bindings_ctx_get_intel_pstate_max_perf_pct(cpufreq_bindings_ctx* ctx) {
+  int fd = cpufreq_bindings_ctx_get_fd(ctx, 0, CPUFREQ_BINDINGS_FILE_INTEL_PSTATE_MAX_PERF_PCT);
+  return fd < 0 ? 0 : cpufreq_bindings_get_intel_pstate_max_perf_pct(fd);
+}
+
+ssize_t cpufreq_bindings_ctx_set_intel_pstate_max_perf_pct(cpufreq_bindings_ctx* ctx, uint32_t pct) {
+  int fd = cpufreq_bindings_ctx_get_fd(ctx, 0, CPUFREQ_BINDINGS_FILE_INTEL_PSTATE_MAX_PERF_PCT);
+  return fd < 0 ? -1 : cpufreq_bindings_set_intel_pstate_max_perf_pct(fd, pct);
+}
+
+uint32_t cpufreq_bindings_ctx_get_intel_pstate_min_perf_pct(cpufreq_bindings_ctx* ctx) {
+  int fd = cpufreq_bindings_ctx_get_fd(ctx, 0, CPUFREQ_BINDINGS_FILE_INTEL_PSTATE_MIN_PERF_PCT);
+  return fd < 0 ? 0 : cpufreq_bindings_get_intel_pstate_min_perf_pct(fd);
+}
+
+ssize_t cpufreq_bindings_ctx_set_intel_pstate_min_perf_pct(cpufreq_bindings_ctx* ctx, uint32_t pct) {
+  int fd = cpufreq_bindings_ctx_get_fd(ctx, 0, CPUFREQ_BINDINGS_FILE_INTEL_PSTATE_MIN_PERF_PCT);
+  return fd < 0 ? -1 : cpufreq_bindings_set_intel_pstate_min_perf_pct(fd, pct);
+}
+
+uint32_t cpufreq_bindings_ctx_get_intel_pstate_no_turbo(cpufreq_bindings_ctx* ctx) {
+  int fd = cpufreq_bindings_ctx_get_fd(ctx, 0, CPUFREQ_BINDINGS_FILE_INTEL_PSTATE_NO_TURBO);
+  return fd < 0 ? 0 : cpufreq_bindings_get_intel_pstate_no_turbo(fd);
+}
+
+ssize_t cpufreq_bindings_ctx_set_intel_pstate_no_turbo(cpufreq_bindings_ctx* ctx, uint32_t disable) {
+  int fd = cpufreq_bindings_ctx_get_fd(ctx, 0, CPUFREQ_BINDINGS_FILE_INTEL_PSTATE_NO_TURBO);
+  return fd < 0 ? -1 : cpufreq_bindings_set_intel_pstate_no_turbo(fd, disable);
+}
+
+/*
+ * Batch API
+ */
+
+static int is_u32_file(cpufreq_bindings_file file) {
+  switch (file) {
+    case CPUFREQ_BINDINGS_FILE_BIOS_LIMIT:
+    case CPUFREQ_BINDINGS_FILE_CPUINFO_CUR_FREQ:
+    case CPUFREQ_BINDINGS_FILE_CPUINFO_MAX_FREQ:
+    case CPUFREQ_BINDINGS_FILE_CPUINFO_MIN_FREQ:
+    case CPUFREQ_BINDINGS_FILE_CPUINFO_TRANSITION_LATENCY:
+    case CPUFREQ_BINDINGS_FILE_SCALING_CUR_FREQ:
+    case CPUFREQ_BINDINGS_FILE_SCALING_MAX_FREQ:
+    case CPUFREQ_BINDINGS_FILE_SCALING_MIN_FREQ:
+    case CPUFREQ_BINDINGS_FILE_SCALING_SETSPEED:
+    case CPUFREQ_BINDINGS_FILE_STATS_TOTAL_TRANS:
+    case CPUFREQ_BINDINGS_FILE_BASE_FREQUENCY:
+      return 1;
+    default:
+      break;
+  }
+  return 0;
+}
+
+static int is_u32_writable_file(cpufreq_bindings_file file) {
+  switch (file) {
+    case CPUFREQ_BINDINGS_FILE_SCALING_MAX_FREQ:
+    case CPUFREQ_BINDINGS_FILE_SCALING_MIN_FREQ:
+    case CPUFREQ_BINDINGS_FILE_SCALING_SETSPEED:
+      return 1;
+    default:
+      break;
+  }
+  return 0;
+}
+
+// "res" is the number of bytes read/written, or -errno; returns 0 on success, an errno value if not
+static int u32_io_result(const char* buf, ssize_t res, int write, uint32_t* out) {
+  int err;
+  if (res < 0) {
+    return (int) -res;
+  }
+  if (write) {
+    return 0;
+  }
+  if (res == 0) {
+    return ENODATA;
+  }
+  if ((err = cpufreq_bindings_parse_u32(buf, (size_t) res, out))) {
+    STATS_COUNT(COUNTER_PARSE_ERROR);
+  }
+  return err;
+}
+
+// writes "*in" if not NULL, otherwise reads into "out"; returns 0 on success, an errno value if not
+static int u32_io_sync(int fd, cpufreq_bindings_file file, const uint32_t* in, uint32_t* out) {
+  // one scratch buffer, reused for each operation in a batch
+  char buf[U32_MAX_LEN];
+  uint64_t start;
+  ssize_t res;
+  size_t len;
+  // only used for stats
+  (void) file;
+  if (in != NULL) {
+    len = (size_t) snprintf(buf, sizeof(buf), "%"PRIu32, *in);
+    start = STATS_START();
+    res = pwrite(fd, buf, len, 0);
+  } else {
+    start = STATS_START();
+    res = pread(fd, buf, sizeof(buf), 0);
+  }
+  STATS_IO(file, in != NULL, res < 0, start);
+  return u32_io_result(buf, res < 0 ? -errno : res, in != NULL, out);
+}
+
+int cpufreq_bindings_ctx_u32_read(cpufreq_bindings_ctx* ctx, uint32_t core, cpufreq_bindings_file file,
+                                  uint32_t* val) {
+  int fd;
+  if ((int) file < 0 || (int) file >= BINDINGS_FILE_COUNT || !is_u32_file(file)) {
+    return EINVAL;
+  }
+  if ((fd = cpufreq_bindings_ctx_get_fd(ctx, core, file)) < 0) {
+    return errno;
+  }
+  return u32_io_sync(fd, file, NULL, val);
+}
+
+int cpufreq_bindings_ctx_u32_write(cpufreq_bindings_ctx* ctx, uint32_t core, cpufreq_bindings_file file,
+                                  uint32_t val) {
+  uint64_t trace_ns;
+  int fd;
+  int err;
+  if ((int) file < 0 || (int) file >= BINDINGS_FILE_COUNT || !is_u32_writable_file(file)) {
+    return EINVAL;
+  }
+  if ((fd = cpufreq_bindings_ctx_get_fd(ctx, core, file)) < 0) {
+    return errno;
+  }
+  trace_ns = TRACE_START();
+  if (!(err = u32_io_sync(fd, file, &val, NULL))) {
+    TRACE_U32(trace_ns, core, file, val);
+  }
+  if (ctx->coalesce != NULL) {
+    cpufreq_bindings_coalesce_update(ctx, core, file, err ? NULL : &val);
+  }
+  return err;
+}
+
+#ifdef CPUFREQ_BINDINGS_IO_URING
+// bound the ring (and scratch) size; larger batches are submitted in chunks
+#define RING_ENTRIES_MIN 32
+#define RING_ENTRIES_MAX 4096
+
+// returns 1 if the calling thread now owns the ring, 0 if the synchronous path must be used
+static int ctx_ring_acquire(cpufreq_bindings_ctx* ctx) {
+  unsigned int entries;
+  int expected = 0;
+  if (__atomic_load_n(&ctx->io_failed, __ATOMIC_RELAXED) ||
+      !__atomic_compare_exchange_n(&ctx->io_busy, &expected, 1, 0, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+    return 0;
+  }
+  if (ctx->ring == NULL) {
+    entries = ctx->ncores < RING_ENTRIES_MIN ? RING_ENTRIES_MIN :
+              ctx->ncores > RING_ENTRIES_MAX ? RING_ENTRIES_MAX : ctx->ncores;
+    if ((ctx->ring = cpufreq_bindings_uring_init(entries)) != NULL) {
+      entries = cpufreq_bindings_uring_get_entries(ctx->ring);
+      ctx->ios = malloc(entries * sizeof(cpufreq_bindings_io));
+      ctx->io_bufs = malloc(entries * U32_MAX_LEN);
+    }
+    if (ctx->ring == NULL || ctx->ios == NULL || ctx->io_bufs == NULL) {
+      LOG(INFO, "io_uring unavailable, using synchronous I/O\n");
+      __atomic_store_n(&ctx->io_failed, 1, __ATOMIC_RELAXED);
+      __atomic_store_n(&ctx->io_busy, 0, __ATOMIC_RELEASE);
+      return 0;
+    }
+  }
+  return 1;
+}
+
+static void ctx_ring_release(cpufreq_bindings_ctx* ctx) {
+  __atomic_store_n(&ctx->io_busy, 0, __ATOMIC_RELEASE);
+}
+
+static void ctx_u32_batch_ring(cpufreq_bindings_ctx* ctx, const cpufreq_bindings_file* files, uint32_t nfiles,
+                               const uint32_t* cores, size_t total, const uint32_t* in, uint32_t* out, int* status) {
+  cpufreq_bindings_io* io;
+  size_t entries = cpufreq_bindings_uring_get_entries(ctx->ring);
+  size_t base;
+  size_t i;
+  unsigned int m;
+  unsigned int k;
+  int fd;
+  for (base = 0; base < total; base += entries) {
+    // queue every operation in this chunk that has a file descriptor
+    for (i = base, m = 0; i < total && i < base + entries; i++) {
+      if ((fd = cpufreq_bindings_ctx_get_fd(ctx, cores[i / nfiles], files[i % nfiles])) < 0) {
+        status[i] = errno;
+        continue;
+      }
+      io = &ctx->ios[m++];
+      io->fd = fd;
+      io->write = in != NULL;
+      io->buf = &ctx->io_bufs[(size_t) (io - ctx->ios) * U32_MAX_LEN];
+      io->len = in != NULL ? (size_t) snprintf(io->buf, U32_MAX_LEN, "%"PRIu32, in[i]) : U32_MAX_LEN;
+      io->res = -ECANCELED;
+      io->tag = i;
+    }
+    if (m == 0) {
+      continue;
+    }
+    if (__atomic_load_n(&ctx->io_failed, __ATOMIC_RELAXED) || cpufreq_bindings_uring_submit(ctx->ring, ctx->ios, m)) {
+      // the ring is no longer trustworthy - finish synchronously from now on
+      __atomic_store_n(&ctx->io_failed, 1, __ATOMIC_RELAXED);
+      for (k = 0; k < m; k++) {
+        i = ctx->ios[k].tag;
+        status[i] = u32_io_sync(ctx->ios[k].fd, files[i % nfiles], in == NULL ? NULL : &in[i],
+                                out == NULL ? NULL : &out[i]);
+      }
+    } else {
+      STATS_COUNT(COUNTER_URING_SUBMIT);
+      for (k = 0; k < m; k++) {
+        io = &ctx->ios[k];
+        STATS_IO(files[io->tag % nfiles], io->write, io->res < 0, 0);
+        status[io->tag] = u32_io_result(io->buf, io->res, io->write, out == NULL ? NULL : &out[io->tag]);
+      }
+    }
+  }
+}
+#endif
+
+uint32_t cpufreq_bindings_ctx_u32_batch(cpufreq_bindings_ctx* ctx, const cpufreq_bindings_file* files, uint32_t nfiles,
+                                        const uint32_t* cores, uint32_t ncores, const uint32_t* in, uint32_t* out,
+                                        int* status) {
+  size_t total = (size_t) ncores * nfiles;
+  size_t i;
+  uint64_t trace_ns = in == NULL ? 0 : TRACE_START();
+  uint32_t n = 0;
+  int err_save = errno;
+  int fd;
+  if (in == NULL) {
+    memset(out, 0, total * sizeof(uint32_t));
+  }
+#ifdef CPUFREQ_BINDINGS_IO_URING
+  if (ctx_ring_acquire(ctx)) {
+    ctx_u32_batch_ring(ctx, files, nfiles, cores, total, in, out, status);
+    ctx_ring_release(ctx);
+  } else
+#endif
+  {
+    for (i = 0; i < total; i++) {
+      if ((fd = cpufreq_bindings_ctx_get_fd(ctx, cores[i / nfiles], files[i % nfiles])) < 0) {
+        status[i] = errno;
+      } else {
+        status[i] = u32_io_sync(fd, files[i % nfiles], in == NULL ? NULL : &in[i], out == NULL ? NULL : &out[i]);
+      }
+    }
+  }
+  for (i = 0; i < total; i++) {
+    if (status[i] == 0) {
+      // a batch's writes share the time it was issued
+      if (in != NULL) {
+        TRACE_U32(trace_ns, cores[i / nfiles], files[i % nfiles], in[i]);
+      }
+      n++;
+    }
+    if (in != NULL && ctx->coalesce != NULL) {
+      cpufreq_bindings_coalesce_update(ctx, cores[i / nfiles], files[i % nfiles], status[i] ? NULL : &in[i]);
+    }
+  }
+  errno = err_save;
+  return n;
+}
+
+// a short write stores a truncated value, so it's an error; returns 0 on success, an errno value if not
+static int str_write_result(ssize_t res, size_t len) {
+  return res < 0 ? (int) -res : (size_t) res < len ? EIO : 0;
+}
+
+// returns 0 on success, an errno value if not
+static int str_write_sync(int fd, cpufreq_bindings_file file, const char* buf, size_t len) {
+  uint64_t start = STATS_START();
+  ssize_t res = pwrite(fd, buf, len, 0);
+  // only used for stats
+  (void) file;
+  STATS_IO(file, 1, res < 0, start);
+  return str_write_result(res < 0 ? -errno : res, len);
+}
+
+#ifdef CPUFREQ_BINDINGS_IO_URING
+static void ctx_str_write_batch_ring(cpufreq_bindings_ctx* ctx, cpufreq_bindings_file file, const uint32_t* cores,
+                                     uint32_t ncores, char* buf, size_t len, int* status) {
+  cpufreq_bindings_io* io;
+  size_t entries = cpufreq_bindings_uring_get_entries(ctx->ring);
+  size_t base;
+  size_t i;
+  unsigned int m;
+  unsigned int k;
+  int fd;
+  for (base = 0; base < ncores; base += entries) {
+    for (i = base, m = 0; i < ncores && i < base + entries; i++) {
+      if ((fd = cpufreq_bindings_ctx_get_fd(ctx, cores[i], file)) < 0) {
+        status[i] = errno;
+        continue;
+      }
+      io = &ctx->ios[m++];
+      io->fd = fd;
+      io->write = 1;
+      // every write shares the caller's buffer
+      io->buf = buf;
+      io->len = len;
+      io->res = -ECANCELED;
+      io->tag = i;
+    }
+    if (m == 0) {
+      continue;
+    }
+    if (__atomic_load_n(&ctx->io_failed, __ATOMIC_RELAXED) || cpufreq_bindings_uring_submit(ctx->ring, ctx->ios, m)) {
+      __atomic_store_n(&ctx->io_failed, 1, __ATOMIC_RELAXED);
+      for (k = 0; k < m; k++) {
+        status[ctx->ios[k].tag] = str_write_sync(ctx->ios[k].fd, file, buf, len);
+      }
+    } else {
+      STATS_COUNT(COUNTER_URING_SUBMIT);
+      for (k = 0; k < m; k++) {
+        io = &ctx->ios[k];
+        STATS_IO(file, 1, io->res < 0, 0);
+        status[io->tag] = str_write_result(io->res, len);
+      }
+    }
+  }
+}
+#endif
+
+uint32_t cpufreq_bindings_ctx_set_energy_performance_preference_batch(cpufreq_bindings_ctx* ctx, const uint32_t* cores,
+                                                                      uint32_t ncores, const char* pref, int* status) {
+  const cpufreq_bindings_file file = CPUFREQ_BINDINGS_FILE_ENERGY_PERFORMANCE_PREFERENCE;
+  // longer than any preference
+  char buf[64];
+  size_t len = strlen(pref);
+  uint64_t trace_ns = TRACE_START();
+  uint32_t n = 0;
+  uint32_t i;
+  int err_save = errno;
+  int fd;
+  if (len >= sizeof(buf)) {
+    errno = EINVAL;
+    return 0;
+  }
+  memcpy(buf, pref, len + 1);
+#ifdef CPUFREQ_BINDINGS_IO_URING
+  if (ctx_ring_acquire(ctx)) {
+    ctx_str_write_batch_ring(ctx, file, cores, ncores, buf, len, status);
+    ctx_ring_release(ctx);
+  } else
+#endif
+  {
+    for (i = 0; i < ncores; i++) {
+      if ((fd = cpufreq_bindings_ctx_get_fd(ctx, cores[i], file)) < 0) {
+        status[i] = errno;
+      } else {
+        status[i] = str_write_sync(fd, file, buf, len);
+      }
+    }
+  }
+  for (i = 0; i < ncores; i++) {
+    if (status[i] == 0) {
+      TRACE_STR(trace_ns, cores[i], file, buf, len);
+      n++;
+    }
+  }
+  errno = err_save;
+  return n;
+}
+
+uint32_t cpufreq_bindings_ctx_get_u32_batch(cpufreq_bindings_ctx* ctx, cpufreq_bindings_file file,
+                                            const uint32_t* cores, uint32_t ncores, uint32_t* vals, int* status) {
+  if ((int) file < 0 || (int) file >= BINDINGS_FILE_COUNT || !is_u32_file(file)) {
+    errno = EINVAL;
+    return 0;
+  }
+  return cpufreq_bindings_ctx_u32_batch(ctx, &file, 1, cores, ncores, NULL, vals, status);
+}
+
+uint32_t cpufreq_bindings_ctx_get_u32_batch_multi(cpufreq_bindings_ctx* ctx, const cpufreq_bindings_file* files,
+                                                  uint32_t nfiles, const uint32_t* cores, uint32_t ncores,
+                                                  uint32_t* vals, int* status) {
+  uint32_t i;
+  for (i = 0; i < nfiles; i++) {
+    if ((int) files[i] < 0 || (int) files[i] >= BINDINGS_FILE_COUNT || !is_u32_file(files[i])) {
+      errno = EINVAL;
+      return 0;
+    }
+  }
+  return cpufreq_bindings_ctx_u32_batch(ctx, files, nfiles, cores, ncores, NULL, vals, status);
+}
+
+uint32_t cpufreq_bindings_ctx_set_u32_batch(cpufreq_bindings_ctx* ctx, cpufreq_bindings_file file,
+                                            const uint32_t* cores, uint32_t ncores, const uint32_t* vals,
+                                            int* status) {
+  if ((int) file < 0 || (int) file >= BINDINGS_FILE_COUNT || !is_u32_writable_file(file)) {
+    errno = EINVAL;
+    return 0;
+  }
+  return cpufreq_bindings_ctx_u32_batch(ctx, &file, 1, cores, ncores, vals, NULL, status);
+}
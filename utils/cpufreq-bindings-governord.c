@@ -0,0 +1,382 @@
+/**
+ * Run a userspace governor policy on top of the "userspace" cpufreq governor.
+ *
+ * @author Connor Imes
+ * @date 2026-10-15
+ */
+// for clock_nanosleep, sigaction
+#define _POSIX_C_SOURCE 200809L
+#include <errno.h>
+#include <getopt.h>
+#include <inttypes.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "cpufreq-bindings.h"
+#include "cpufreq-bindings-governor.h"
+#include "cpufreq-bindings-plan.h"
+#include "cpufreq-bindings-trace.h"
+
+#define MAX_SCHEDULE_ENTRIES 64
+
+// 128 MiB, allocated as written
+#define TRACE_CAPACITY (1ULL << 22)
+
+// the largest CONFIG_NR_CPUS supported by the kernel
+#define MAX_CPUS 8192
+
+typedef struct saved_governors {
+  uint32_t* policies;
+  char (*governors)[CPUFREQ_BINDINGS_PLAN_GOVERNOR_LEN];
+  uint32_t npolicies;
+} saved_governors;
+
+static volatile sig_atomic_t running = 1;
+
+static void handle_signal(int sig) {
+  (void) sig;
+  running = 0;
+}
+
+// "MS:KHZ[,MS:KHZ]..."
+static uint32_t parse_schedule(const char* str, cpufreq_bindings_governor_schedule_entry* entries) {
+  uint32_t n = 0;
+  unsigned long ms;
+  unsigned long khz;
+  char* end;
+  while (*str != '\0') {
+    if (n == MAX_SCHEDULE_ENTRIES) {
+      return 0;
+    }
+    ms = strtoul(str, &end, 0);
+    if (*end != ':') {
+      return 0;
+    }
+    khz = strtoul(end + 1, &end, 0);
+    if ((*end != ',' && *end != '\0') || ms == 0 || khz == 0) {
+      return 0;
+    }
+    entries[n].duration_ns = ms * 1000000ULL;
+    entries[n].freq = (uint32_t) khz;
+    n++;
+    str = *end == ',' ? end + 1 : end;
+  }
+  return n;
+}
+
+// switch only the policies of the governed cores
+static int switch_to_userspace(cpufreq_bindings_ctx* ctx, const uint32_t* cores, uint32_t ncores,
+                               saved_governors* saved) {
+  cpufreq_bindings_plan* plan;
+  uint32_t nctx = cpufreq_bindings_ctx_get_ncores(ctx);
+  uint32_t* cpus;
+  uint32_t policy;
+  uint32_t npolicies = 0;
+  uint32_t i;
+  uint32_t j;
+  int ret = -1;
+  saved->policies = malloc(ncores * sizeof(uint32_t));
+  saved->governors = calloc(ncores, sizeof(*saved->governors));
+  if ((cpus = malloc(nctx * sizeof(uint32_t))) == NULL || saved->policies == NULL || saved->governors == NULL) {
+    free(cpus);
+    return -1;
+  }
+  for (i = 0; i < ncores; i++) {
+    if (cpufreq_bindings_ctx_get_core_policy(ctx, cores[i], &policy)) {
+      free(cpus);
+      return -1;
+    }
+    for (j = 0; j < npolicies && saved->policies[j] != policy; j++);
+    if (j == npolicies) {
+      saved->policies[npolicies++] = policy;
+    }
+  }
+  if ((plan = cpufreq_bindings_plan_init(ctx)) == NULL) {
+    free(cpus);
+    return -1;
+  }
+  for (i = 0; i < npolicies; i++) {
+    if (cpufreq_bindings_ctx_get_policy_cpus(ctx, saved->policies[i], cpus, nctx) == 0 ||
+        cpufreq_bindings_ctx_get_scaling_governor(ctx, cpus[0], saved->governors[i],
+                                                  sizeof(saved->governors[i]) - 1) <= 0 ||
+        cpufreq_bindings_plan_set_policy(plan, saved->policies[i], 0, 0, "userspace")) {
+      break;
+    }
+  }
+  if (i == npolicies && (ret = cpufreq_bindings_plan_apply(plan, NULL)) == 0) {
+    // only restore governors after switching
+    saved->npolicies = npolicies;
+  }
+  cpufreq_bindings_plan_destroy(plan);
+  free(cpus);
+  return ret;
+}
+
+static int restore_governors(cpufreq_bindings_ctx* ctx, const saved_governors* saved) {
+  cpufreq_bindings_plan* plan;
+  uint32_t i;
+  int ret = -1;
+  if ((plan = cpufreq_bindings_plan_init(ctx)) == NULL) {
+    return -1;
+  }
+  for (i = 0; i < saved->npolicies; i++) {
+    if (cpufreq_bindings_plan_set_policy(plan, saved->policies[i], 0, 0, saved->governors[i])) {
+      break;
+    }
+  }
+  if (i == saved->npolicies) {
+    ret = cpufreq_bindings_plan_apply(plan, NULL);
+  }
+  cpufreq_bindings_plan_destroy(plan);
+  return ret;
+}
+
+static void print_stats(const cpufreq_bindings_governor* g, uint64_t period_ns) {
+  cpufreq_bindings_governor_stats s;
+  cpufreq_bindings_governor_get_stats(g, &s);
+  printf("periods=%"PRIu64" dropped=%"PRIu64" decisions=%"PRIu64" skipped=%"PRIu64" over_budget=%"PRIu64
+         " writes=%"PRIu64" errors=%"PRIu64"\n",
+         s.periods, s.dropped, s.decisions, s.skipped, s.over_budget, s.writes, s.errors);
+  printf("overhead: avg=%.1f us max=%.1f us (%.4f%% of period); decision-to-write latency: avg=%.1f us max=%.1f us\n",
+         s.periods > 0 ? s.overhead_ns_total / 1000.0 / s.periods : 0, s.overhead_ns_max / 1000.0,
+         s.periods > 0 ? 100.0 * s.overhead_ns_total / s.periods / period_ns : 0,
+         s.writes > 0 ? s.write_latency_ns_total / 1000.0 / s.writes : 0, s.write_latency_ns_max / 1000.0);
+  fflush(stdout);
+}
+
+static int run(const uint32_t* cores, uint32_t ncores, cpufreq_bindings_governor_opts* opts, int userspace,
+               uint32_t duration_s, uint32_t stats_ms) {
+  cpufreq_bindings_ctx* ctx;
+  cpufreq_bindings_governor* g = NULL;
+  saved_governors saved;
+  struct sigaction sa;
+  struct timespec ts;
+  uint64_t elapsed_ms = 0;
+  uint64_t next_stats_ms = stats_ms;
+  int ret = 0;
+  memset(&saved, 0, sizeof(saved));
+  // cores are sorted, so the last is the highest
+  if ((ctx = cpufreq_bindings_ctx_init(cores[ncores - 1] + 1)) == NULL) {
+    perror("cpufreq_bindings_ctx_init");
+    return -errno;
+  }
+  if (userspace && switch_to_userspace(ctx, cores, ncores, &saved)) {
+    perror("Switching to the userspace governor");
+    ret = -errno;
+    goto out;
+  }
+  if ((g = cpufreq_bindings_governor_init(ctx, cores, ncores, opts)) == NULL) {
+    perror("cpufreq_bindings_governor_init");
+    ret = -errno;
+    goto out;
+  }
+  memset(&sa, 0, sizeof(sa));
+  sa.sa_handler = handle_signal;
+  sigaction(SIGINT, &sa, NULL);
+  sigaction(SIGTERM, &sa, NULL);
+  if (cpufreq_bindings_governor_start(g)) {
+    perror("cpufreq_bindings_governor_start");
+    ret = -errno;
+    goto out;
+  }
+  printf("Governing %"PRIu32" policies every %.3f ms\n", cpufreq_bindings_governor_get_npolicies(g),
+         opts->period_ns / 1000000.0);
+  fflush(stdout);
+  // the governor runs in its own thread - just wake up every 100 ms to check the duration, stats, and signals
+  ts.tv_sec = 0;
+  ts.tv_nsec = 100000000L;
+  while (running && (duration_s == 0 || elapsed_ms < duration_s * 1000ULL)) {
+    nanosleep(&ts, NULL);
+    elapsed_ms += 100;
+    if (stats_ms > 0 && elapsed_ms >= next_stats_ms) {
+      print_stats(g, opts->period_ns);
+      next_stats_ms += stats_ms;
+    }
+  }
+  cpufreq_bindings_governor_stop(g);
+  print_stats(g, opts->period_ns);
+
+out:
+  if (g != NULL) {
+    cpufreq_bindings_governor_destroy(g);
+  }
+  if (saved.npolicies > 0 && restore_governors(ctx, &saved)) {
+    perror("Restoring governors");
+    ret = -errno;
+  }
+  free(saved.policies);
+  free(saved.governors);
+  cpufreq_bindings_ctx_destroy(ctx);
+  return ret;
+}
+
+static const char short_options[] = "hp:i:c:b:t:s:ud:S:T:r:R:";
+static const struct option long_options[] = {
+  {"help",                no_argument,        NULL, 'h'},
+  {"policy",              required_argument,  NULL, 'p'},
+  {"interval",            required_argument,  NULL, 'i'},
+  {"cpus",                required_argument,  NULL, 'c'},
+  {"budget",              required_argument,  NULL, 'b'},
+  {"threshold",           required_argument,  NULL, 't'},
+  {"setpoint",            required_argument,  NULL, 'P'},
+  {"kp",                  required_argument,  NULL, 'K'},
+  {"ki",                  required_argument,  NULL, 'I'},
+  {"kd",                  required_argument,  NULL, 'D'},
+  {"schedule",            required_argument,  NULL, 's'},
+  {"userspace",           no_argument,        NULL, 'u'},
+  {"duration",            required_argument,  NULL, 'd'},
+  {"stats",               required_argument,  NULL, 'S'},
+  {"trace",               required_argument,  NULL, 'T'},
+  {"root",                required_argument,  NULL, 'r'},
+  {"procfs-root",         required_argument,  NULL, 'R'},
+  {0, 0, 0, 0}
+};
+
+static void print_usage(void) {
+  printf("Usage: cpufreq-bindings-governord [OPTION]...\n");
+  printf("Options:\n");
+  printf("  -h, --help                   Print this message and exit\n");
+  printf("  -p, --policy=NAME            The policy: ondemand (default), pid, or schedule\n");
+  printf("  -i, --interval=US            The governor period in microseconds (default is 10000)\n");
+  printf("  -c, --cpus=LIST              The processor cores to govern, e.g., 0-3,8 (default is all configured)\n");
+  printf("  -b, --budget=US              The maximum time per period for reading and deciding (default is none)\n");
+  printf("  -t, --threshold=UTIL         ondemand: the utilization for the maximum frequency (default is 0.8)\n");
+  printf("      --setpoint=UTIL          pid: the target utilization (default is 0.7)\n");
+  printf("      --kp=GAIN                pid: the proportional gain (default is 0.5)\n");
+  printf("      --ki=GAIN                pid: the integral gain (default is 0.05)\n");
+  printf("      --kd=GAIN                pid: the derivative gain (default is 0)\n");
+  printf("  -s, --schedule=MS:KHZ[,...]  schedule: frequencies and how long to use each, repeated\n");
+  printf("  -u, --userspace              Switch to the userspace governor, restoring the previous ones at exit\n");
+  printf("  -d, --duration=S             Stop after S seconds (default is until interrupted)\n");
+  printf("  -S, --stats=MS               Print statistics every MS milliseconds, not just at exit\n");
+  printf("  -T, --trace=FILE             Record frequency and governor writes to FILE for cpufreq-bindings-replay\n");
+  printf("  -r, --root=DIR               The sysfs root (default is /sys)\n");
+  printf("  -R, --procfs-root=DIR        The procfs root (default is /proc)\n");
+}
+
+int main(int argc, char** argv) {
+  static uint32_t cores[MAX_CPUS];
+  cpufreq_bindings_governor_schedule_entry entries[MAX_SCHEDULE_ENTRIES];
+  cpufreq_bindings_governor_ondemand_params ondemand = { 0 };
+  cpufreq_bindings_governor_pid_params pid = { 0.7, 0.5, 0.05, 0 };
+  cpufreq_bindings_governor_schedule_params schedule = { entries, 0 };
+  cpufreq_bindings_governor_opts opts;
+  long nconf = sysconf(_SC_NPROCESSORS_CONF);
+  uint32_t ncores = 0;
+  const char* policy = "ondemand";
+  const char* trace = NULL;
+  uint64_t dropped;
+  uint32_t duration_s = 0;
+  uint32_t stats_ms = 0;
+  int userspace = 0;
+  int ret;
+  int c;
+  memset(&opts, 0, sizeof(opts));
+  opts.period_ns = 10000000ULL;
+  while ((c = getopt_long(argc, argv, short_options, long_options, NULL)) != -1) {
+    switch (c) {
+      case 'h':
+        print_usage();
+        return 0;
+      case 'p':
+        policy = optarg;
+        break;
+      case 'i':
+        opts.period_ns = strtoull(optarg, NULL, 0) * 1000ULL;
+        break;
+      case 'c':
+        if ((ncores = cpufreq_bindings_parse_cpulist(optarg, cores, MAX_CPUS)) == 0) {
+          fprintf(stderr, "Invalid CPU list: %s\n", optarg);
+          return -EINVAL;
+        }
+        break;
+      case 'b':
+        opts.budget_ns = strtoull(optarg, NULL, 0) * 1000ULL;
+        break;
+      case 't':
+        ondemand.up_threshold = atof(optarg);
+        break;
+      case 'P':
+        pid.setpoint = atof(optarg);
+        break;
+      case 'K':
+        pid.kp = atof(optarg);
+        break;
+      case 'I':
+        pid.ki = atof(optarg);
+        break;
+      case 'D':
+        pid.kd = atof(optarg);
+        break;
+      case 's':
+        if ((schedule.nentries = parse_schedule(optarg, entries)) == 0) {
+          fprintf(stderr, "Invalid schedule: %s\n", optarg);
+          return -EINVAL;
+        }
+        break;
+      case 'u':
+        userspace = 1;
+        break;
+      case 'd':
+        duration_s = strtoul(optarg, NULL, 0);
+        break;
+      case 'S':
+        stats_ms = strtoul(optarg, NULL, 0);
+        break;
+      case 'T':
+        trace = optarg;
+        break;
+      case 'r':
+        if (cpufreq_bindings_set_sysfs_root(optarg)) {
+          perror("cpufreq_bindings_set_sysfs_root");
+          return -errno;
+        }
+        break;
+      case 'R':
+        opts.procfs_root = optarg;
+        break;
+      case '?':
+      default:
+        print_usage();
+        return -EINVAL;
+    }
+  }
+  if (!strcmp(policy, "ondemand")) {
+    opts.policy = cpufreq_bindings_governor_ondemand;
+    opts.arg = &ondemand;
+  } else if (!strcmp(policy, "pid")) {
+    opts.policy = cpufreq_bindings_governor_pid;
+    opts.arg = &pid;
+  } else if (!strcmp(policy, "schedule") && schedule.nentries > 0) {
+    opts.policy = cpufreq_bindings_governor_schedule;
+    opts.arg = &schedule;
+  } else {
+    fprintf(stderr, "Invalid policy: %s (the schedule policy requires --schedule)\n", policy);
+    return -EINVAL;
+  }
+  if (ncores == 0) {
+    for (; ncores < MAX_CPUS && (long) ncores < nconf; ncores++) {
+      cores[ncores] = ncores;
+    }
+  }
+  if (ncores == 0 || opts.period_ns == 0) {
+    print_usage();
+    return -EINVAL;
+  }
+  if (trace != NULL && cpufreq_bindings_trace_start(trace, TRACE_CAPACITY)) {
+    perror("cpufreq_bindings_trace_start");
+    return -errno;
+  }
+  ret = run(cores, ncores, &opts, userspace, duration_s, stats_ms);
+  if (trace != NULL) {
+    if (cpufreq_bindings_trace_stop(&dropped)) {
+      perror("cpufreq_bindings_trace_stop");
+    } else if (dropped > 0) {
+      fprintf(stderr, "Trace full: %"PRIu64" writes were not recorded\n", dropped);
+    }
+  }
+  return ret;
+}
@@ -0,0 +1,355 @@
+/**
+ * Continuously monitor core frequencies, limits, and governors, printing only what changes.
+ *
+ * @author Connor Imes
+ * @date 2026-10-15
+ */
+// for clock_gettime, clock_nanosleep, sigaction
+#define _POSIX_C_SOURCE 200809L
+#include <errno.h>
+#include <getopt.h>
+#include <inttypes.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/time.h>
+#include <time.h>
+#include <unistd.h>
+#include "cpufreq-bindings.h"
+
+#define MAX_GOV_LEN 32
+
+// the largest CONFIG_NR_CPUS supported by the kernel
+#define MAX_CPUS 8192
+
+// the u32 files read each sample, in "vals" order
+#define MONITOR_FILE_COUNT 3
+static const cpufreq_bindings_file MONITOR_FILES[MONITOR_FILE_COUNT] = {
+  CPUFREQ_BINDINGS_FILE_SCALING_CUR_FREQ,
+  CPUFREQ_BINDINGS_FILE_SCALING_MIN_FREQ,
+  CPUFREQ_BINDINGS_FILE_SCALING_MAX_FREQ
+};
+
+typedef struct core_state {
+  uint32_t vals[MONITOR_FILE_COUNT];
+  char governor[MAX_GOV_LEN];
+} core_state;
+
+typedef struct monitor {
+  cpufreq_bindings_ctx* ctx;
+  // the monitored cores, in ascending order - per-core arrays are indexed by position in this list
+  const uint32_t* cores;
+  uint32_t ncores;
+  // cores that are read, one per policy when policies are known
+  uint32_t* srcs;
+  uint32_t nsrcs;
+  // the index in "srcs" that each core's values come from
+  uint32_t* core_src;
+  uint32_t* vals;
+  int* status;
+  char (*governors)[MAX_GOV_LEN];
+  core_state* prev;
+  core_state* cur;
+} monitor;
+
+static volatile sig_atomic_t running = 1;
+
+static void handle_signal(int sig) {
+  (void) sig;
+  running = 0;
+}
+
+static uint64_t now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t) ts.tv_sec * 1000000000ULL + (uint64_t) ts.tv_nsec;
+}
+
+static uint64_t cpu_time_ns(void) {
+  struct rusage ru;
+  if (getrusage(RUSAGE_SELF, &ru)) {
+    return 0;
+  }
+  return (uint64_t) (ru.ru_utime.tv_sec + ru.ru_stime.tv_sec) * 1000000000ULL +
+         (uint64_t) (ru.ru_utime.tv_usec + ru.ru_stime.tv_usec) * 1000ULL;
+}
+
+static void sleep_until(uint64_t ns) {
+  struct timespec ts;
+  ts.tv_sec = (time_t) (ns / 1000000000ULL);
+  ts.tv_nsec = (long) (ns % 1000000000ULL);
+  while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR && running);
+}
+
+static void monitor_free(monitor* m) {
+  free(m->srcs);
+  free(m->core_src);
+  free(m->vals);
+  free(m->status);
+  free(m->governors);
+  free(m->prev);
+  free(m->cur);
+}
+
+// read each policy once through its first monitored core
+static void monitor_plan(monitor* m) {
+  uint32_t nctx = cpufreq_bindings_ctx_get_ncores(m->ctx);
+  uint32_t* policy_src;
+  uint32_t policy;
+  uint32_t i;
+  m->nsrcs = 0;
+  // policies are named after a member core, so their IDs are usually < the context's cores
+  if ((policy_src = malloc(nctx * sizeof(uint32_t))) != NULL) {
+    memset(policy_src, 0xff, nctx * sizeof(uint32_t));
+  }
+  for (i = 0; i < m->ncores; i++) {
+    if (policy_src != NULL && !cpufreq_bindings_ctx_get_core_policy(m->ctx, m->cores[i], &policy) && policy < nctx) {
+      if (policy_src[policy] == UINT32_MAX) {
+        policy_src[policy] = m->nsrcs;
+        m->srcs[m->nsrcs++] = m->cores[i];
+      }
+      m->core_src[i] = policy_src[policy];
+    } else {
+      m->core_src[i] = m->nsrcs;
+      m->srcs[m->nsrcs++] = m->cores[i];
+    }
+  }
+  free(policy_src);
+}
+
+static int monitor_init(monitor* m, const uint32_t* cores, uint32_t ncores) {
+  memset(m, 0, sizeof(*m));
+  m->cores = cores;
+  m->ncores = ncores;
+  m->srcs = malloc(ncores * sizeof(uint32_t));
+  m->core_src = malloc(ncores * sizeof(uint32_t));
+  m->vals = malloc((size_t) ncores * MONITOR_FILE_COUNT * sizeof(uint32_t));
+  m->status = malloc((size_t) ncores * MONITOR_FILE_COUNT * sizeof(int));
+  m->governors = malloc(ncores * sizeof(*m->governors));
+  m->prev = calloc(ncores, sizeof(core_state));
+  m->cur = calloc(ncores, sizeof(core_state));
+  if (m->srcs == NULL || m->core_src == NULL || m->vals == NULL || m->status == NULL || m->governors == NULL ||
+      m->prev == NULL || m->cur == NULL) {
+    monitor_free(m);
+    return -1;
+  }
+  // cores are sorted, so the last is the highest
+  if ((m->ctx = cpufreq_bindings_ctx_init(cores[ncores - 1] + 1)) == NULL) {
+    monitor_free(m);
+    return -1;
+  }
+  monitor_plan(m);
+  return 0;
+}
+
+static void monitor_sample(monitor* m) {
+  core_state* st;
+  uint32_t src;
+  uint32_t core;
+  uint32_t i;
+  // file descriptors are cached by the context, and the batch uses io_uring when available
+  cpufreq_bindings_ctx_get_u32_batch_multi(m->ctx, MONITOR_FILES, MONITOR_FILE_COUNT, m->srcs, m->nsrcs, m->vals,
+                                           m->status);
+  for (src = 0; src < m->nsrcs; src++) {
+    memset(m->governors[src], 0, sizeof(m->governors[src]));
+    if (cpufreq_bindings_ctx_get_scaling_governor(m->ctx, m->srcs[src], m->governors[src],
+                                                  sizeof(m->governors[src]) - 1) <= 0) {
+      m->governors[src][0] = '\0';
+    }
+  }
+  for (core = 0; core < m->ncores; core++) {
+    st = &m->cur[core];
+    src = m->core_src[core];
+    for (i = 0; i < MONITOR_FILE_COUNT; i++) {
+      st->vals[i] = m->status[src * MONITOR_FILE_COUNT + i] ? 0 : m->vals[src * MONITOR_FILE_COUNT + i];
+    }
+    memcpy(st->governor, m->governors[src], sizeof(st->governor));
+  }
+}
+
+static int state_changed(const core_state* a, const core_state* b) {
+  return memcmp(a->vals, b->vals, sizeof(a->vals)) || strcmp(a->governor, b->governor);
+}
+
+static void print_u32(uint32_t val, int csv) {
+  if (csv) {
+    if (val > 0) {
+      printf(",%"PRIu32, val);
+    } else {
+      printf(",");
+    }
+  } else if (val > 0) {
+    printf(" %10"PRIu32, val);
+  } else {
+    printf(" %10s", "-");
+  }
+}
+
+static void print_core(const core_state* st, uint32_t core, double time_ms, double self_pct, int csv) {
+  uint32_t i;
+  if (csv) {
+    printf("%.3f,%"PRIu32, time_ms, core);
+  } else {
+    printf("  %5"PRIu32, core);
+  }
+  for (i = 0; i < MONITOR_FILE_COUNT; i++) {
+    print_u32(st->vals[i], csv);
+  }
+  if (csv) {
+    printf(",%s,%.4f\n", st->governor, self_pct);
+  } else {
+    printf(" %s\n", st->governor[0] == '\0' ? "-" : st->governor);
+  }
+}
+
+static int run(const uint32_t* cores, uint32_t ncores, uint32_t interval_ms, uint32_t count, int every, int csv) {
+  monitor m;
+  core_state* tmp;
+  struct sigaction sa;
+  uint64_t start;
+  uint64_t next;
+  uint64_t wall;
+  uint64_t wall_prev;
+  uint64_t cpu;
+  uint64_t cpu_prev;
+  double self_pct;
+  double time_ms;
+  uint32_t nchanged;
+  uint32_t core;
+  uint32_t n;
+  if (monitor_init(&m, cores, ncores)) {
+    perror("monitor_init");
+    return -errno;
+  }
+  memset(&sa, 0, sizeof(sa));
+  sa.sa_handler = handle_signal;
+  sigaction(SIGINT, &sa, NULL);
+  sigaction(SIGTERM, &sa, NULL);
+  if (csv) {
+    printf("time_ms,cpu,scaling_cur_freq,scaling_min_freq,scaling_max_freq,scaling_governor,self_cpu_pct\n");
+  } else {
+    printf("  %5s %10s %10s %10s %s\n", "cpu", "cur_freq", "min_freq", "max_freq", "governor");
+  }
+  start = now_ns();
+  next = start;
+  wall_prev = start;
+  cpu_prev = cpu_time_ns();
+  for (n = 0; running && (count == 0 || n < count); n++) {
+    monitor_sample(&m);
+    wall = now_ns();
+    cpu = cpu_time_ns();
+    // includes printing the previous sample
+    self_pct = wall > wall_prev ? 100.0 * (double) (cpu - cpu_prev) / (double) (wall - wall_prev) : 0;
+    wall_prev = wall;
+    cpu_prev = cpu;
+    time_ms = (wall - start) / 1000000.0;
+    nchanged = 0;
+    for (core = 0; core < ncores; core++) {
+      if (n == 0 || every || state_changed(&m.cur[core], &m.prev[core])) {
+        nchanged++;
+      }
+    }
+    if (!csv) {
+      printf("[%12.3f ms] %"PRIu32"/%"PRIu32" cores %s, self %.4f%% cpu\n", time_ms, nchanged, ncores,
+             every ? "sampled" : "changed", self_pct);
+    }
+    for (core = 0; core < ncores; core++) {
+      if (n == 0 || every || state_changed(&m.cur[core], &m.prev[core])) {
+        print_core(&m.cur[core], cores[core], time_ms, self_pct, csv);
+      }
+    }
+    fflush(stdout);
+    tmp = m.prev;
+    m.prev = m.cur;
+    m.cur = tmp;
+    next += (uint64_t) interval_ms * 1000000ULL;
+    if (count == 0 || n + 1 < count) {
+      sleep_until(next);
+    }
+  }
+  cpufreq_bindings_ctx_destroy(m.ctx);
+  monitor_free(&m);
+  return 0;
+}
+
+static const char short_options[] = "hi:c:n:eCr:";
+static const struct option long_options[] = {
+  {"help",                no_argument,        NULL, 'h'},
+  {"interval",            required_argument,  NULL, 'i'},
+  {"cpus",                required_argument,  NULL, 'c'},
+  {"count",               required_argument,  NULL, 'n'},
+  {"every",               no_argument,        NULL, 'e'},
+  {"csv",                 no_argument,        NULL, 'C'},
+  {"root",                required_argument,  NULL, 'r'},
+  {0, 0, 0, 0}
+};
+
+static void print_usage(void) {
+  printf("Usage: cpufreq-bindings-monitor [OPTION]...\n");
+  printf("Options:\n");
+  printf("  -h, --help                   Print this message and exit\n");
+  printf("  -i, --interval=MS            The sampling interval in milliseconds (default is 1000)\n");
+  printf("  -c, --cpus=LIST              The processor cores to monitor, e.g., 0-3,8 (default is all configured)\n");
+  printf("  -n, --count=N                Stop after N samples (default is until interrupted)\n");
+  printf("  -e, --every                  Print every core each sample, not just the ones that changed\n");
+  printf("  -C, --csv                    Print results in CSV format\n");
+  printf("  -r, --root=DIR               The sysfs root (default is /sys)\n");
+}
+
+int main(int argc, char** argv) {
+  static uint32_t cores[MAX_CPUS];
+  long nconf = sysconf(_SC_NPROCESSORS_CONF);
+  uint32_t ncores = 0;
+  uint32_t interval_ms = 1000;
+  uint32_t count = 0;
+  int every = 0;
+  int csv = 0;
+  int c;
+  while ((c = getopt_long(argc, argv, short_options, long_options, NULL)) != -1) {
+    switch (c) {
+      case 'h':
+        print_usage();
+        return 0;
+      case 'i':
+        interval_ms = strtoul(optarg, NULL, 0);
+        break;
+      case 'c':
+        if ((ncores = cpufreq_bindings_parse_cpulist(optarg, cores, MAX_CPUS)) == 0) {
+          fprintf(stderr, "Invalid CPU list: %s\n", optarg);
+          return -EINVAL;
+        }
+        break;
+      case 'n':
+        count = strtoul(optarg, NULL, 0);
+        break;
+      case 'e':
+        every = 1;
+        break;
+      case 'C':
+        csv = 1;
+        break;
+      case 'r':
+        if (cpufreq_bindings_set_sysfs_root(optarg)) {
+          perror("cpufreq_bindings_set_sysfs_root");
+          return -errno;
+        }
+        break;
+      case '?':
+      default:
+        print_usage();
+        return -EINVAL;
+    }
+  }
+  if (ncores == 0) {
+    for (; ncores < MAX_CPUS && (long) ncores < nconf; ncores++) {
+      cores[ncores] = ncores;
+    }
+  }
+  if (ncores == 0 || interval_ms == 0) {
+    print_usage();
+    return -EINVAL;
+  }
+  return run(cores, ncores, interval_ms, count, every, csv);
+}
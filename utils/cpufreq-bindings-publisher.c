@@ -0,0 +1,157 @@
+/**
+ * Periodically publish cpufreq state to shared memory, or print a published table.
+ *
+ * @author Connor Imes
+ * @date 2026-10-15
+ */
+// for nanosleep, sigaction
+#define _POSIX_C_SOURCE 200809L
+#include <errno.h>
+#include <getopt.h>
+#include <inttypes.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "cpufreq-bindings.h"
+#include "cpufreq-bindings-shm.h"
+
+static volatile sig_atomic_t running = 1;
+
+static void handle_signal(int sig) {
+  (void) sig;
+  running = 0;
+}
+
+static int print_table(const char* name) {
+  cpufreq_bindings_shm_reader* reader;
+  cpufreq_bindings_shm_entry* entries;
+  uint64_t update_ns;
+  uint32_t ncores;
+  uint32_t i;
+  int ret = 0;
+  if ((reader = cpufreq_bindings_shm_reader_open(name)) == NULL) {
+    perror("cpufreq_bindings_shm_reader_open");
+    return -errno;
+  }
+  ncores = cpufreq_bindings_shm_reader_get_ncores(reader);
+  if ((entries = malloc(ncores * sizeof(cpufreq_bindings_shm_entry))) == NULL) {
+    ret = -errno;
+    perror("malloc");
+  } else if (cpufreq_bindings_shm_reader_snapshot(reader, entries, ncores, &update_ns) == 0) {
+    ret = -errno;
+    perror("cpufreq_bindings_shm_reader_snapshot");
+  } else {
+    printf("cpu,scaling_cur_freq,scaling_min_freq,scaling_max_freq,scaling_governor\n");
+    for (i = 0; i < ncores; i++) {
+      printf("%"PRIu32",%"PRIu32",%"PRIu32",%"PRIu32",%s\n", i, entries[i].scaling_cur_freq,
+             entries[i].scaling_min_freq, entries[i].scaling_max_freq, entries[i].scaling_governor);
+    }
+  }
+  free(entries);
+  cpufreq_bindings_shm_reader_close(reader);
+  return ret;
+}
+
+static int publish(const char* name, uint32_t ncores, uint32_t interval_ms, int unlink) {
+  cpufreq_bindings_ctx* ctx;
+  cpufreq_bindings_shm_publisher* pub;
+  struct sigaction sa;
+  struct timespec ts;
+  int ret = 0;
+  memset(&sa, 0, sizeof(sa));
+  sa.sa_handler = handle_signal;
+  sigaction(SIGINT, &sa, NULL);
+  sigaction(SIGTERM, &sa, NULL);
+  if ((ctx = cpufreq_bindings_ctx_init(ncores)) == NULL) {
+    perror("cpufreq_bindings_ctx_init");
+    return -errno;
+  }
+  if ((pub = cpufreq_bindings_shm_publisher_init(name, ctx, ncores)) == NULL) {
+    ret = -errno;
+    perror("cpufreq_bindings_shm_publisher_init");
+    cpufreq_bindings_ctx_destroy(ctx);
+    return ret;
+  }
+  ts.tv_sec = interval_ms / 1000;
+  ts.tv_nsec = (long) (interval_ms % 1000) * 1000000L;
+  while (running) {
+    if (cpufreq_bindings_shm_publisher_update(pub) == 0) {
+      perror("cpufreq_bindings_shm_publisher_update");
+    }
+    nanosleep(&ts, NULL);
+  }
+  if (cpufreq_bindings_shm_publisher_destroy(pub, unlink)) {
+    ret = -errno;
+  }
+  cpufreq_bindings_ctx_destroy(ctx);
+  return ret;
+}
+
+static const char short_options[] = "hn:i:N:up";
+static const struct option long_options[] = {
+  {"help",                no_argument,        NULL, 'h'},
+  {"name",                required_argument,  NULL, 'n'},
+  {"interval",            required_argument,  NULL, 'i'},
+  {"ncpus",               required_argument,  NULL, 'N'},
+  {"unlink",              no_argument,        NULL, 'u'},
+  {"print",               no_argument,        NULL, 'p'},
+  {0, 0, 0, 0}
+};
+
+static void print_usage(void) {
+  printf("Usage: cpufreq-bindings-publisher [OPTION]...\n");
+  printf("Options:\n");
+  printf("  -h, --help                   Print this message and exit\n");
+  printf("  -n, --name=NAME              The shared memory object name (default is %s)\n",
+         CPUFREQ_BINDINGS_SHM_DEFAULT_NAME);
+  printf("  -i, --interval=MS            The update interval in milliseconds (default is 100)\n");
+  printf("  -N, --ncpus=N                The number of processor cores to publish (default is all configured)\n");
+  printf("  -u, --unlink                 Remove the shared memory object on exit\n");
+  printf("  -p, --print                  Print a published table as CSV and exit\n");
+}
+
+int main(int argc, char** argv) {
+  const char* name = CPUFREQ_BINDINGS_SHM_DEFAULT_NAME;
+  long ncores = sysconf(_SC_NPROCESSORS_CONF);
+  uint32_t interval_ms = 100;
+  int unlink = 0;
+  int print = 0;
+  int c;
+  while ((c = getopt_long(argc, argv, short_options, long_options, NULL)) != -1) {
+    switch (c) {
+      case 'h':
+        print_usage();
+        return 0;
+      case 'n':
+        name = optarg;
+        break;
+      case 'i':
+        interval_ms = strtoul(optarg, NULL, 0);
+        break;
+      case 'N':
+        ncores = atol(optarg);
+        break;
+      case 'u':
+        unlink = 1;
+        break;
+      case 'p':
+        print = 1;
+        break;
+      case '?':
+      default:
+        print_usage();
+        return -EINVAL;
+    }
+  }
+  if (print) {
+    return print_table(name);
+  }
+  if (ncores <= 0 || interval_ms == 0) {
+    print_usage();
+    return -EINVAL;
+  }
+  return publish(name, (uint32_t) ncores, interval_ms, unlink);
+}
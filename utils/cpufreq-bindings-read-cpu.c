@@ -1,121 +1,483 @@
 /**
- * Read all the cpufreq files for a core.
+ * Read all the cpufreq files for one or more cores.
  *
  * @author Connor Imes
  * @date 2017-03-16
  */
+// for clock_gettime, clock_nanosleep, sigaction
+#define _POSIX_C_SOURCE 200809L
+#include <ctype.h>
+#include <dirent.h>
 #include <errno.h>
 #include <getopt.h>
 #include <inttypes.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdarg.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
+#include <unistd.h>
 #include "cpufreq-bindings.h"
 
 #define MAX_CPUS 1024
 #define MAX_FREQS 32
 #define MAX_GOVS 16
 #define MAX_GOV_LEN 32
+#define MAX_THREADS 16
 
-static void print_or_perror_str(ssize_t bytes, const char* buf, const char* name) {
-  if (bytes > 0) {
-    printf("%s: %s\n", name, buf);
-  } else {
-    perror(name);
+typedef enum output_format {
+  FORMAT_TEXT,
+  FORMAT_CSV,
+  FORMAT_JSON
+} output_format;
+
+// a growable output buffer, so cores can be read in parallel and printed in order
+typedef struct strbuf {
+  char* buf;
+  size_t len;
+  size_t cap;
+} strbuf;
+
+typedef struct record {
+  strbuf* out;
+  // errors are kept separate in text mode, which prints them to stderr
+  strbuf* err;
+  output_format format;
+} record;
+
+typedef struct cpu_reader {
+  cpufreq_bindings_ctx* ctx;
+  const uint32_t* cores;
+  uint32_t ncores;
+  output_format format;
+  strbuf* outs;
+  strbuf* errs;
+  uint32_t next;
+} cpu_reader;
+
+static volatile sig_atomic_t running = 1;
+
+static void handle_signal(int sig) {
+  (void) sig;
+  running = 0;
+}
+
+#if defined(__GNUC__)
+__attribute__((format(printf, 2, 3)))
+#endif
+static void sb_printf(strbuf* sb, const char* fmt, ...) {
+  va_list ap;
+  size_t cap;
+  char* buf;
+  int n;
+  for (;;) {
+    va_start(ap, fmt);
+    n = vsnprintf(sb->buf == NULL ? NULL : sb->buf + sb->len, sb->cap - sb->len, fmt, ap);
+    va_end(ap);
+    if (n < 0) {
+      return;
+    }
+    if ((size_t) n < sb->cap - sb->len) {
+      sb->len += (size_t) n;
+      return;
+    }
+    cap = sb->cap == 0 ? 256 : sb->cap;
+    while (cap - sb->len <= (size_t) n) {
+      cap *= 2;
+    }
+    if ((buf = realloc(sb->buf, cap)) == NULL) {
+      // drop the output rather than fail the whole read
+      return;
+    }
+    sb->buf = buf;
+    sb->cap = cap;
   }
 }
 
-static void print_or_perror_strarr(char arr[][MAX_GOV_LEN], uint32_t len, const char* name) {
-  uint32_t i;
-  if (len > 0) {
-    printf("%s: ", name);
-    for (i = 0; i < len; i++) {
-      printf("%s ", arr[i]);
+static void sb_write(const strbuf* sb, FILE* f) {
+  if (sb->len > 0) {
+    fwrite(sb->buf, 1, sb->len, f);
+  }
+}
+
+static void field_begin(record* r, const char* name) {
+  switch (r->format) {
+    case FORMAT_TEXT:
+      sb_printf(r->out, "%s: ", name);
+      break;
+    case FORMAT_CSV:
+      sb_printf(r->out, ",");
+      break;
+    case FORMAT_JSON:
+      sb_printf(r->out, ",\"%s\":", name);
+      break;
+  }
+}
+
+static void field_error(record* r, const char* name) {
+  switch (r->format) {
+    case FORMAT_TEXT:
+      sb_printf(r->err, "%s: %s\n", name, strerror(errno));
+      break;
+    case FORMAT_CSV:
+      sb_printf(r->out, ",");
+      break;
+    case FORMAT_JSON:
+      sb_printf(r->out, ",\"%s\":null", name);
+      break;
+  }
+}
+
+static void field_end(record* r) {
+  if (r->format == FORMAT_TEXT) {
+    sb_printf(r->out, "\n");
+  }
+}
+
+// separator between array elements
+static const char* elem_sep(const record* r, uint32_t i) {
+  if (r->format == FORMAT_TEXT) {
+    return "";
+  }
+  return i == 0 ? "" : r->format == FORMAT_JSON ? "," : " ";
+}
+
+static void put_str_value(record* r, const char* str) {
+  const char* c;
+  if (r->format != FORMAT_JSON) {
+    sb_printf(r->out, "%s", str);
+    return;
+  }
+  sb_printf(r->out, "\"");
+  for (c = str; *c != '\0'; c++) {
+    if (*c == '"' || *c == '\\') {
+      sb_printf(r->out, "\\%c", *c);
+    } else if (iscntrl((unsigned char) *c)) {
+      sb_printf(r->out, "\\u%04x", (unsigned int) (unsigned char) *c);
+    } else {
+      sb_printf(r->out, "%c", *c);
     }
-    printf("\n");
-  } else {
-    perror(name);
   }
+  sb_printf(r->out, "\"");
 }
 
-static void print_or_perror_u32(uint32_t u32_val, const char* name) {
-  if (u32_val > 0) {
-    printf("%s: %"PRIu32"\n", name, u32_val);
-  } else {
-    perror(name);
+static void put_str(record* r, ssize_t bytes, const char* buf, const char* name) {
+  if (bytes <= 0) {
+    field_error(r, name);
+    return;
   }
+  field_begin(r, name);
+  put_str_value(r, buf);
+  field_end(r);
 }
 
-static void print_or_perror_u32arr(uint32_t* arr, uint32_t len, const char* name) {
+static void put_strarr(record* r, char arr[][MAX_GOV_LEN], uint32_t len, const char* name) {
   uint32_t i;
-  if (len > 0) {
-    printf("%s: ", name);
-    for (i = 0; i < len; i++) {
-      printf("%"PRIu32" ", arr[i]);
+  if (len == 0) {
+    field_error(r, name);
+    return;
+  }
+  field_begin(r, name);
+  if (r->format == FORMAT_JSON) {
+    sb_printf(r->out, "[");
+  }
+  for (i = 0; i < len; i++) {
+    sb_printf(r->out, "%s", elem_sep(r, i));
+    put_str_value(r, arr[i]);
+    if (r->format == FORMAT_TEXT) {
+      sb_printf(r->out, " ");
     }
-    printf("\n");
-  } else {
-    perror(name);
   }
+  if (r->format == FORMAT_JSON) {
+    sb_printf(r->out, "]");
+  }
+  field_end(r);
 }
 
-static void print_cpu(uint32_t core, const int* fds) {
-  char buf[2014];
+static void put_u32(record* r, uint32_t u32_val, const char* name) {
+  if (u32_val == 0) {
+    field_error(r, name);
+    return;
+  }
+  field_begin(r, name);
+  sb_printf(r->out, "%"PRIu32, u32_val);
+  field_end(r);
+}
+
+static void put_u32arr(record* r, const uint32_t* arr, uint32_t len, const char* name) {
+  uint32_t i;
+  if (len == 0) {
+    field_error(r, name);
+    return;
+  }
+  field_begin(r, name);
+  if (r->format == FORMAT_JSON) {
+    sb_printf(r->out, "[");
+  }
+  for (i = 0; i < len; i++) {
+    sb_printf(r->out, r->format == FORMAT_TEXT ? "%s%"PRIu32" " : "%s%"PRIu32, elem_sep(r, i), arr[i]);
+  }
+  if (r->format == FORMAT_JSON) {
+    sb_printf(r->out, "]");
+  }
+  field_end(r);
+}
+
+static void read_cpu(cpufreq_bindings_ctx* ctx, uint32_t core, record* r) {
+  char buf[256];
   char governors[MAX_GOVS][MAX_GOV_LEN];
   uint32_t freqs[MAX_FREQS];
   uint32_t cpu_aff_rel[MAX_CPUS];
   uint32_t u32_val;
   ssize_t bytes;
 
-  u32_val = cpufreq_bindings_get_affected_cpus(fds[CPUFREQ_BINDINGS_FILE_AFFECTED_CPUS], core, cpu_aff_rel, MAX_CPUS);
-  print_or_perror_u32arr(cpu_aff_rel, u32_val, "affected_cpus");
+  u32_val = cpufreq_bindings_ctx_get_affected_cpus(ctx, core, cpu_aff_rel, MAX_CPUS);
+  put_u32arr(r, cpu_aff_rel, u32_val, "affected_cpus");
+
+  u32_val = cpufreq_bindings_ctx_get_bios_limit(ctx, core);
+  put_u32(r, u32_val, "bios_limit");
+
+  u32_val = cpufreq_bindings_ctx_get_cpuinfo_cur_freq(ctx, core);
+  put_u32(r, u32_val, "cpuinfo_cur_freq");
+
+  u32_val = cpufreq_bindings_ctx_get_cpuinfo_max_freq(ctx, core);
+  put_u32(r, u32_val, "cpuinfo_max_freq");
+
+  u32_val = cpufreq_bindings_ctx_get_cpuinfo_min_freq(ctx, core);
+  put_u32(r, u32_val, "cpuinfo_min_freq");
+
+  u32_val = cpufreq_bindings_ctx_get_cpuinfo_transition_latency(ctx, core);
+  put_u32(r, u32_val, "cpuinfo_transition_latency");
+
+  u32_val = cpufreq_bindings_ctx_get_related_cpus(ctx, core, cpu_aff_rel, MAX_CPUS);
+  put_u32arr(r, cpu_aff_rel, u32_val, "related_cpus");
+
+  u32_val = cpufreq_bindings_ctx_get_scaling_available_frequencies(ctx, core, freqs, MAX_FREQS);
+  put_u32arr(r, freqs, u32_val, "scaling_available_frequencies");
+
+  u32_val = cpufreq_bindings_ctx_get_scaling_available_governors(ctx, core, governors[0], MAX_GOVS, MAX_GOV_LEN);
+  put_strarr(r, governors, u32_val, "scaling_available_governors");
+
+  u32_val = cpufreq_bindings_ctx_get_scaling_cur_freq(ctx, core);
+  put_u32(r, u32_val, "scaling_cur_freq");
+
+  bytes = cpufreq_bindings_ctx_get_scaling_driver(ctx, core, buf, sizeof(buf));
+  put_str(r, bytes, buf, "scaling_driver");
 
-  u32_val = cpufreq_bindings_get_bios_limit(fds[CPUFREQ_BINDINGS_FILE_BIOS_LIMIT], core);
-  print_or_perror_u32(u32_val, "bios_limit");
+  bytes = cpufreq_bindings_ctx_get_scaling_governor(ctx, core, buf, sizeof(buf));
+  put_str(r, bytes, buf, "scaling_governor");
 
-  u32_val = cpufreq_bindings_get_cpuinfo_cur_freq(fds[CPUFREQ_BINDINGS_FILE_CPUINFO_CUR_FREQ], core);
-  print_or_perror_u32(u32_val, "cpuinfo_cur_freq");
+  u32_val = cpufreq_bindings_ctx_get_scaling_max_freq(ctx, core);
+  put_u32(r, u32_val, "scaling_max_freq");
 
-  u32_val = cpufreq_bindings_get_cpuinfo_max_freq(fds[CPUFREQ_BINDINGS_FILE_CPUINFO_MAX_FREQ], core);
-  print_or_perror_u32(u32_val, "cpuinfo_max_freq");
+  u32_val = cpufreq_bindings_ctx_get_scaling_min_freq(ctx, core);
+  put_u32(r, u32_val, "scaling_min_freq");
+}
 
-  u32_val = cpufreq_bindings_get_cpuinfo_min_freq(fds[CPUFREQ_BINDINGS_FILE_CPUINFO_MIN_FREQ], core);
-  print_or_perror_u32(u32_val, "cpuinfo_min_freq");
+static const char* CSV_HEADER = "time_ms,cpu,affected_cpus,bios_limit,cpuinfo_cur_freq,cpuinfo_max_freq,"
+  "cpuinfo_min_freq,cpuinfo_transition_latency,related_cpus,scaling_available_frequencies,"
+  "scaling_available_governors,scaling_cur_freq,scaling_driver,scaling_governor,scaling_max_freq,scaling_min_freq\n";
 
-  u32_val = cpufreq_bindings_get_cpuinfo_transition_latency(fds[CPUFREQ_BINDINGS_FILE_CPUINFO_TRANSITION_LATENCY], core);
-  print_or_perror_u32(u32_val, "cpuinfo_transition_latency");
+static void* reader_thread(void* arg) {
+  cpu_reader* rd = arg;
+  record r;
+  uint32_t i;
+  while ((i = __atomic_fetch_add(&rd->next, 1, __ATOMIC_RELAXED)) < rd->ncores) {
+    r.out = &rd->outs[i];
+    r.err = &rd->errs[i];
+    r.format = rd->format;
+    r.out->len = 0;
+    r.err->len = 0;
+    // the CSV time column and the JSON object's opening are written by the caller
+    if (rd->format == FORMAT_CSV) {
+      sb_printf(r.out, ",%"PRIu32, rd->cores[i]);
+    } else if (rd->format == FORMAT_JSON) {
+      sb_printf(r.out, "{\"cpu\":%"PRIu32, rd->cores[i]);
+    }
+    read_cpu(rd->ctx, rd->cores[i], &r);
+    if (rd->format == FORMAT_CSV) {
+      sb_printf(r.out, "\n");
+    } else if (rd->format == FORMAT_JSON) {
+      sb_printf(r.out, "}");
+    }
+  }
+  return NULL;
+}
 
-  u32_val = cpufreq_bindings_get_related_cpus(fds[CPUFREQ_BINDINGS_FILE_RELATED_CPUS], core, cpu_aff_rel, MAX_CPUS);
-  print_or_perror_u32arr(cpu_aff_rel, u32_val, "related_cpus");
+// read all cores, using the calling thread and up to "nthreads" - 1 more
+static void read_cpus(cpu_reader* rd, uint32_t nthreads) {
+  pthread_t threads[MAX_THREADS];
+  uint32_t nstarted;
+  uint32_t i;
+  rd->next = 0;
+  for (nstarted = 0; nstarted + 1 < nthreads; nstarted++) {
+    if ((errno = pthread_create(&threads[nstarted], NULL, reader_thread, rd))) {
+      perror("pthread_create");
+      break;
+    }
+  }
+  reader_thread(rd);
+  for (i = 0; i < nstarted; i++) {
+    pthread_join(threads[i], NULL);
+  }
+}
 
-  u32_val = cpufreq_bindings_get_scaling_available_frequencies(fds[CPUFREQ_BINDINGS_FILE_SCALING_AVAILABLE_FREQUENCIES],
-                                                               core, freqs, MAX_FREQS);
-  print_or_perror_u32arr(freqs, u32_val, "scaling_available_frequencies");
+static void print_snapshot(const cpu_reader* rd, double time_ms, int headers) {
+  uint32_t i;
+  if (rd->format == FORMAT_JSON) {
+    printf("{\"time_ms\":%.3f,\"cpus\":[", time_ms);
+  } else if (rd->format == FORMAT_TEXT && headers) {
+    printf("time_ms: %.3f\n", time_ms);
+  }
+  for (i = 0; i < rd->ncores; i++) {
+    if (rd->format == FORMAT_JSON) {
+      printf(i == 0 ? "" : ",");
+    } else if (rd->format == FORMAT_CSV) {
+      printf("%.3f", time_ms);
+    } else if (headers || rd->ncores > 1) {
+      printf("[cpu %"PRIu32"]\n", rd->cores[i]);
+    }
+    fflush(stdout);
+    sb_write(&rd->outs[i], stdout);
+    sb_write(&rd->errs[i], stderr);
+  }
+  if (rd->format == FORMAT_JSON) {
+    printf("]}\n");
+  }
+  fflush(stdout);
+}
 
-  u32_val = cpufreq_bindings_get_scaling_available_governors(fds[CPUFREQ_BINDINGS_FILE_SCALING_AVAILABLE_GOVERNORS],
-                                                             core, governors[0], MAX_GOVS, MAX_GOV_LEN);
-  print_or_perror_strarr(governors, u32_val, "scaling_available_governors");
+static uint64_t now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t) ts.tv_sec * 1000000000ULL + (uint64_t) ts.tv_nsec;
+}
 
-  u32_val = cpufreq_bindings_get_scaling_cur_freq(fds[CPUFREQ_BINDINGS_FILE_SCALING_CUR_FREQ], core);
-  print_or_perror_u32(u32_val, "scaling_cur_freq");
+static void sleep_until(uint64_t ns) {
+  struct timespec ts;
+  ts.tv_sec = (time_t) (ns / 1000000000ULL);
+  ts.tv_nsec = (long) (ns % 1000000000ULL);
+  while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR && running);
+}
 
-  bytes = cpufreq_bindings_get_scaling_driver(fds[CPUFREQ_BINDINGS_FILE_SCALING_DRIVER], core, buf, sizeof(buf));
-  print_or_perror_str(bytes, buf, "scaling_driver");
+static int cmp_u32(const void* a, const void* b) {
+  uint32_t x = *(const uint32_t*) a;
+  uint32_t y = *(const uint32_t*) b;
+  return x < y ? -1 : x > y ? 1 : 0;
+}
 
-  bytes = cpufreq_bindings_get_scaling_governor(fds[CPUFREQ_BINDINGS_FILE_SCALING_GOVERNOR], core, buf, sizeof(buf));
-  print_or_perror_str(bytes, buf, "scaling_governor");
+// find every "cpuN" directory in the sysfs tree; returns the number of cores, or 0 on failure
+static uint32_t find_all_cpus(uint32_t* cores, uint32_t len) {
+  char path[512];
+  struct dirent* entry;
+  DIR* dir;
+  char* end;
+  uint32_t n = 0;
+  unsigned long core;
+  snprintf(path, sizeof(path), "%s/devices/system/cpu", cpufreq_bindings_get_sysfs_root());
+  if ((dir = opendir(path)) == NULL) {
+    perror(path);
+    return 0;
+  }
+  while ((entry = readdir(dir)) != NULL && n < len) {
+    if (strncmp(entry->d_name, "cpu", 3) || !isdigit((unsigned char) entry->d_name[3])) {
+      continue;
+    }
+    core = strtoul(&entry->d_name[3], &end, 10);
+    if (*end == '\0') {
+      cores[n++] = (uint32_t) core;
+    }
+  }
+  closedir(dir);
+  qsort(cores, n, sizeof(uint32_t), cmp_u32);
+  if (n == 0) {
+    errno = ENOENT;
+    perror(path);
+  }
+  return n;
+}
 
-  u32_val = cpufreq_bindings_get_scaling_max_freq(fds[CPUFREQ_BINDINGS_FILE_SCALING_MAX_FREQ], core);
-  print_or_perror_u32(u32_val, "scaling_max_freq");
+static int run(const uint32_t* cores, uint32_t ncores, output_format format, uint32_t nthreads,
+               uint32_t interval_ms, uint32_t count) {
+  cpu_reader rd;
+  struct sigaction sa;
+  uint64_t start;
+  uint64_t next;
+  uint32_t max_core = 0;
+  uint32_t i;
+  uint32_t n;
+  int ret = 0;
+  for (i = 0; i < ncores; i++) {
+    if (cores[i] > max_core) {
+      max_core = cores[i];
+    }
+  }
+  memset(&rd, 0, sizeof(rd));
+  rd.cores = cores;
+  rd.ncores = ncores;
+  rd.format = format;
+  rd.outs = calloc(ncores, sizeof(strbuf));
+  rd.errs = calloc(ncores, sizeof(strbuf));
+  if (rd.outs == NULL || rd.errs == NULL) {
+    ret = -errno;
+    perror("calloc");
+    goto out;
+  }
+  // file descriptors stay open for the whole run
+  if ((rd.ctx = cpufreq_bindings_ctx_init(max_core + 1)) == NULL) {
+    ret = -errno;
+    perror("cpufreq_bindings_ctx_init");
+    goto out;
+  }
+  if (interval_ms > 0) {
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = handle_signal;
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+  }
+  if (format == FORMAT_CSV) {
+    printf("%s", CSV_HEADER);
+  }
+  start = now_ns();
+  next = start;
+  for (n = 0; running && (count == 0 || n < count); n++) {
+    read_cpus(&rd, nthreads);
+    print_snapshot(&rd, (now_ns() - start) / 1000000.0, interval_ms > 0);
+    if (interval_ms == 0) {
+      break;
+    }
+    next += (uint64_t) interval_ms * 1000000ULL;
+    if (count == 0 || n + 1 < count) {
+      sleep_until(next);
+    }
+  }
+  cpufreq_bindings_ctx_destroy(rd.ctx);
 
-  u32_val = cpufreq_bindings_get_scaling_min_freq(fds[CPUFREQ_BINDINGS_FILE_SCALING_MIN_FREQ], core);
-  print_or_perror_u32(u32_val, "scaling_min_freq");
+out:
+  for (i = 0; rd.outs != NULL && i < ncores; i++) {
+    free(rd.outs[i].buf);
+  }
+  for (i = 0; rd.errs != NULL && i < ncores; i++) {
+    free(rd.errs[i].buf);
+  }
+  free(rd.outs);
+  free(rd.errs);
+  return ret;
 }
 
-static const char short_options[] = "hc:";
+static const char short_options[] = "hc:al:f:i:n:t:r:";
 static const struct option long_options[] = {
   {"help",                no_argument,        NULL, 'h'},
   {"cpu",                 required_argument,  NULL, 'c'},
+  {"all",                 no_argument,        NULL, 'a'},
+  {"cpus",                required_argument,  NULL, 'l'},
+  {"format",              required_argument,  NULL, 'f'},
+  {"interval",            required_argument,  NULL, 'i'},
+  {"count",               required_argument,  NULL, 'n'},
+  {"threads",             required_argument,  NULL, 't'},
+  {"root",                required_argument,  NULL, 'r'},
   {0, 0, 0, 0}
 };
 
@@ -124,26 +486,104 @@ static void print_usage(void) {
   printf("Options:\n");
   printf("  -h, --help                   Print this message and exit\n");
   printf("  -c, --cpu=CPU                The processor core to read (default is 0)\n");
+  printf("  -a, --all                    Read all processor cores\n");
+  printf("  -l, --cpus=LIST              Read a list of processor cores, e.g., 0-3,8\n");
+  printf("  -f, --format=FORMAT          The output format: text, csv, or json (default is text)\n");
+  printf("  -i, --interval=MS            Repeat every MS milliseconds, keeping files open\n");
+  printf("  -n, --count=N                Stop after N snapshots with --interval (default is until interrupted)\n");
+  printf("  -t, --threads=N              The number of threads to read with (default is up to %d)\n", MAX_THREADS);
+  printf("  -r, --root=DIR               The sysfs root (default is /sys)\n");
 }
 
 int main(int argc, char** argv) {
+  output_format format = FORMAT_TEXT;
+  uint32_t* cores;
+  uint32_t ncores = 0;
   uint32_t core = 0;
-  int fds[CPUFREQ_BINDINGS_FILE_SCALING_SETSPEED + 1] = { 0 };
+  uint32_t interval_ms = 0;
+  uint32_t count = 0;
+  uint32_t nthreads = 0;
+  long nprocs;
+  int all = 0;
+  int ret;
   int c;
+  if ((cores = malloc(MAX_CPUS * sizeof(uint32_t))) == NULL) {
+    perror("malloc");
+    return -ENOMEM;
+  }
   while ((c = getopt_long(argc, argv, short_options, long_options, NULL)) != -1) {
     switch (c) {
       case 'h':
         print_usage();
+        free(cores);
         return 0;
       case 'c':
         core = atoi(optarg);
         break;
+      case 'a':
+        all = 1;
+        break;
+      case 'l':
+        if ((ncores = cpufreq_bindings_parse_cpulist(optarg, cores, MAX_CPUS)) == 0) {
+          print_usage();
+          free(cores);
+          return -EINVAL;
+        }
+        break;
+      case 'f':
+        if (!strcmp(optarg, "text")) {
+          format = FORMAT_TEXT;
+        } else if (!strcmp(optarg, "csv")) {
+          format = FORMAT_CSV;
+        } else if (!strcmp(optarg, "json")) {
+          format = FORMAT_JSON;
+        } else {
+          print_usage();
+          free(cores);
+          return -EINVAL;
+        }
+        break;
+      case 'i':
+        interval_ms = strtoul(optarg, NULL, 0);
+        break;
+      case 'n':
+        count = strtoul(optarg, NULL, 0);
+        break;
+      case 't':
+        nthreads = strtoul(optarg, NULL, 0);
+        break;
+      case 'r':
+        if (cpufreq_bindings_set_sysfs_root(optarg)) {
+          perror("cpufreq_bindings_set_sysfs_root");
+          free(cores);
+          return -errno;
+        }
+        break;
       case '?':
       default:
         print_usage();
+        free(cores);
         return -EINVAL;
     }
   }
-  print_cpu(core, fds);
-  return 0;
+  if (all && (ncores = find_all_cpus(cores, MAX_CPUS)) == 0) {
+    free(cores);
+    return -ENOENT;
+  }
+  if (ncores == 0) {
+    cores[ncores++] = core;
+  }
+  if (nthreads == 0) {
+    nprocs = sysconf(_SC_NPROCESSORS_ONLN);
+    nthreads = nprocs <= 0 ? 1 : nprocs > MAX_THREADS ? MAX_THREADS : (uint32_t) nprocs;
+  }
+  if (nthreads > MAX_THREADS) {
+    nthreads = MAX_THREADS;
+  }
+  if (nthreads > ncores) {
+    nthreads = ncores;
+  }
+  ret = run(cores, ncores, format, nthreads, interval_ms, count);
+  free(cores);
+  return ret;
 }
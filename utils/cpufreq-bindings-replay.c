@@ -0,0 +1,348 @@
+/**
+ * Replay a binary trace of writes recorded with cpufreq-bindings-trace.h, reporting how far the replay drifted from
+ * the recorded schedule.
+ *
+ * @author Connor Imes
+ * @date 2026-10-15
+ */
+// for clock_nanosleep
+#define _POSIX_C_SOURCE 200809L
+#include <errno.h>
+#include <getopt.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/prctl.h>
+#include <time.h>
+#include "cpufreq-bindings.h"
+#include "cpufreq-bindings-trace.h"
+
+// time to open files before the first write
+#define LEAD_NS 10000000ULL
+
+// more than the number of cpufreq_bindings_file values
+#define MAX_FILES 32
+
+typedef struct replay_stats {
+  uint64_t written;
+  uint64_t failed;
+  uint64_t skipped;
+  // per write, how late it was issued
+  uint64_t* drifts;
+  uint64_t max_write_ns;
+} replay_stats;
+
+static uint64_t now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t) ts.tv_sec * 1000000000ULL + (uint64_t) ts.tv_nsec;
+}
+
+// sleep until "spin_ns" before the deadline, then busy-wait the rest, which is more precise than sleeping
+static void wait_until(uint64_t deadline_ns, uint64_t spin_ns) {
+  struct timespec ts;
+  if (deadline_ns > spin_ns && now_ns() < deadline_ns - spin_ns) {
+    ts.tv_sec = (time_t) ((deadline_ns - spin_ns) / 1000000000ULL);
+    ts.tv_nsec = (long) ((deadline_ns - spin_ns) % 1000000000ULL);
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR);
+  }
+  while (now_ns() < deadline_ns);
+}
+
+static const char* file_name(uint16_t file) {
+  switch (file) {
+    case CPUFREQ_BINDINGS_FILE_SCALING_GOVERNOR:
+      return "scaling_governor";
+    case CPUFREQ_BINDINGS_FILE_SCALING_MAX_FREQ:
+      return "scaling_max_freq";
+    case CPUFREQ_BINDINGS_FILE_SCALING_MIN_FREQ:
+      return "scaling_min_freq";
+    case CPUFREQ_BINDINGS_FILE_SCALING_SETSPEED:
+      return "scaling_setspeed";
+    case CPUFREQ_BINDINGS_FILE_ENERGY_PERFORMANCE_PREFERENCE:
+      return "energy_performance_preference";
+    case CPUFREQ_BINDINGS_FILE_BOOST:
+      return "boost";
+    case CPUFREQ_BINDINGS_FILE_INTEL_PSTATE_MAX_PERF_PCT:
+      return "intel_pstate/max_perf_pct";
+    case CPUFREQ_BINDINGS_FILE_INTEL_PSTATE_MIN_PERF_PCT:
+      return "intel_pstate/min_perf_pct";
+    case CPUFREQ_BINDINGS_FILE_INTEL_PSTATE_NO_TURBO:
+      return "intel_pstate/no_turbo";
+    default:
+      return NULL;
+  }
+}
+
+// returns 0 on success, an errno value on failure, or -1 if the record can't be replayed
+static int write_record(int fd, const cpufreq_bindings_trace_record* r) {
+  ssize_t ret;
+  if (r->type == CPUFREQ_BINDINGS_TRACE_STR) {
+    if (r->len > CPUFREQ_BINDINGS_TRACE_STR_LEN) {
+      return -1;
+    }
+    switch (r->file) {
+      case CPUFREQ_BINDINGS_FILE_SCALING_GOVERNOR:
+        ret = cpufreq_bindings_set_scaling_governor(fd, r->core, r->value.str, r->len);
+        break;
+      case CPUFREQ_BINDINGS_FILE_ENERGY_PERFORMANCE_PREFERENCE:
+        ret = cpufreq_bindings_set_energy_performance_preference(fd, r->core, r->value.str, r->len);
+        break;
+      default:
+        return -1;
+    }
+  } else {
+    switch (r->file) {
+      case CPUFREQ_BINDINGS_FILE_SCALING_MAX_FREQ:
+        ret = cpufreq_bindings_set_scaling_max_freq(fd, r->core, r->value.u32);
+        break;
+      case CPUFREQ_BINDINGS_FILE_SCALING_MIN_FREQ:
+        ret = cpufreq_bindings_set_scaling_min_freq(fd, r->core, r->value.u32);
+        break;
+      case CPUFREQ_BINDINGS_FILE_SCALING_SETSPEED:
+        ret = cpufreq_bindings_set_scaling_setspeed(fd, r->core, r->value.u32);
+        break;
+      case CPUFREQ_BINDINGS_FILE_BOOST:
+        ret = cpufreq_bindings_set_boost(fd, r->value.u32);
+        break;
+      case CPUFREQ_BINDINGS_FILE_INTEL_PSTATE_MAX_PERF_PCT:
+        ret = cpufreq_bindings_set_intel_pstate_max_perf_pct(fd, r->value.u32);
+        break;
+      case CPUFREQ_BINDINGS_FILE_INTEL_PSTATE_MIN_PERF_PCT:
+        ret = cpufreq_bindings_set_intel_pstate_min_perf_pct(fd, r->value.u32);
+        break;
+      case CPUFREQ_BINDINGS_FILE_INTEL_PSTATE_NO_TURBO:
+        ret = cpufreq_bindings_set_intel_pstate_no_turbo(fd, r->value.u32);
+        break;
+      default:
+        return -1;
+    }
+  }
+  return ret < 0 ? errno : 0;
+}
+
+static int replayable(const cpufreq_bindings_trace_record* r) {
+  return (r->type == CPUFREQ_BINDINGS_TRACE_U32 || r->type == CPUFREQ_BINDINGS_TRACE_STR) && file_name(r->file) != NULL;
+}
+
+static void print_record(uint64_t i, const cpufreq_bindings_trace_record* r, uint64_t sched_ns, uint64_t drift_ns,
+                         uint64_t write_ns, int status) {
+  printf("%"PRIu64",%"PRIu32",%s,", i, r->core, file_name(r->file));
+  if (r->type == CPUFREQ_BINDINGS_TRACE_STR) {
+    printf("%.*s", r->len < CPUFREQ_BINDINGS_TRACE_STR_LEN ? (int) r->len : CPUFREQ_BINDINGS_TRACE_STR_LEN,
+           r->value.str);
+  } else {
+    printf("%"PRIu32, r->value.u32);
+  }
+  printf(",%"PRIu64",%"PRIu64",%"PRIu64",%s\n", sched_ns, drift_ns, write_ns,
+         status < 0 ? "skipped" : status > 0 ? strerror(status) : "ok");
+}
+
+static int compare_u64(const void* a, const void* b) {
+  uint64_t x = *(const uint64_t*) a;
+  uint64_t y = *(const uint64_t*) b;
+  return x < y ? -1 : x > y;
+}
+
+static void print_summary(replay_stats* st, uint64_t recorded_ns, uint64_t replayed_ns) {
+  uint64_t n = st->written + st->failed;
+  double sum = 0;
+  uint64_t i;
+  printf("Writes: %"PRIu64" ok, %"PRIu64" failed, %"PRIu64" skipped\n", st->written, st->failed, st->skipped);
+  printf("Duration: %.3f ms recorded, %.3f ms replayed\n", recorded_ns / 1000000.0, replayed_ns / 1000000.0);
+  if (n == 0) {
+    return;
+  }
+  for (i = 0; i < n; i++) {
+    sum += (double) st->drifts[i];
+  }
+  qsort(st->drifts, n, sizeof(uint64_t), compare_u64);
+  printf("Drift (us): min %.1f, mean %.1f, p50 %.1f, p99 %.1f, max %.1f\n", st->drifts[0] / 1000.0, sum / n / 1000.0,
+         st->drifts[n / 2] / 1000.0, st->drifts[(n * 99) / 100] / 1000.0, st->drifts[n - 1] / 1000.0);
+  printf("Slowest write: %.1f us\n", st->max_write_ns / 1000.0);
+}
+
+static int replay(const cpufreq_bindings_trace_record* records, uint64_t count, double speed, uint64_t spin_ns,
+                  int dry_run, int csv) {
+  const cpufreq_bindings_trace_record* r;
+  cpufreq_bindings_ctx* ctx;
+  replay_stats st;
+  uint64_t start_ns;
+  uint64_t sched_ns;
+  uint64_t issue_ns;
+  uint64_t drift_ns;
+  uint64_t write_ns;
+  uint64_t last_ns = 0;
+  uint64_t i;
+  uint32_t ncores = 1;
+  uint8_t* open_failed;
+  int status;
+  int fd;
+  memset(&st, 0, sizeof(st));
+  for (i = 0; i < count; i++) {
+    if (replayable(&records[i]) && records[i].core >= ncores) {
+      ncores = records[i].core + 1;
+    }
+  }
+  st.drifts = malloc((count > 0 ? count : 1) * sizeof(uint64_t));
+  open_failed = calloc((size_t) ncores * MAX_FILES, 1);
+  if (st.drifts == NULL || open_failed == NULL) {
+    perror("malloc");
+    free(st.drifts);
+    free(open_failed);
+    return -errno;
+  }
+  if ((ctx = cpufreq_bindings_ctx_init(ncores)) == NULL) {
+    perror("cpufreq_bindings_ctx_init");
+    free(st.drifts);
+    free(open_failed);
+    return -errno;
+  }
+  // open every file up front so the timed writes only cost a pwrite, reporting each failure once
+  for (i = 0; i < count && !dry_run; i++) {
+    r = &records[i];
+    if (replayable(r) && !open_failed[(size_t) r->core * MAX_FILES + r->file] &&
+        cpufreq_bindings_ctx_get_fd(ctx, r->core, r->file) < 0) {
+      fprintf(stderr, "Failed to open %s for core %"PRIu32": %s\n", file_name(r->file), r->core, strerror(errno));
+      open_failed[(size_t) r->core * MAX_FILES + r->file] = 1;
+    }
+  }
+  free(open_failed);
+  if (csv) {
+    printf("record,core,file,value,scheduled_ns,drift_ns,write_ns,status\n");
+  }
+  // the default 50 us timer slack would make sleeps overshoot the spin window
+  if (prctl(PR_SET_TIMERSLACK, 1UL, 0UL, 0UL, 0UL)) {
+    perror("prctl: PR_SET_TIMERSLACK");
+  }
+  start_ns = now_ns() + LEAD_NS;
+  for (i = 0; i < count; i++) {
+    r = &records[i];
+    if (!replayable(r)) {
+      st.skipped++;
+      continue;
+    }
+    sched_ns = (uint64_t) (r->timestamp_ns / speed);
+    wait_until(start_ns + sched_ns, spin_ns);
+    issue_ns = now_ns();
+    if (dry_run) {
+      status = 0;
+    } else if ((fd = cpufreq_bindings_ctx_get_fd(ctx, r->core, r->file)) < 0) {
+      status = errno;
+    } else {
+      status = write_record(fd, r);
+    }
+    write_ns = now_ns() - issue_ns;
+    // records from concurrent threads may be slightly out of order, and so issued early
+    drift_ns = issue_ns > start_ns + sched_ns ? issue_ns - (start_ns + sched_ns) : 0;
+    if (status < 0) {
+      st.skipped++;
+    } else {
+      st.drifts[st.written + st.failed] = drift_ns;
+      if (status == 0) {
+        st.written++;
+      } else {
+        st.failed++;
+      }
+      if (write_ns > st.max_write_ns) {
+        st.max_write_ns = write_ns;
+      }
+    }
+    if (csv) {
+      print_record(i, r, sched_ns, drift_ns, write_ns, status);
+    }
+    last_ns = r->timestamp_ns;
+  }
+  if (!csv) {
+    print_summary(&st, last_ns, now_ns() - start_ns);
+  }
+  cpufreq_bindings_ctx_destroy(ctx);
+  free(st.drifts);
+  return st.failed > 0 ? -EIO : 0;
+}
+
+static const char short_options[] = "hs:S:nCr:";
+static const struct option long_options[] = {
+  {"help",                no_argument,        NULL, 'h'},
+  {"speed",               required_argument,  NULL, 's'},
+  {"spin",                required_argument,  NULL, 'S'},
+  {"dry-run",             no_argument,        NULL, 'n'},
+  {"csv",                 no_argument,        NULL, 'C'},
+  {"root",                required_argument,  NULL, 'r'},
+  {0, 0, 0, 0}
+};
+
+static void print_usage(void) {
+  printf("Usage: cpufreq-bindings-replay [OPTION]... FILE\n");
+  printf("Options:\n");
+  printf("  -h, --help                   Print this message and exit\n");
+  printf("  -s, --speed=FACTOR           Playback speed relative to the recording (default is 1)\n");
+  printf("  -S, --spin=US                Busy-wait the last US microseconds before each write (default is 50)\n");
+  printf("  -n, --dry-run                Follow the schedule without writing\n");
+  printf("  -C, --csv                    Print each write in CSV format instead of a summary\n");
+  printf("  -r, --root=DIR               The sysfs root (default is /sys)\n");
+}
+
+int main(int argc, char** argv) {
+  const cpufreq_bindings_trace_record* records;
+  const cpufreq_bindings_trace_header* hdr;
+  cpufreq_bindings_trace_reader* reader;
+  uint64_t count;
+  uint64_t spin_ns = 50000;
+  double speed = 1;
+  int dry_run = 0;
+  int csv = 0;
+  int ret;
+  int c;
+  while ((c = getopt_long(argc, argv, short_options, long_options, NULL)) != -1) {
+    switch (c) {
+      case 'h':
+        print_usage();
+        return 0;
+      case 's':
+        speed = atof(optarg);
+        break;
+      case 'S':
+        spin_ns = strtoull(optarg, NULL, 0) * 1000ULL;
+        break;
+      case 'n':
+        dry_run = 1;
+        break;
+      case 'C':
+        csv = 1;
+        break;
+      case 'r':
+        if (cpufreq_bindings_set_sysfs_root(optarg)) {
+          perror("cpufreq_bindings_set_sysfs_root");
+          return -errno;
+        }
+        break;
+      case '?':
+      default:
+        print_usage();
+        return -EINVAL;
+    }
+  }
+  if (optind != argc - 1 || speed <= 0) {
+    print_usage();
+    return -EINVAL;
+  }
+  if ((reader = cpufreq_bindings_trace_reader_open(argv[optind])) == NULL) {
+    perror(argv[optind]);
+    return -errno;
+  }
+  hdr = cpufreq_bindings_trace_reader_header(reader);
+  records = cpufreq_bindings_trace_reader_records(reader, &count);
+  if (!csv) {
+    printf("Replaying %"PRIu64" records", count);
+    if (hdr->count > count) {
+      printf(" (%"PRIu64" were dropped while recording)", hdr->count - count);
+    }
+    printf("\n");
+    fflush(stdout);
+  }
+  ret = replay(records, count, speed, spin_ns, dry_run, csv);
+  cpufreq_bindings_trace_reader_close(reader);
+  return ret;
+}
@@ -0,0 +1,215 @@
+/**
+ * Measure frequency transition latency between every pair of available frequencies.
+ *
+ * @author Connor Imes
+ * @date 2026-10-15
+ */
+#include <errno.h>
+#include <getopt.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "cpufreq-bindings.h"
+#include "cpufreq-bindings-transition.h"
+
+#define MAX_FREQS 64
+
+static uint32_t parse_freqs(const char* str, uint32_t* freqs, uint32_t len) {
+  char* end;
+  uint32_t n = 0;
+  while (*str != '\0' && n < len) {
+    freqs[n++] = strtoul(str, &end, 0);
+    if (end == str) {
+      return 0;
+    }
+    str = *end == ',' ? end + 1 : end;
+  }
+  return *str == '\0' ? n : 0;
+}
+
+static void print_hist(const cpufreq_bindings_transition_stats* st) {
+  uint32_t i;
+  uint32_t last = 0;
+  for (i = 0; i < CPUFREQ_BINDINGS_TRANSITION_HIST_BUCKETS; i++) {
+    if (st->hist[i] > 0) {
+      last = i;
+    }
+  }
+  for (i = 0; i <= last; i++) {
+    if (i == 0) {
+      printf("    [0, 1) us: %"PRIu32"\n", st->hist[i]);
+    } else {
+      printf("    [%"PRIu32", %"PRIu32") us: %"PRIu32"\n", 1U << (i - 1), 1U << i, st->hist[i]);
+    }
+  }
+}
+
+static void print_stats(const cpufreq_bindings_transition_stats* stats, uint32_t npairs, int csv, int hist) {
+  const cpufreq_bindings_transition_stats* st;
+  uint32_t i;
+  if (csv) {
+    printf("from,to,samples,timeouts,min_ns,mean_ns,p50_ns,p99_ns,max_ns\n");
+  } else {
+    printf("%10s %10s %8s %8s %12s %12s %12s %12s\n", "from", "to", "samples", "timeouts", "min_us", "p50_us",
+           "p99_us", "max_us");
+  }
+  for (i = 0; i < npairs; i++) {
+    st = &stats[i];
+    if (csv) {
+      printf("%"PRIu32",%"PRIu32",%"PRIu32",%"PRIu32",%"PRIu64",%.0f,%"PRIu64",%"PRIu64",%"PRIu64"\n", st->from, st->to,
+             st->samples, st->timeouts, st->min_ns, st->mean_ns, st->p50_ns, st->p99_ns, st->max_ns);
+    } else {
+      printf("%10"PRIu32" %10"PRIu32" %8"PRIu32" %8"PRIu32" %12.1f %12.1f %12.1f %12.1f\n", st->from, st->to,
+             st->samples, st->timeouts, st->min_ns / 1000.0, st->p50_ns / 1000.0, st->p99_ns / 1000.0,
+             st->max_ns / 1000.0);
+      if (hist && st->samples > 0) {
+        print_hist(st);
+      }
+    }
+  }
+}
+
+static const char short_options[] = "hc:m:p:r:t:T:f:HC";
+static const struct option long_options[] = {
+  {"help",                no_argument,        NULL, 'h'},
+  {"cpu",                 required_argument,  NULL, 'c'},
+  {"method",              required_argument,  NULL, 'm'},
+  {"poll",                required_argument,  NULL, 'p'},
+  {"reps",                required_argument,  NULL, 'r'},
+  {"tolerance",           required_argument,  NULL, 't'},
+  {"timeout",             required_argument,  NULL, 'T'},
+  {"freqs",               required_argument,  NULL, 'f'},
+  {"histogram",           no_argument,        NULL, 'H'},
+  {"csv",                 no_argument,        NULL, 'C'},
+  {0, 0, 0, 0}
+};
+
+static void print_usage(void) {
+  printf("Usage: cpufreq-bindings-transition-bench [OPTION]...\n");
+  printf("Options:\n");
+  printf("  -h, --help                   Print this message and exit\n");
+  printf("  -c, --cpu=CPU                The processor core to measure (default is 0)\n");
+  printf("  -m, --method=METHOD          How to set frequencies: setspeed or clamp (default is setspeed)\n");
+  printf("  -p, --poll=FILE              The file to poll: cpuinfo or scaling (default is cpuinfo)\n");
+  printf("  -r, --reps=N                 Measurements per frequency pair (default is 20)\n");
+  printf("  -t, --tolerance=KHZ          Count a reported frequency within KHZ of the target as reached (default is 0)\n");
+  printf("  -T, --timeout=MS             Give up waiting for a frequency after MS milliseconds (default is 100)\n");
+  printf("  -f, --freqs=LIST             Comma-separated frequencies in KHz (default is scaling_available_frequencies)\n");
+  printf("  -H, --histogram              Print latency histograms\n");
+  printf("  -C, --csv                    Print results in CSV format\n");
+}
+
+int main(int argc, char** argv) {
+  cpufreq_bindings_transition_opts opts = {
+    CPUFREQ_BINDINGS_TRANSITION_SETSPEED, CPUFREQ_BINDINGS_FILE_CPUINFO_CUR_FREQ, 0, 100000000ULL
+  };
+  cpufreq_bindings_transition_stats* stats;
+  cpufreq_bindings_ctx* ctx;
+  uint32_t freqs[MAX_FREQS];
+  uint32_t nfreqs = 0;
+  uint32_t npairs;
+  uint32_t core = 0;
+  uint32_t reps = 20;
+  uint32_t latency;
+  int hist = 0;
+  int csv = 0;
+  int ret = 0;
+  int c;
+  while ((c = getopt_long(argc, argv, short_options, long_options, NULL)) != -1) {
+    switch (c) {
+      case 'h':
+        print_usage();
+        return 0;
+      case 'c':
+        core = atoi(optarg);
+        break;
+      case 'm':
+        if (!strcmp(optarg, "setspeed")) {
+          opts.method = CPUFREQ_BINDINGS_TRANSITION_SETSPEED;
+        } else if (!strcmp(optarg, "clamp")) {
+          opts.method = CPUFREQ_BINDINGS_TRANSITION_CLAMP;
+        } else {
+          print_usage();
+          return -EINVAL;
+        }
+        break;
+      case 'p':
+        if (!strcmp(optarg, "cpuinfo")) {
+          opts.poll_file = CPUFREQ_BINDINGS_FILE_CPUINFO_CUR_FREQ;
+        } else if (!strcmp(optarg, "scaling")) {
+          opts.poll_file = CPUFREQ_BINDINGS_FILE_SCALING_CUR_FREQ;
+        } else {
+          print_usage();
+          return -EINVAL;
+        }
+        break;
+      case 'r':
+        reps = strtoul(optarg, NULL, 0);
+        break;
+      case 't':
+        opts.tolerance = strtoul(optarg, NULL, 0);
+        break;
+      case 'T':
+        opts.timeout_ns = strtoull(optarg, NULL, 0) * 1000000ULL;
+        break;
+      case 'f':
+        if ((nfreqs = parse_freqs(optarg, freqs, MAX_FREQS)) == 0) {
+          print_usage();
+          return -EINVAL;
+        }
+        break;
+      case 'H':
+        hist = 1;
+        break;
+      case 'C':
+        csv = 1;
+        break;
+      case '?':
+      default:
+        print_usage();
+        return -EINVAL;
+    }
+  }
+  if (reps == 0) {
+    print_usage();
+    return -EINVAL;
+  }
+  if ((ctx = cpufreq_bindings_ctx_init(core + 1)) == NULL) {
+    perror("cpufreq_bindings_ctx_init");
+    return -errno;
+  }
+  if (nfreqs == 0 &&
+      (nfreqs = cpufreq_bindings_ctx_get_scaling_available_frequencies(ctx, core, freqs, MAX_FREQS)) == 0) {
+    perror("scaling_available_frequencies (use --freqs)");
+    cpufreq_bindings_ctx_destroy(ctx);
+    return -EINVAL;
+  }
+  if (nfreqs < 2) {
+    fprintf(stderr, "At least 2 frequencies are required\n");
+    cpufreq_bindings_ctx_destroy(ctx);
+    return -EINVAL;
+  }
+  npairs = nfreqs * (nfreqs - 1);
+  if ((stats = calloc(npairs, sizeof(cpufreq_bindings_transition_stats))) == NULL) {
+    perror("calloc");
+    cpufreq_bindings_ctx_destroy(ctx);
+    return -ENOMEM;
+  }
+  if (!csv) {
+    latency = cpufreq_bindings_ctx_get_cpuinfo_transition_latency(ctx, core);
+    if (latency == UINT32_MAX) {
+      printf("cpuinfo_transition_latency: unknown\n");
+    } else if (latency > 0) {
+      printf("cpuinfo_transition_latency: %"PRIu32" ns\n", latency);
+    }
+  }
+  if (cpufreq_bindings_ctx_measure_transitions(ctx, core, freqs, nfreqs, reps, &opts, stats, npairs) == 0) {
+    ret = -errno;
+    perror("cpufreq_bindings_ctx_measure_transitions");
+  }
+  print_stats(stats, npairs, csv, hist);
+  free(stats);
+  cpufreq_bindings_ctx_destroy(ctx);
+  return ret;
+}